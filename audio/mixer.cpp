@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/system.h"
 #include "common/textconsole.h"
@@ -31,9 +32,58 @@
 #include "audio/audiostream.h"
 #include "audio/timestamp.h"
 
+#if defined(__SSE2__) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define USE_SSE2_MIXER
+#include <emmintrin.h>
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON)) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define USE_NEON_MIXER
+#include <arm_neon.h>
+#endif
+
 
 namespace Audio {
 
+#pragma mark -
+#pragma mark --- Mix bus ---
+#pragma mark -
+
+/**
+ * Clips the 32 bit mix bus samples to 16 bit output samples.
+ */
+static void clipMixBus(int16 *dst, const st_mix_t *src, uint numSamples) {
+#if defined(USE_SSE2_MIXER)
+	for (; numSamples >= 8; numSamples -= 8) {
+		const __m128i lo = _mm_loadu_si128((const __m128i *)src);
+		const __m128i hi = _mm_loadu_si128((const __m128i *)(src + 4));
+		_mm_storeu_si128((__m128i *)dst, _mm_packs_epi32(lo, hi));
+		src += 8;
+		dst += 8;
+	}
+#elif defined(USE_NEON_MIXER)
+	for (; numSamples >= 8; numSamples -= 8) {
+		const int16x4_t lo = vqmovn_s32(vld1q_s32(src));
+		const int16x4_t hi = vqmovn_s32(vld1q_s32(src + 4));
+		vst1q_s16(dst, vcombine_s16(lo, hi));
+		src += 8;
+		dst += 8;
+	}
+#endif
+
+	for (; numSamples > 0; --numSamples) {
+		st_mix_t val = *src++;
+		if (val > ST_SAMPLE_MAX)
+			val = ST_SAMPLE_MAX;
+		else if (val < ST_SAMPLE_MIN)
+			val = ST_SAMPLE_MIN;
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		*dst++ = ((int16)val) ^ 0x8000;
+#else
+		*dst++ = val;
+#endif
+	}
+}
+
 #pragma mark -
 #pragma mark --- Channel classes ---
 #pragma mark -
@@ -48,15 +98,15 @@ public:
 	~Channel();
 
 	/**
-	 * Mixes the channel's samples into the given buffer.
+	 * Mixes the channel's samples into the given mix bus.
 	 *
-	 * @param data buffer where to mix the data
+	 * @param data mix bus where to mix the data
 	 * @param len  number of sample *pairs*. So a value of
 	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 *             32 bits, for a total of 80 bytes.
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(st_mix_t *data, uint len);
 
 	/**
 	 * Queries whether the channel is still playing or not.
@@ -175,16 +225,19 @@ private:
 
 // TODO: parameter "system" is unused
 MixerImpl::MixerImpl(OSystem *system, uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(),
+	  _commandMutex(), _commandHead(0), _commandCount(0) {
 
 	assert(sampleRate > 0);
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		_channels[i] = 0;
+	_channels.reserve(INITIAL_CHANNELS);
+
+	// Read once here, rather than for every converter a channel creates
+	setResamplerType(ConfMan.get("resampler") == "sinc" ? kResamplerSinc : kResamplerLinear);
 }
 
 MixerImpl::~MixerImpl() {
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (uint i = 0; i < _channels.size(); i++)
 		delete _channels[i];
 }
 
@@ -197,14 +250,14 @@ uint MixerImpl::getOutputRate() const {
 }
 
 void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
-	int index = -1;
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] == 0) {
-			index = i;
-			break;
-		}
-	}
-	if (index == -1) {
+	uint index;
+	if (!_freeSlots.empty()) {
+		index = _freeSlots.back();
+		_freeSlots.pop_back();
+	} else if (_channels.size() < MAX_CHANNELS) {
+		index = _channels.size();
+		_channels.push_back(0);
+	} else {
 		warning("MixerImpl::out of mixer slots");
 		delete chan;
 		return;
@@ -212,15 +265,133 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 
 	_channels[index] = chan;
 
+	// The slot index lives in the low bits of the handle, which makes
+	// looking up a channel by its handle a simple array access.
 	SoundHandle chanHandle;
-	chanHandle._val = index + (_handleSeed * NUM_CHANNELS);
+	chanHandle._val = index | (_handleSeed << CHANNEL_INDEX_BITS);
 
 	chan->setHandle(chanHandle);
-	_handleSeed++;
+	_handleSeed = (_handleSeed + 1) & HANDLE_SEED_MASK;
 	if (handle)
 		*handle = chanHandle;
 }
 
+Channel *MixerImpl::findChannel(SoundHandle handle) const {
+	const uint index = handle._val & (MAX_CHANNELS - 1);
+	if (index >= _channels.size())
+		return 0;
+
+	Channel *chan = _channels[index];
+	if (!chan || chan->getHandle()._val != handle._val)
+		return 0;
+
+	return chan;
+}
+
+void MixerImpl::removeChannel(uint index) {
+	delete _channels[index];
+	_channels[index] = 0;
+	_freeSlots.push_back(index);
+}
+
+void MixerImpl::queueCommand(const Command &cmd) {
+	{
+		Common::StackLock commandLock(_commandMutex);
+		if (_commandCount < COMMAND_QUEUE_SIZE) {
+			_commands[(_commandHead + _commandCount) % COMMAND_QUEUE_SIZE] = cmd;
+			_commandCount++;
+			return;
+		}
+	}
+
+	// The audio thread is not keeping up (or not running at all), so fall
+	// back to executing the commands ourselves, in order.
+	Common::StackLock lock(_mutex);
+	processCommands();
+	executeCommand(cmd);
+}
+
+void MixerImpl::processCommands() {
+	Command pending[COMMAND_QUEUE_SIZE];
+	uint count;
+
+	{
+		Common::StackLock commandLock(_commandMutex);
+		count = _commandCount;
+		for (uint i = 0; i < count; ++i)
+			pending[i] = _commands[(_commandHead + i) % COMMAND_QUEUE_SIZE];
+		_commandHead = (_commandHead + count) % COMMAND_QUEUE_SIZE;
+		_commandCount = 0;
+	}
+
+	for (uint i = 0; i < count; ++i)
+		executeCommand(pending[i]);
+}
+
+void MixerImpl::executeCommand(const Command &cmd) {
+	switch (cmd.type) {
+	case Command::kUpdateSoundType:
+		for (uint i = 0; i < _channels.size(); ++i) {
+			if (_channels[i] && _channels[i]->getType() == cmd.param)
+				_channels[i]->notifyGlobalVolChange();
+		}
+		return;
+
+	case Command::kPauseAll:
+		for (uint i = 0; i < _channels.size(); i++) {
+			if (_channels[i] != 0) {
+				_channels[i]->pause(cmd.value != 0);
+			}
+		}
+		return;
+
+	case Command::kPauseID:
+		for (uint i = 0; i < _channels.size(); i++) {
+			if (_channels[i] != 0 && _channels[i]->getId() == cmd.param) {
+				_channels[i]->pause(cmd.value != 0);
+				return;
+			}
+		}
+		return;
+
+	default:
+		break;
+	}
+
+	// Simply ignore requests for handles of sounds that already terminated
+	Channel *chan = findChannel(cmd.handle);
+	if (!chan)
+		return;
+
+	switch (cmd.type) {
+	case Command::kSetVolume:
+		chan->setVolume(cmd.value);
+		break;
+	case Command::kSetBalance:
+		chan->setBalance(cmd.value);
+		break;
+	case Command::kPauseHandle:
+		chan->pause(cmd.value != 0);
+		break;
+	default:
+		break;
+	}
+}
+
+bool MixerImpl::findPendingCommand(Command::Type type, SoundHandle handle, int &value) {
+	Common::StackLock commandLock(_commandMutex);
+
+	for (uint i = _commandCount; i > 0; --i) {
+		const Command &cmd = _commands[(_commandHead + i - 1) % COMMAND_QUEUE_SIZE];
+		if (cmd.type == type && cmd.handle._val == handle._val) {
+			value = cmd.value;
+			return true;
+		}
+	}
+
+	return false;
+}
+
 void MixerImpl::playStream(
 			SoundType type,
 			SoundHandle *handle,
@@ -230,6 +401,7 @@ void MixerImpl::playStream(
 			bool permanent,
 			bool reverseStereo) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	if (stream == 0) {
 		warning("stream is 0");
@@ -241,7 +413,7 @@ void MixerImpl::playStream(
 
 	// Prevent duplicate sounds
 	if (id != -1) {
-		for (int i = 0; i != NUM_CHANNELS; i++)
+		for (uint i = 0; i < _channels.size(); i++)
 			if (_channels[i] != 0 && _channels[i]->getId() == id) {
 				// Delete the stream if were asked to auto-dispose it.
 				// Note: This could cause trouble if the client code does not
@@ -271,6 +443,9 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 
 	Common::StackLock lock(_mutex);
 
+	// Apply everything the engine threads requested since the last mix
+	processCommands();
+
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
 	assert(len % 4 == 0);
@@ -279,67 +454,77 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	// Since the mixer callback has been called, the mixer must be ready...
 	_mixerReady = true;
 
-	//  zero the buf
-	memset(buf, 0, 2 * len * sizeof(int16));
+	// All channels are accumulated in a 32 bit mix bus, which is only
+	// clipped once when writing the final output.
+	if (_mixBuffer.size() < 2 * len)
+		_mixBuffer.resize(2 * len);
+	st_mix_t *bus = _mixBuffer.begin();
+	memset(bus, 0, 2 * len * sizeof(st_mix_t));
 
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (uint i = 0; i < _channels.size(); i++)
 		if (_channels[i]) {
 			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
+				removeChannel(i);
 			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
+				tmp = _channels[i]->mix(bus, len);
 
 				if (tmp > res)
 					res = tmp;
 			}
 		}
 
+	clipMixBus(buf, bus, 2 * len);
+
 	return res;
 }
 
 void MixerImpl::stopAll() {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
+	processCommands();
+	for (uint i = 0; i < _channels.size(); i++) {
 		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+			removeChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopID(int id) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
+	processCommands();
+	for (uint i = 0; i < _channels.size(); i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+			removeChannel(i);
 		}
 	}
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	const Channel *chan = findChannel(handle);
+	if (!chan)
 		return;
 
-	delete _channels[index];
-	_channels[index] = 0;
+	removeChannel(handle._val & (MAX_CHANNELS - 1));
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	// The audio thread reads the settings while mixing
+	Common::StackLock lock(_mutex);
+	processCommands();
 	_soundTypeSettings[type].mute = mute;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Command cmd;
+	cmd.type = Command::kUpdateSoundType;
+	cmd.param = type;
+	cmd.value = 0;
+	executeCommand(cmd);
 }
 
 bool MixerImpl::isSoundTypeMuted(SoundType type) const {
@@ -348,39 +533,47 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 }
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setVolume(volume);
+	Command cmd;
+	cmd.type = Command::kSetVolume;
+	cmd.handle = handle;
+	cmd.param = 0;
+	cmd.value = volume;
+	queueCommand(cmd);
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	int pendingVolume;
+	if (findPendingCommand(Command::kSetVolume, handle, pendingVolume))
+		return pendingVolume;
+
+	Common::StackLock lock(_mutex);
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return 0;
 
-	return _channels[index]->getVolume();
+	return chan->getVolume();
 }
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
-	Common::StackLock lock(_mutex);
-
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->setBalance(balance);
+	Command cmd;
+	cmd.type = Command::kSetBalance;
+	cmd.handle = handle;
+	cmd.param = 0;
+	cmd.value = balance;
+	queueCommand(cmd);
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	int pendingBalance;
+	if (findPendingCommand(Command::kSetBalance, handle, pendingBalance))
+		return pendingBalance;
+
+	Common::StackLock lock(_mutex);
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return 0;
 
-	return _channels[index]->getBalance();
+	return chan->getBalance();
 }
 
 uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
@@ -389,52 +582,51 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+	Channel *chan = findChannel(handle);
+	if (!chan)
 		return Timestamp(0, _sampleRate);
 
-	return _channels[index]->getElapsedTime();
+	return chan->getElapsedTime();
 }
 
 void MixerImpl::pauseAll(bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0) {
-			_channels[i]->pause(paused);
-		}
-	}
+	Command cmd;
+	cmd.type = Command::kPauseAll;
+	cmd.param = 0;
+	cmd.value = paused;
+	queueCommand(cmd);
 }
 
 void MixerImpl::pauseID(int id, bool paused) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			_channels[i]->pause(paused);
-			return;
-		}
-	}
+	Command cmd;
+	cmd.type = Command::kPauseID;
+	cmd.param = id;
+	cmd.value = paused;
+	queueCommand(cmd);
 }
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
-	Common::StackLock lock(_mutex);
-
-	// Simply ignore (un)pause requests for sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
-
-	_channels[index]->pause(paused);
+	// Requests for sounds that already terminated are ignored when the
+	// command gets executed
+	Command cmd;
+	cmd.type = Command::kPauseHandle;
+	cmd.handle = handle;
+	cmd.param = 0;
+	cmd.value = paused;
+	queueCommand(cmd);
 }
 
 bool MixerImpl::isSoundIDActive(int id) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	for (uint i = 0; i < _channels.size(); i++)
 		if (_channels[i] && _channels[i]->getId() == id)
 			return true;
 	return false;
@@ -442,26 +634,28 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
-	const int index = handle._val % NUM_CHANNELS;
-	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
-		return _channels[index]->getId();
+	processCommands();
+	const Channel *chan = findChannel(handle);
+	if (chan)
+		return chan->getId();
 	return 0;
 }
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	processCommands();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
 #endif
 
-	const int index = handle._val % NUM_CHANNELS;
-	return _channels[index] && _channels[index]->getHandle()._val == handle._val;
+	return findChannel(handle) != 0;
 }
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++)
+	processCommands();
+	for (uint i = 0; i < _channels.size(); i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
 	return false;
@@ -479,13 +673,16 @@ void MixerImpl::setVolumeForSoundType(SoundType type, int volume) {
 	// TODO: Maybe we should do logarithmic (not linear) volume
 	// scaling? See also Player_V2::setMasterVolume
 
+	// The audio thread reads the settings while mixing
 	Common::StackLock lock(_mutex);
+	processCommands();
 	_soundTypeSettings[type].volume = volume;
 
-	for (int i = 0; i != NUM_CHANNELS; ++i) {
-		if (_channels[i] && _channels[i]->getType() == type)
-			_channels[i]->notifyGlobalVolChange();
-	}
+	Command cmd;
+	cmd.type = Command::kUpdateSoundType;
+	cmd.param = type;
+	cmd.value = 0;
+	executeCommand(cmd);
 }
 
 int MixerImpl::getVolumeForSoundType(SoundType type) const {
@@ -607,7 +804,7 @@ Timestamp Channel::getElapsedTime() {
 	return ts;
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(st_mix_t *data, uint len) {
 	assert(_stream);
 
 	int res = 0;
@@ -618,7 +815,7 @@ int Channel::mix(int16 *data, uint len) {
 		_samplesConsumed = _samplesDecoded;
 		_mixerTimeStamp = g_system->getMillis(true);
 		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		res = _converter->flowAccumulate(*_stream, data, len, _volL, _volR);
 		_samplesDecoded += res;
 	}
 
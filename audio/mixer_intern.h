@@ -24,8 +24,10 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -51,11 +53,55 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 16
+		INITIAL_CHANNELS = 16,
+
+		/**
+		 * Number of low bits of a sound handle holding the channel slot.
+		 * This also limits the number of simultaneously playing channels.
+		 */
+		CHANNEL_INDEX_BITS = 10,
+		MAX_CHANNELS = 1 << CHANNEL_INDEX_BITS,
+		HANDLE_SEED_MASK = (1 << (32 - CHANNEL_INDEX_BITS)) - 1,
+
+		COMMAND_QUEUE_SIZE = 64
+	};
+
+	/**
+	 * A deferred channel control request.
+	 *
+	 * Requests which can neither create nor destroy a channel are not
+	 * executed by the calling thread. Instead they are put into a command
+	 * queue, which the audio thread drains at the start of every mix. This
+	 * way engine threads never have to wait for a mix in progress just to
+	 * change a volume or pause a sound.
+	 */
+	struct Command {
+		enum Type {
+			kSetVolume,
+			kSetBalance,
+			kPauseHandle,
+			kPauseID,
+			kPauseAll,
+			kUpdateSoundType
+		};
+
+		Type type;
+		SoundHandle handle;
+		int param;
+		int value;
 	};
 
 	Common::Mutex _mutex;
 
+	/**
+	 * Protects the command queue. It is only ever held for the time it
+	 * takes to add a command or to copy out the pending ones.
+	 */
+	Common::Mutex _commandMutex;
+	Command _commands[COMMAND_QUEUE_SIZE];
+	uint _commandHead;
+	uint _commandCount;
+
 	const uint _sampleRate;
 	bool _mixerReady;
 	uint32 _handleSeed;
@@ -68,7 +114,16 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
-	Channel *_channels[NUM_CHANNELS];
+
+	/**
+	 * The channel table. It grows on demand up to MAX_CHANNELS slots, free
+	 * slots are NULL and their indices are kept in _freeSlots for reuse.
+	 */
+	Common::Array<Channel *> _channels;
+	Common::Array<uint> _freeSlots;
+
+	/** The 32 bit mix bus all channels are accumulated in. */
+	Common::Array<st_mix_t> _mixBuffer;
 
 
 public:
@@ -121,6 +176,43 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/**
+	 * Look up the channel belonging to a handle.
+	 *
+	 * @return the channel, or 0 if the sound has already terminated
+	 */
+	Channel *findChannel(SoundHandle handle) const;
+
+	/**
+	 * Delete the channel in the given slot and mark the slot as free.
+	 */
+	void removeChannel(uint index);
+
+	/**
+	 * Queue a command for the audio thread. If the queue is full, all
+	 * pending commands and the new one are executed right away instead.
+	 */
+	void queueCommand(const Command &cmd);
+
+	/**
+	 * Execute all queued commands. Must be called with _mutex held.
+	 */
+	void processCommands();
+
+	/**
+	 * Execute a single command. Must be called with _mutex held.
+	 */
+	void executeCommand(const Command &cmd);
+
+	/**
+	 * Look up the most recent queued command of the given type for the
+	 * given handle, so that getters can report values which have been set
+	 * but not yet applied by the audio thread.
+	 *
+	 * @return true if a pending command was found, its value is stored in value
+	 */
+	bool findPendingCommand(Command::Type type, SoundHandle handle, int &value);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
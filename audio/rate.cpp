@@ -31,10 +31,36 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "common/array.h"
 #include "common/frac.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
+#include <math.h>
+
+#if defined(__SSE2__) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define USE_SSE2_MIXER
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define USE_AVX2_MIXER
+#include <immintrin.h>
+#endif
+#elif (defined(__ARM_NEON__) || defined(__ARM_NEON)) && !defined(OUTPUT_UNSIGNED_AUDIO)
+#define USE_NEON_MIXER
+#include <arm_neon.h>
+#endif
+
+namespace Audio {
+class SincFilterCache;
+}
+
+namespace Common {
+DECLARE_SINGLETON(Audio::SincFilterCache);
+}
+
 namespace Audio {
 
 
@@ -57,14 +83,301 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+#pragma mark -
+#pragma mark --- Mixing kernels ---
+#pragma mark -
+
+/**
+ * Scales the interleaved stereo sample pairs in src by the given volumes and
+ * adds them to dst with saturation, swapping the channels if requested.
+ * This is the reference implementation all vectorised kernels must match.
+ */
+static void mixSamplesScalar(st_sample_t *dst, const st_sample_t *src, st_size_t numPairs, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int left = reverseStereo ? 1 : 0;
+
+	for (; numPairs > 0; --numPairs) {
+		clampedAdd(dst[left    ], (src[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+		clampedAdd(dst[left ^ 1], (src[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		src += 2;
+		dst += 2;
+	}
+}
+
+#if defined(USE_SSE2_MIXER)
+
+/**
+ * SSE2 version of mixSamplesScalar, processing four sample pairs at a time.
+ * The products are formed in 32 bits and divided by kMaxMixerVolume with
+ * truncation towards zero, so the result is identical to the scalar code.
+ */
+static inline void scaleSamplesSSE2(const st_sample_t *src, __m128i vol, bool reverseStereo, __m128i &p0, __m128i &p1) {
+	__m128i in = _mm_loadu_si128((const __m128i *)src);
+	if (reverseStereo) {
+		in = _mm_shufflelo_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+		in = _mm_shufflehi_epi16(in, _MM_SHUFFLE(2, 3, 0, 1));
+	}
+
+	const __m128i lo = _mm_mullo_epi16(in, vol);
+	const __m128i hi = _mm_mulhi_epi16(in, vol);
+	p0 = _mm_unpacklo_epi16(lo, hi);
+	p1 = _mm_unpackhi_epi16(lo, hi);
+
+	// Round towards zero like the integer division in the scalar code
+	p0 = _mm_add_epi32(p0, _mm_srli_epi32(_mm_srai_epi32(p0, 31), 24));
+	p1 = _mm_add_epi32(p1, _mm_srli_epi32(_mm_srai_epi32(p1, 31), 24));
+	p0 = _mm_srai_epi32(p0, 8);
+	p1 = _mm_srai_epi32(p1, 8);
+}
+
+static st_size_t mixSamplesSSE2(st_sample_t *dst, const st_sample_t *src, st_size_t numPairs, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int16 volA = reverseStereo ? vol_r : vol_l;
+	const int16 volB = reverseStereo ? vol_l : vol_r;
+	const __m128i vol = _mm_set_epi16(volB, volA, volB, volA, volB, volA, volB, volA);
+	st_size_t done = 0;
+
+	for (; done + 4 <= numPairs; done += 4) {
+		__m128i p0, p1;
+		scaleSamplesSSE2(src, vol, reverseStereo, p0, p1);
+
+		// Add in 32 bits and saturate the sum, since with volumes above
+		// kMaxMixerVolume the scaled samples alone may not fit in 16 bits
+		const __m128i in = _mm_loadu_si128((const __m128i *)dst);
+		const __m128i d0 = _mm_srai_epi32(_mm_unpacklo_epi16(in, in), 16);
+		const __m128i d1 = _mm_srai_epi32(_mm_unpackhi_epi16(in, in), 16);
+		const __m128i out = _mm_packs_epi32(_mm_add_epi32(d0, p0), _mm_add_epi32(d1, p1));
+		_mm_storeu_si128((__m128i *)dst, out);
+
+		src += 8;
+		dst += 8;
+	}
+
+	return done;
+}
+
+static st_size_t accumulateSamplesSSE2(st_mix_t *dst, const st_sample_t *src, st_size_t numPairs, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int16 volA = reverseStereo ? vol_r : vol_l;
+	const int16 volB = reverseStereo ? vol_l : vol_r;
+	const __m128i vol = _mm_set_epi16(volB, volA, volB, volA, volB, volA, volB, volA);
+	st_size_t done = 0;
+
+	for (; done + 4 <= numPairs; done += 4) {
+		__m128i p0, p1;
+		scaleSamplesSSE2(src, vol, reverseStereo, p0, p1);
+
+		_mm_storeu_si128((__m128i *)dst, _mm_add_epi32(_mm_loadu_si128((const __m128i *)dst), p0));
+		_mm_storeu_si128((__m128i *)(dst + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(dst + 4)), p1));
+
+		src += 8;
+		dst += 8;
+	}
+
+	return done;
+}
+
+#elif defined(USE_NEON_MIXER)
+
+/**
+ * NEON version of mixSamplesScalar, processing four sample pairs at a time.
+ */
+static inline void scaleSamplesNeon(const st_sample_t *src, int16x4_t vol, bool reverseStereo, int32x4_t &p0, int32x4_t &p1) {
+	int16x8_t in = vld1q_s16(src);
+	if (reverseStereo)
+		in = vrev32q_s16(in);
+
+	p0 = vmull_s16(vget_low_s16(in), vol);
+	p1 = vmull_s16(vget_high_s16(in), vol);
+
+	// Round towards zero like the integer division in the scalar code
+	p0 = vaddq_s32(p0, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p0, 31)), 24)));
+	p1 = vaddq_s32(p1, vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p1, 31)), 24)));
+	p0 = vshrq_n_s32(p0, 8);
+	p1 = vshrq_n_s32(p1, 8);
+}
+
+static st_size_t mixSamplesNeon(st_sample_t *dst, const st_sample_t *src, st_size_t numPairs, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int16 volA = reverseStereo ? vol_r : vol_l;
+	const int16 volB = reverseStereo ? vol_l : vol_r;
+	const int16 volBuf[4] = { volA, volB, volA, volB };
+	const int16x4_t vol = vld1_s16(volBuf);
+	st_size_t done = 0;
+
+	for (; done + 4 <= numPairs; done += 4) {
+		int32x4_t p0, p1;
+		scaleSamplesNeon(src, vol, reverseStereo, p0, p1);
+
+		// Add in 32 bits and saturate the sum, since with volumes above
+		// kMaxMixerVolume the scaled samples alone may not fit in 16 bits
+		const int16x8_t in = vld1q_s16(dst);
+		p0 = vaddw_s16(p0, vget_low_s16(in));
+		p1 = vaddw_s16(p1, vget_high_s16(in));
+		vst1q_s16(dst, vcombine_s16(vqmovn_s32(p0), vqmovn_s32(p1)));
+
+		src += 8;
+		dst += 8;
+	}
+
+	return done;
+}
+
+static st_size_t accumulateSamplesNeon(st_mix_t *dst, const st_sample_t *src, st_size_t numPairs, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+	const int16 volA = reverseStereo ? vol_r : vol_l;
+	const int16 volB = reverseStereo ? vol_l : vol_r;
+	const int16 volBuf[4] = { volA, volB, volA, volB };
+	const int16x4_t vol = vld1_s16(volBuf);
+	st_size_t done = 0;
+
+	for (; done + 4 <= numPairs; done += 4) {
+		int32x4_t p0, p1;
+		scaleSamplesNeon(src, vol, reverseStereo, p0, p1);
+
+		vst1q_s32(dst, vaddq_s32(vld1q_s32(dst), p0));
+		vst1q_s32(dst + 4, vaddq_s32(vld1q_s32(dst + 4), p1));
+
+		src += 8;
+		dst += 8;
+	}
+
+	return done;
+}
+
+#endif
+
+/**
+ * Scales and mixes numPairs stereo sample pairs from src into dst, using
+ * the fastest kernel available on this platform.
+ */
+static void mixSamples(st_sample_t *dst, const st_sample_t *src, st_size_t numPairs, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+#if defined(USE_SSE2_MIXER) || defined(USE_NEON_MIXER)
+	// The vector kernels multiply in 16 bits, larger volumes have to take
+	// the slow path.
+	if (vol_l <= 0x7FFF && vol_r <= 0x7FFF) {
+#if defined(USE_SSE2_MIXER)
+		const st_size_t done = mixSamplesSSE2(dst, src, numPairs, vol_l, vol_r, reverseStereo);
+#else
+		const st_size_t done = mixSamplesNeon(dst, src, numPairs, vol_l, vol_r, reverseStereo);
+#endif
+		dst += done * 2;
+		src += done * 2;
+		numPairs -= done;
+	}
+#endif
+
+	mixSamplesScalar(dst, src, numPairs, vol_l, vol_r, reverseStereo);
+}
+
+/**
+ * Scales numPairs stereo sample pairs from src and adds them to the mix bus
+ * in dst. Unlike mixSamples no clipping takes place.
+ */
+static void accumulateSamples(st_mix_t *dst, const st_sample_t *src, st_size_t numPairs, st_volume_t vol_l, st_volume_t vol_r, bool reverseStereo) {
+#if defined(USE_SSE2_MIXER) || defined(USE_NEON_MIXER)
+	if (vol_l <= 0x7FFF && vol_r <= 0x7FFF) {
+#if defined(USE_SSE2_MIXER)
+		const st_size_t done = accumulateSamplesSSE2(dst, src, numPairs, vol_l, vol_r, reverseStereo);
+#else
+		const st_size_t done = accumulateSamplesNeon(dst, src, numPairs, vol_l, vol_r, reverseStereo);
+#endif
+		dst += done * 2;
+		src += done * 2;
+		numPairs -= done;
+	}
+#endif
+
+	const int left = reverseStereo ? 1 : 0;
+	for (; numPairs > 0; --numPairs) {
+		dst[left    ] += (src[0] * (int)vol_l) / Audio::Mixer::kMaxMixerVolume;
+		dst[left ^ 1] += (src[1] * (int)vol_r) / Audio::Mixer::kMaxMixerVolume;
+		src += 2;
+		dst += 2;
+	}
+}
+
+#pragma mark -
+#pragma mark --- Rate converters ---
+#pragma mark -
+
+/**
+ * Common base of the generic rate converters.
+ *
+ * Subclasses only implement the actual resampling in convert(), producing
+ * unscaled stereo sample pairs in input channel order. Applying the volume,
+ * reversing the channels and mixing into the output buffer is done here in
+ * chunks, which allows the use of vectorised mixing kernels.
+ */
+class ChunkedRateConverter : public RateConverter {
+protected:
+	const bool _reverseStereo;
+
+	/**
+	 * Resamples up to osamp sample pairs from input into obuf.
+	 *
+	 * @return Number of sample pairs written into the buffer. A value lower
+	 *         than osamp indicates the input stream ran out of data.
+	 */
+	virtual int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) = 0;
+
+public:
+	ChunkedRateConverter(bool reverseStereo) : _reverseStereo(reverseStereo) {}
+
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+};
+
+int ChunkedRateConverter::flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t chunk[ST_MIX_CHUNK_SIZE * 2];
+	int total = 0;
+
+	while (osamp > 0) {
+		const st_size_t wanted = MIN<st_size_t>(osamp, ST_MIX_CHUNK_SIZE);
+		const int produced = convert(input, chunk, wanted);
+		if (produced <= 0)
+			break;
+
+		accumulateSamples(obuf, chunk, produced, vol_l, vol_r, _reverseStereo);
+		obuf += produced * 2;
+		osamp -= produced;
+		total += produced;
+
+		if ((st_size_t)produced < wanted)
+			break;
+	}
+
+	return total;
+}
+
+int ChunkedRateConverter::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t chunk[ST_MIX_CHUNK_SIZE * 2];
+	int total = 0;
+
+	while (osamp > 0) {
+		const st_size_t wanted = MIN<st_size_t>(osamp, ST_MIX_CHUNK_SIZE);
+		const int produced = convert(input, chunk, wanted);
+		if (produced <= 0)
+			break;
+
+		mixSamples(obuf, chunk, produced, vol_l, vol_r, _reverseStereo);
+		obuf += produced * 2;
+		osamp -= produced;
+		total += produced;
+
+		if ((st_size_t)produced < wanted)
+			break;
+	}
+
+	return total;
+}
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
  *
  * Limited to sampling frequency <= 65535 Hz.
  */
-template<bool stereo, bool reverseStereo>
-class SimpleRateConverter : public RateConverter {
+template<bool stereo>
+class SimpleRateConverter : public ChunkedRateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -77,20 +390,19 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
+
 public:
-	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
+	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate, bool reverseStereo);
 };
 
 
 /*
  * Prepare processing.
  */
-template<bool stereo, bool reverseStereo>
-SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate) {
+template<bool stereo>
+SimpleRateConverter<stereo>::SimpleRateConverter(st_rate_t inrate, st_rate_t outrate, bool reverseStereo)
+	: ChunkedRateConverter(reverseStereo) {
 	if ((inrate % outrate) != 0) {
 		error("Input rate must be a multiple of output rate to use rate effect");
 	}
@@ -111,8 +423,8 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
  * Processed signed long samples from ibuf to obuf.
  * Return number of sample pairs processed.
  */
-template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+template<bool stereo>
+int SimpleRateConverter<stereo>::convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -143,12 +455,8 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
+		obuf[0] = out0;
+		obuf[1] = out1;
 		obuf += 2;
 	}
 	return (obuf - ostart) / 2;
@@ -165,8 +473,8 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
  * Limited to sampling frequency <= 65535 Hz.
  */
 
-template<bool stereo, bool reverseStereo>
-class LinearRateConverter : public RateConverter {
+template<bool stereo>
+class LinearRateConverter : public ChunkedRateConverter {
 protected:
 	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
 	const st_sample_t *inPtr;
@@ -183,20 +491,19 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
+
 public:
-	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
-	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
-	}
+	LinearRateConverter(st_rate_t inrate, st_rate_t outrate, bool reverseStereo);
 };
 
 
 /*
  * Prepare processing.
  */
-template<bool stereo, bool reverseStereo>
-LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate) {
+template<bool stereo>
+LinearRateConverter<stereo>::LinearRateConverter(st_rate_t inrate, st_rate_t outrate, bool reverseStereo)
+	: ChunkedRateConverter(reverseStereo) {
 	if (inrate >= 131072 || outrate >= 131072) {
 		error("rate effect can only handle rates < 131072");
 	}
@@ -220,8 +527,8 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
  * Processed signed long samples from ibuf to obuf.
  * Return number of sample pairs processed.
  */
-template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+template<bool stereo>
+int LinearRateConverter<stereo>::convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -258,12 +565,8 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
 						  out0);
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
+			obuf[0] = out0;
+			obuf[1] = out1;
 			obuf += 2;
 
 			// Increment output position
@@ -278,78 +581,377 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 
 
 /**
- * Simple audio rate converter for the case that the inrate equals the outrate.
+ * Number of filter phases of the polyphase resampler. The fractional input
+ * position is rounded to the nearest phase.
+ */
+enum {
+	SINC_PHASE_BITS = 8,
+	SINC_PHASES = (1 << SINC_PHASE_BITS),
+	SINC_MAX_TAPS = 64,
+	SINC_COEFF_BITS = 14
+};
+
+/**
+ * Coefficient table of a windowed-sinc low pass filter in polyphase
+ * layout, with taps coefficients for each of the SINC_PHASES + 1 phases.
  */
-template<bool stereo, bool reverseStereo>
-class CopyRateConverter : public RateConverter {
-	st_sample_t *_buffer;
-	st_size_t _bufferSize;
+struct SincFilter {
+	st_rate_t inrate, outrate;
+	int taps;
+	int16 *coeffs;
+
+	SincFilter(st_rate_t in, st_rate_t out);
+	~SincFilter() { delete[] coeffs; }
+
+	const int16 *getPhase(int phase) const { return coeffs + phase * taps; }
+};
+
+/** Zeroth order modified Bessel function of the first kind. */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+SincFilter::SincFilter(st_rate_t in, st_rate_t out) : inrate(in), outrate(out) {
+	// When downsampling the cutoff has to be lowered to the output Nyquist
+	// frequency, which needs proportionally more taps for the same quality.
+	const double ratio = MIN<double>(1.0, (double)out / in);
+	const double cutoff = 0.92 * ratio;
+	const double beta = 7.0;
+	const int zeroCrossings = 7;
+
+	taps = (int)(2 * zeroCrossings / cutoff);
+	taps = MIN<int>((taps + 15) & ~15, SINC_MAX_TAPS);
+	coeffs = new int16[(SINC_PHASES + 1) * taps];
+
+	const int half = taps / 2;
+	const double windowScale = 1.0 / besselI0(beta);
+	double window[SINC_MAX_TAPS];
+
+	for (int phase = 0; phase <= SINC_PHASES; ++phase) {
+		const double frac = (double)phase / SINC_PHASES;
+		double sum = 0;
+
+		// Tap k is applied to the input sample at offset k - (half - 1)
+		// from the current position.
+		for (int k = 0; k < taps; ++k) {
+			const double t = (k - (half - 1)) - frac;
+			const double x = t / half;
+			double h = cutoff;
+			if (t != 0)
+				h = sin(M_PI * cutoff * t) / (M_PI * t);
+			const double w = (x * x < 1.0) ? besselI0(beta * sqrt(1.0 - x * x)) * windowScale : 0.0;
+			window[k] = h * w;
+			sum += window[k];
+		}
+
+		// Normalise for unity gain and put the rounding error into the
+		// largest tap, so a constant signal passes unchanged.
+		int16 *dst = coeffs + phase * taps;
+		int total = 0, center = 0;
+		for (int k = 0; k < taps; ++k) {
+			dst[k] = (int16)floor(window[k] / sum * (1 << SINC_COEFF_BITS) + 0.5);
+			total += dst[k];
+			if (dst[k] > dst[center])
+				center = k;
+		}
+		dst[center] += (1 << SINC_COEFF_BITS) - total;
+	}
+}
+
+/**
+ * Process wide cache of the filter tables, so channels using the same
+ * rates share one table. Tables are never released while the process runs,
+ * as converters are created and deleted from both engine and audio threads
+ * and there is no thread safe reference counting to track their users.
+ */
+class SincFilterCache : public Common::Singleton<SincFilterCache> {
 public:
-	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
-	~CopyRateConverter() {
-		free(_buffer);
+	const SincFilter *getFilter(st_rate_t inrate, st_rate_t outrate) {
+		if (_mutex)
+			_mutex->lock();
+
+		SincFilter *filter = 0;
+		for (uint i = 0; i < _filters.size() && !filter; ++i) {
+			if (_filters[i]->inrate == inrate && _filters[i]->outrate == outrate)
+				filter = _filters[i];
+		}
+
+		if (!filter) {
+			filter = new SincFilter(inrate, outrate);
+			_filters.push_back(filter);
+		}
+
+		if (_mutex)
+			_mutex->unlock();
+		return filter;
 	}
 
-	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
-		assert(input.isStereo() == stereo);
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	// Without a backend, as in the unit tests, there are no threads to
+	// guard against, and no way to create a mutex either
+	SincFilterCache() : _mutex(g_system ? new Common::Mutex() : 0) {}
+	~SincFilterCache() {
+		for (uint i = 0; i < _filters.size(); ++i)
+			delete _filters[i];
+		delete _mutex;
+	}
+
+	Common::Mutex *_mutex;
+	Common::Array<SincFilter *> _filters;
+};
+
+/**
+ * Computes the filter output for one channel. taps is always a multiple
+ * of 16, so the vector versions need no tail handling.
+ */
+static inline int32 sincDotProduct(const int16 *samples, const int16 *coeffs, int taps) {
+#if defined(USE_AVX2_MIXER)
+	__m256i acc = _mm256_setzero_si256();
+	for (int i = 0; i < taps; i += 16)
+		acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *)(samples + i)), _mm256_loadu_si256((const __m256i *)(coeffs + i))));
+	__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+#elif defined(USE_SSE2_MIXER)
+	__m128i acc = _mm_setzero_si128();
+	for (int i = 0; i < taps; i += 8)
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(samples + i)), _mm_loadu_si128((const __m128i *)(coeffs + i))));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+	acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(acc);
+#elif defined(USE_NEON_MIXER)
+	int32x4_t acc = vdupq_n_s32(0);
+	for (int i = 0; i < taps; i += 8) {
+		const int16x8_t s = vld1q_s16(samples + i);
+		const int16x8_t c = vld1q_s16(coeffs + i);
+		acc = vmlal_s16(acc, vget_low_s16(s), vget_low_s16(c));
+		acc = vmlal_s16(acc, vget_high_s16(s), vget_high_s16(c));
+	}
+	int32x2_t sum = vadd_s32(vget_low_s32(acc), vget_high_s32(acc));
+	sum = vpadd_s32(sum, sum);
+	return vget_lane_s32(sum, 0);
+#else
+	int32 acc = 0;
+	for (int i = 0; i < taps; ++i)
+		acc += samples[i] * coeffs[i];
+	return acc;
+#endif
+}
+
+static inline st_sample_t sincOutput(int32 acc) {
+	acc = (acc + (1 << (SINC_COEFF_BITS - 1))) >> SINC_COEFF_BITS;
+	if (acc > ST_SAMPLE_MAX)
+		return ST_SAMPLE_MAX;
+	else if (acc < ST_SAMPLE_MIN)
+		return ST_SAMPLE_MIN;
+	return acc;
+}
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc filter. This
+ * is considerably better than linear interpolation at avoiding aliasing,
+ * at a similar cost thanks to the vectorised filter loops.
+ *
+ * Limited to sampling frequency <= 131071 Hz.
+ */
+template<bool stereo>
+class SincRateConverter : public ChunkedRateConverter {
+protected:
+	enum {
+		HISTORY_SIZE = INTERMEDIATE_BUFFER_SIZE + SINC_MAX_TAPS
+	};
+
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** deinterleaved input history (left/right channel) */
+	int16 hist0[HISTORY_SIZE], hist1[HISTORY_SIZE];
+	int histLen;
+
+	/** index of the current input sample in the history */
+	int ipos;
 
-		st_sample_t *ptr;
-		st_size_t len;
+	/**
+	 * fractional position between the current and the next input sample,
+	 * in units of 1 / outrate, so the position never drifts
+	 */
+	st_rate_t opos;
 
-		st_sample_t *ostart = obuf;
+	/** position increment in the output stream, in whole input samples and the remainder */
+	int ipos_inc;
+	st_rate_t opos_inc;
+
+	st_rate_t _outrate;
+
+	const SincFilter *_filter;
+
+	bool refill(AudioStream &input);
+	int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp);
+
+public:
+	SincRateConverter(st_rate_t inrate, st_rate_t outrate, bool reverseStereo);
+};
 
+template<bool stereo>
+SincRateConverter<stereo>::SincRateConverter(st_rate_t inrate, st_rate_t outrate, bool reverseStereo)
+	: ChunkedRateConverter(reverseStereo) {
+	if (inrate >= 131072 || outrate >= 131072) {
+		error("rate effect can only handle rates < 131072");
+	}
+
+	_filter = SincFilterCache::instance().getFilter(inrate, outrate);
+
+	// Start with silence in front of the first sample, so the filter is
+	// centered on the first input sample for the first output sample.
+	histLen = _filter->taps / 2 - 1;
+	ipos = histLen;
+	memset(hist0, 0, sizeof(hist0));
+	memset(hist1, 0, sizeof(hist1));
+
+	opos = 0;
+	ipos_inc = inrate / outrate;
+	opos_inc = inrate % outrate;
+	_outrate = outrate;
+}
+
+/*
+ * Drop history which is no longer needed and read more input samples.
+ * Returns false if the input stream has no more data.
+ */
+template<bool stereo>
+bool SincRateConverter<stereo>::refill(AudioStream &input) {
+	const int drop = MIN<int>(ipos - (_filter->taps / 2 - 1), histLen);
+	if (drop > 0) {
+		histLen -= drop;
+		ipos -= drop;
+		memmove(hist0, hist0 + drop, histLen * sizeof(int16));
 		if (stereo)
-			osamp *= 2;
+			memmove(hist1, hist1 + drop, histLen * sizeof(int16));
+	}
 
-		// Reallocate temp buffer, if necessary
-		if (osamp > _bufferSize) {
-			free(_buffer);
-			_buffer = (st_sample_t *)malloc(osamp * 2);
-			_bufferSize = osamp;
-		}
+	const int space = MIN<int>(HISTORY_SIZE - histLen, INTERMEDIATE_BUFFER_SIZE / (stereo ? 2 : 1));
+	const int len = input.readBuffer(inBuf, space * (stereo ? 2 : 1));
+	if (len <= 0)
+		return false;
+
+	const st_sample_t *inPtr = inBuf;
+	for (int i = 0; i < len / (stereo ? 2 : 1); ++i) {
+		hist0[histLen] = *inPtr++;
+		if (stereo)
+			hist1[histLen] = *inPtr++;
+		histLen++;
+	}
 
-		if (!_buffer)
-			error("[CopyRateConverter::flow] Cannot allocate memory for temp buffer");
+	return true;
+}
 
-		// Read up to 'osamp' samples into our temporary buffer
-		len = input.readBuffer(_buffer, osamp);
+template<bool stereo>
+int SincRateConverter<stereo>::convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+	st_sample_t *ostart, *oend;
+	const int taps = _filter->taps;
+	const int half = taps / 2;
 
-		// Mix the data into the output buffer
-		ptr = _buffer;
-		for (; len > 0; len -= (stereo ? 2 : 1)) {
-			st_sample_t out0, out1;
-			out0 = *ptr++;
-			out1 = (stereo ? *ptr++ : out0);
+	ostart = obuf;
+	oend = obuf + osamp * 2;
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+	while (obuf < oend) {
+		// make sure all samples covered by the filter are available
+		while (ipos + half >= histLen) {
+			if (!refill(input))
+				return (obuf - ostart) / 2;
+		}
 
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+		const int phase = (opos * SINC_PHASES + _outrate / 2) / _outrate;
+		const int16 *coeffs = _filter->getPhase(phase);
+		const int first = ipos - (half - 1);
 
-			obuf += 2;
+		st_sample_t out0, out1;
+		out0 = sincOutput(sincDotProduct(hist0 + first, coeffs, taps));
+		out1 = (stereo ? sincOutput(sincDotProduct(hist1 + first, coeffs, taps)) : out0);
+
+		obuf[0] = out0;
+		obuf[1] = out1;
+		obuf += 2;
+
+		// Increment output position
+		ipos += ipos_inc;
+		opos += opos_inc;
+		if (opos >= _outrate) {
+			opos -= _outrate;
+			ipos++;
 		}
-		return (obuf - ostart) / 2;
 	}
+	return (obuf - ostart) / 2;
+}
 
-	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
-		return ST_SUCCESS;
+
+#pragma mark -
+
+
+/**
+ * Simple audio rate converter for the case that the inrate equals the outrate.
+ */
+template<bool stereo>
+class CopyRateConverter : public ChunkedRateConverter {
+protected:
+	int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+		assert(input.isStereo() == stereo);
+
+		if (stereo) {
+			// Stereo data can be read straight into the chunk buffer
+			const int len = input.readBuffer(obuf, osamp * 2);
+			return len > 0 ? len / 2 : 0;
+		}
+
+		// Read the mono samples into the upper half of the chunk buffer and
+		// expand them in place. Writing never overtakes reading here.
+		st_sample_t *ptr = obuf + osamp;
+		const int len = input.readBuffer(ptr, osamp);
+		for (int i = 0; i < len; ++i) {
+			const st_sample_t out0 = ptr[i];
+			obuf[i * 2    ] = out0;
+			obuf[i * 2 + 1] = out0;
+		}
+		return len > 0 ? len : 0;
 	}
+
+public:
+	CopyRateConverter(bool reverseStereo) : ChunkedRateConverter(reverseStereo) {}
 };
 
 
 #pragma mark -
 
-template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+static ResamplerType s_resamplerType = kResamplerLinear;
+
+void setResamplerType(ResamplerType type) {
+	s_resamplerType = type;
+}
+
+ResamplerType getResamplerType() {
+	return s_resamplerType;
+}
+
+template<bool stereo>
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool reverseStereo) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
-			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
+		if (s_resamplerType == kResamplerSinc) {
+			return new SincRateConverter<stereo>(inrate, outrate, reverseStereo);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
+			return new SimpleRateConverter<stereo>(inrate, outrate, reverseStereo);
 		} else {
-			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
+			return new LinearRateConverter<stereo>(inrate, outrate, reverseStereo);
 		}
 	} else {
-		return new CopyRateConverter<stereo, reverseStereo>();
+		return new CopyRateConverter<stereo>(reverseStereo);
 	}
 }
 
@@ -357,13 +959,10 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
  * Create and return a RateConverter object for the specified input and output rates.
  */
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
-	if (stereo) {
-		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
-		else
-			return makeRateConverter<true, false>(inrate, outrate);
-	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+	if (stereo)
+		return makeRateConverter<true>(inrate, outrate, reverseStereo);
+	else
+		return makeRateConverter<false>(inrate, outrate, false);
 }
 
 } // End of namespace Audio
@@ -34,12 +34,23 @@ typedef uint16 st_volume_t;
 typedef uint32 st_size_t;
 typedef uint32 st_rate_t;
 
+/** Sample type of the mixer's mix bus, which is wide enough to not clip. */
+typedef int32 st_mix_t;
+
 /* Minimum and maximum values a sample can hold. */
 enum {
 	ST_SAMPLE_MAX = 0x7fffL,
 	ST_SAMPLE_MIN = (-ST_SAMPLE_MAX - 1L)
 };
 
+/**
+ * The number of sample pairs a converter produces before they are scaled
+ * and mixed into the output buffer in one go.
+ */
+enum {
+	ST_MIX_CHUNK_SIZE = 512
+};
+
 enum {
 	ST_EOF = -1,
 	ST_SUCCESS = 0
@@ -75,9 +86,32 @@ public:
 	 */
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Like flow(), but accumulates into a 32 bit mix bus without clipping.
+	 * The default implementation converts into a temporary buffer via flow().
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
 };
 
+/** The methods makeRateConverter() can use for changing the rate. */
+enum ResamplerType {
+	kResamplerLinear,	///< Linear interpolation, or decimation for integer ratios
+	kResamplerSinc		///< Polyphase windowed-sinc filter
+};
+
+/**
+ * Set the method used by converters created from now on. The mixer sets
+ * this from the "resampler" config key when it is created.
+ */
+void setResamplerType(ResamplerType type);
+
+/** Get the method used for new converters. */
+ResamplerType getResamplerType();
+
 RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
 
 } // End of namespace Audio
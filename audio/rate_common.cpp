@@ -0,0 +1,71 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Code shared by the generic and the ARM rate converters.
+
+#include "audio/rate.h"
+#include "common/util.h"
+
+namespace Audio {
+
+/**
+ * Fallback for converters without a native mix bus path: mix into silence
+ * and widen the result.
+ */
+int RateConverter::flowAccumulate(AudioStream &input, st_mix_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t chunk[ST_MIX_CHUNK_SIZE * 2];
+	int total = 0;
+
+	while (osamp > 0) {
+		const st_size_t wanted = MIN<st_size_t>(osamp, ST_MIX_CHUNK_SIZE);
+
+		// flow() mixes into what is in the buffer, so start from silence
+		for (st_size_t i = 0; i < wanted * 2; ++i) {
+#ifdef OUTPUT_UNSIGNED_AUDIO
+			chunk[i] = (st_sample_t)0x8000;
+#else
+			chunk[i] = 0;
+#endif
+		}
+
+		const int produced = flow(input, chunk, wanted, vol_l, vol_r);
+		if (produced <= 0)
+			break;
+
+		for (int i = 0; i < produced * 2; ++i) {
+#ifdef OUTPUT_UNSIGNED_AUDIO
+			*obuf++ += (st_sample_t)(chunk[i] ^ 0x8000);
+#else
+			*obuf++ += chunk[i];
+#endif
+		}
+		osamp -= produced;
+		total += produced;
+
+		if ((st_size_t)produced < wanted)
+			break;
+	}
+
+	return total;
+}
+
+} // End of namespace Audio
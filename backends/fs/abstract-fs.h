@@ -173,6 +173,15 @@ public:
 	 */
 	virtual bool isWritable() const = 0;
 
+	/**
+	 * Retrieves the size and the last modification time of the file referred
+	 * by this node, without opening it. Backends which can't do this cheaply
+	 * leave the default implementation, which reports failure.
+	 *
+	 * @return bool true if size and modTime were set, false otherwise.
+	 */
+	virtual bool getFileStatus(uint32 &size, uint32 &modTime) const { return false; }
+
 
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
@@ -1399,15 +1399,73 @@ void SurfaceSdlGraphicsManager::fillScreen(uint32 col) {
 	unlockScreen();
 }
 
+/**
+ * Compute the bounding box of two dirty rects and return the number of
+ * pixels it covers which are in neither of them. That is the amount of
+ * extra scaling and uploading work caused by merging the two.
+ */
+static int dirtyRectMergeCost(const SDL_Rect &a, const SDL_Rect &b, SDL_Rect &merged) {
+	const int x1 = MIN<int>(a.x, b.x);
+	const int y1 = MIN<int>(a.y, b.y);
+	const int x2 = MAX<int>(a.x + a.w, b.x + b.w);
+	const int y2 = MAX<int>(a.y + a.h, b.y + b.h);
+
+	merged.x = x1;
+	merged.y = y1;
+	merged.w = x2 - x1;
+	merged.h = y2 - y1;
+
+	const int ix = MAX<int>(0, MIN<int>(a.x + a.w, b.x + b.w) - MAX<int>(a.x, b.x));
+	const int iy = MAX<int>(0, MIN<int>(a.y + a.h, b.y + b.h) - MAX<int>(a.y, b.y));
+
+	return (x2 - x1) * (y2 - y1) - a.w * a.h - b.w * b.h + ix * iy;
+}
+
+void SurfaceSdlGraphicsManager::mergeDirtyRect(SDL_Rect rect) {
+	// Fold the new rect into an existing one whenever their bounding box
+	// wastes less than half the area of the smaller rect. Measuring against
+	// the smaller rect keeps large rects from swallowing everything nearby.
+	// Merging may grow the rect into others, so repeat until stable.
+	// Once the list is full, the new rect is merged with the queued rect
+	// it wastes the least with, so we never fall back to a full screen
+	// update. Only pairs involving the new rect are considered, which
+	// keeps this linear in the number of queued rects.
+	for (;;) {
+		SDL_Rect merged, bestMerged;
+		int best = -1;
+		int bestCost = 0;
+
+		for (int i = 0; i < _numDirtyRects; ++i) {
+			const SDL_Rect &r = _dirtyRectList[i];
+			const int cost = dirtyRectMergeCost(r, rect, merged);
+
+			if (cost * 2 <= MIN<int>(r.w * r.h, rect.w * rect.h)) {
+				best = i;
+				bestMerged = merged;
+				break;
+			}
+
+			if (_numDirtyRects == NUM_DIRTY_RECT && (best == -1 || cost < bestCost)) {
+				best = i;
+				bestCost = cost;
+				bestMerged = merged;
+			}
+		}
+
+		if (best == -1) {
+			_dirtyRectList[_numDirtyRects++] = rect;
+			return;
+		}
+
+		_dirtyRectList[best] = _dirtyRectList[--_numDirtyRects];
+		rect = bestMerged;
+	}
+}
+
 void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool realCoordinates) {
 	if (_forceFull)
 		return;
 
-	if (_numDirtyRects == NUM_DIRTY_RECT) {
-		_forceFull = true;
-		return;
-	}
-
 	int height, width;
 
 	if (!_overlayVisible && !realCoordinates) {
@@ -1458,12 +1516,14 @@ void SurfaceSdlGraphicsManager::addDirtyRect(int x, int y, int w, int h, bool re
 	}
 
 	if (w > 0 && h > 0) {
-		SDL_Rect *r = &_dirtyRectList[_numDirtyRects++];
+		SDL_Rect r;
+
+		r.x = x;
+		r.y = y;
+		r.w = w;
+		r.h = h;
 
-		r->x = x;
-		r->y = y;
-		r->w = w;
-		r->h = h;
+		mergeDirtyRect(r);
 	}
 }
 
@@ -288,7 +288,8 @@ protected:
 		MAX_SCALING = 3
 	};
 
-	// Dirty rect management
+	// Dirty rect management. Rects are coalesced on insertion, so the list
+	// never overflows into a full screen update.
 	SDL_Rect _dirtyRectList[NUM_DIRTY_RECT];
 	int _numDirtyRects;
 
@@ -359,6 +360,12 @@ protected:
 #endif
 
 	virtual void addDirtyRect(int x, int y, int w, int h, bool realCoordinates = false);
+	/**
+	 * Insert a clipped rect into the dirty list, coalescing it with nearby
+	 * ones. When the list is full, the rect is merged with its cheapest
+	 * partner.
+	 */
+	void mergeDirtyRect(SDL_Rect rect);
 
 	virtual void drawMouse();
 	virtual void undrawMouse();
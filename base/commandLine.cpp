@@ -27,18 +27,21 @@
 
 #include <limits.h>
 
+#include "engines/gamescanner.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
 #include "base/version.h"
 
 #include "common/config-manager.h"
+#include "common/fingerprint-cache.h"
 #include "common/fs.h"
 #include "common/rendermode.h"
 #include "common/system.h"
 #include "common/textconsole.h"
 
 #include "gui/ThemeEngine.h"
+#include "gui/launcher.h"	// For addGameToConf()
 
 #include "audio/musicplugin.h"
 
@@ -68,6 +71,9 @@ static const char HELP_STRING[] =
 	"  -z, --list-games         Display list of supported games and exit\n"
 	"  -t, --list-targets       Display list of configured targets and exit\n"
 	"  --list-saves=TARGET      Display a list of saved games for the game (TARGET) specified\n"
+	"  --add                    Add all games found in the directory given by --path\n"
+	"                           (default: current directory) and exit\n"
+	"  --recursive              With --add, also search all subdirectories\n"
 #if defined(WIN32) && !defined(_WIN32_WCE) && !defined(__SYMBIAN32__)
 	"  --console                Enable the console window (default:enabled)\n"
 #endif
@@ -396,6 +402,12 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_COMMAND('z', "list-games")
 			END_COMMAND
 
+			DO_LONG_COMMAND("add")
+			END_COMMAND
+
+			DO_LONG_OPTION_BOOL("recursive")
+			END_OPTION
+
 #ifdef DETECTOR_TESTING_HACK
 			// HACK FIXME TODO: This command is intentionally *not* documented!
 			DO_LONG_COMMAND("test-detector")
@@ -729,6 +741,52 @@ static Common::Error listSaves(const char *target) {
 	return result;
 }
 
+/** Detect the games in the given directory and add them to the config file. */
+static Common::Error addGames(const Common::String &path, bool recursive) {
+	// FIXME HACK: The fingerprint cache lives in the savefile directory
+	g_system->initBackend();
+
+	Common::FSNode dir(path.empty() ? Common::String(".") : path);
+	if (!dir.exists())
+		return Common::Error(Common::kPathDoesNotExist, dir.getPath());
+	if (!dir.isDirectory())
+		return Common::Error(Common::kPathNotDirectory, dir.getPath());
+
+	// One target per directory, like adding a single game in the launcher
+	GameScanner scanner(dir, recursive, false);
+	const uint32 start = g_system->getMillis();
+	bool done;
+	do {
+		// Report the games as they are found, and the progress once
+		// in a while, so that large libraries don't look stuck.
+		done = scanner.scan(1000);
+		while (scanner.hasGames()) {
+			GameDescriptor game = scanner.popGame();
+			Common::String target = GUI::addGameToConf(game);
+			printf("Added target '%s' for '%s' in '%s'\n",
+				   target.c_str(), game.description().c_str(), game["path"].c_str());
+		}
+		while (scanner.hasAmbiguousDirs()) {
+			printf("Skipped '%s': several games detected, use the launcher to choose one\n",
+				   scanner.popAmbiguousDir().c_str());
+		}
+		if (!done)
+			printf("Scanned %d of %d directories ...\n", scanner.getDirsScanned(), scanner.getDirTotal());
+	} while (!done);
+
+	const uint32 elapsed = g_system->getMillis() - start;
+	ConfMan.flushToDisk();
+	FingerprintMan.flush();
+
+	printf("Scanned %d directories in %u ms (%.1f directories/s), "
+		   "added %d games, skipped %d already added games\n",
+		   scanner.getDirsScanned(), elapsed,
+		   elapsed ? scanner.getDirsScanned() * 1000.0 / elapsed : 0.0,
+		   scanner.getNewGamesCount(), scanner.getOldGamesCount());
+
+	return Common::kNoError;
+}
+
 /** Lists all usable themes */
 static void listThemes() {
 	typedef Common::List<GUI::ThemeEngine::ThemeDescriptor> ThList;
@@ -973,6 +1031,9 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 	} else if (command == "list-themes") {
 		listThemes();
 		return true;
+	} else if (command == "add") {
+		err = addGames(settings["path"], settings["recursive"] == "true");
+		return true;
 	} else if (command == "list-audio-devices") {
 		listAudioDevices();
 		return true;
@@ -42,6 +42,7 @@
 #include "common/debug.h"
 #include "common/debug-channels.h" /* for debug manager */
 #include "common/events.h"
+#include "common/fingerprint-cache.h"
 #include "gui/EventRecorder.h"
 #include "common/fs.h"
 #ifdef ENABLE_EVENTRECORDER
@@ -584,6 +585,7 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 			launcherDialog();
 		}
 	}
+	Common::FingerprintCache::destroy();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
 	GUI::GuiManager::destroy();
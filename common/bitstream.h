@@ -116,14 +116,34 @@ private:
 		return 0;
 	}
 
+	/** Read a data value from memory. */
+	inline uint32 readData(const byte *data) {
+		if (valueBits == 8)
+			return *data;
+		if (valueBits == 16)
+			return isLE ? READ_LE_UINT16(data) : READ_BE_UINT16(data);
+		return isLE ? READ_LE_UINT32(data) : READ_BE_UINT32(data);
+	}
+
 	/** Read the next data value. */
 	inline void readValue() {
-		if ((size() - pos()) < valueBits)
-			error("BitStreamImpl::readValue(): End of bit stream reached");
+		// Streams which have the data in memory hand it over directly, which
+		// saves several virtual calls per value. Values are only read at value
+		// borders, so a window holding a whole value means the bit stream has
+		// not reached its end yet.
+		uint32 windowSize;
+		const byte *window = _stream->getReadWindow(windowSize);
+		if (windowSize >= (valueBits >> 3)) {
+			_value = readData(window);
+			_stream->consumeReadWindow(valueBits >> 3);
+		} else {
+			if ((size() - pos()) < valueBits)
+				error("BitStreamImpl::readValue(): End of bit stream reached");
 
-		_value = readData();
-		if (_stream->err() || _stream->eos())
-			error("BitStreamImpl::readValue(): Read error");
+			_value = readData();
+			if (_stream->err() || _stream->eos())
+				error("BitStreamImpl::readValue(): Read error");
+		}
 
 		// If we're reading the bits MSB first, we need to shift the value to that position
 		if (isMSB2LSB)
@@ -0,0 +1,213 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/fingerprint-cache.h"
+#include "common/endian.h"
+#include "common/file.h"
+#include "common/fs.h"
+#include "common/md5.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+namespace Common {
+
+DECLARE_SINGLETON(FingerprintCache);
+
+static const char *const kCacheFileName = "detection.cache";
+
+enum {
+	kCacheVersion = 1,
+	kMD5Length = 32
+};
+
+FingerprintCache::FingerprintCache() : _loaded(false), _dirty(false), _hits(0), _misses(0) {
+}
+
+FingerprintCache::~FingerprintCache() {
+	flush();
+}
+
+String FingerprintCache::makeKey(const String &path, uint32 md5Bytes) {
+	return String::format("%u|", md5Bytes) + path;
+}
+
+bool FingerprintCache::getFingerprint(const FSNode &node, uint32 md5Bytes, String &md5, int32 &size) {
+	uint32 statSize, statTime;
+	const bool hasStatus = node.getFileStatus(statSize, statTime);
+
+	String key;
+	if (hasStatus) {
+		if (!_loaded)
+			load();
+
+		key = makeKey(node.getPath(), md5Bytes);
+		EntryMap::iterator it = _entries.find(key);
+		if (it != _entries.end() && it->_value.size == statSize && it->_value.modTime == statTime) {
+			it->_value.seen = true;
+			md5 = it->_value.md5;
+			size = (int32)statSize;
+			_hits++;
+			return true;
+		}
+	}
+
+	File file;
+	if (!file.open(node))
+		return false;
+
+	size = (int32)file.size();
+	md5 = computeStreamMD5AsString(file, md5Bytes);
+	_misses++;
+
+	// Only remember the result if the file did not change under us
+	if (hasStatus && (uint32)size == statSize) {
+		Entry &entry = _entries[key];
+		entry.size = statSize;
+		entry.modTime = statTime;
+		entry.md5 = md5;
+		entry.seen = true;
+		_dirty = true;
+	}
+
+	return true;
+}
+
+void FingerprintCache::load() {
+	if (!g_system)
+		return;
+	SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	// Only now, as a cache used before the backend is set up must still be
+	// merged with the stored one
+	_loaded = true;
+
+	SeekableReadStream *in = saveFileMan->openForLoading(kCacheFileName);
+	if (!in)
+		return;
+
+	if (in->readUint32BE() != MKTAG('F', 'P', 'C', 'A') || in->readUint32BE() != kCacheVersion) {
+		delete in;
+		return;
+	}
+
+	const uint32 count = in->readUint32BE();
+	char md5Buf[kMD5Length];
+	for (uint32 i = 0; i < count && !in->eos() && !in->err(); i++) {
+		const uint32 md5Bytes = in->readUint32BE();
+		Entry entry;
+		entry.size = in->readUint32BE();
+		entry.modTime = in->readUint32BE();
+
+		const uint16 pathLength = in->readUint16BE();
+		String path;
+		for (uint16 j = 0; j < pathLength; j++)
+			path += (char)in->readByte();
+
+		if (in->read(md5Buf, kMD5Length) != kMD5Length)
+			break;
+		entry.md5 = String(md5Buf, kMD5Length);
+		entry.seen = false;
+
+		// Entries found during this run are newer than the stored ones
+		const String key = makeKey(path, md5Bytes);
+		if (!_entries.contains(key))
+			_entries[key] = entry;
+	}
+
+	delete in;
+}
+
+void FingerprintCache::prune(const FSNode &dir, bool recursive) {
+	if (!_loaded)
+		load();
+
+	String prefix = dir.getPath();
+	while (!prefix.empty() && (prefix.lastChar() == '/' || prefix.lastChar() == '\\'))
+		prefix.deleteLastChar();
+
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		if (it->_value.seen)
+			continue;
+
+		const char *path = strchr(it->_key.c_str(), '|') + 1;
+		if (strncmp(path, prefix.c_str(), prefix.size()))
+			continue;
+
+		const char *name = path + prefix.size();
+		if (*name != '/' && *name != '\\')
+			continue;
+		if (!recursive && strpbrk(name + 1, "/\\"))
+			continue;
+
+		_entries.erase(it);
+		_dirty = true;
+	}
+}
+
+void FingerprintCache::flush() {
+	if (!g_system)
+		return;
+	SaveFileManager *saveFileMan = g_system->getSavefileManager();
+	if (!saveFileMan)
+		return;
+
+	// Don't overwrite the stored cache with only the entries of this run
+	if (!_loaded)
+		load();
+	if (!_dirty)
+		return;
+
+	OutSaveFile *out = saveFileMan->openForSaving(kCacheFileName, false);
+	if (!out) {
+		warning("FingerprintCache: Could not write '%s'", kCacheFileName);
+		return;
+	}
+
+	out->writeUint32BE(MKTAG('F', 'P', 'C', 'A'));
+	out->writeUint32BE(kCacheVersion);
+	out->writeUint32BE(_entries.size());
+
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		const String &key = it->_key;
+		const char *separator = strchr(key.c_str(), '|');
+		const String path(separator + 1);
+
+		out->writeUint32BE((uint32)atoi(key.c_str()));
+		out->writeUint32BE(it->_value.size);
+		out->writeUint32BE(it->_value.modTime);
+		out->writeUint16BE(path.size());
+		out->write(path.c_str(), path.size());
+		out->write(it->_value.md5.c_str(), kMD5Length);
+	}
+
+	out->finalize();
+	if (out->err())
+		warning("FingerprintCache: Could not write '%s'", kCacheFileName);
+	else
+		_dirty = false;
+	delete out;
+}
+
+} // End of namespace Common
@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef COMMON_FINGERPRINT_CACHE_H
+#define COMMON_FINGERPRINT_CACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Common {
+
+class FSNode;
+
+/**
+ * Process-wide cache of the file fingerprints (size and MD5 of the first
+ * bytes) used by game detection.
+ *
+ * Without it, every engine opens and hashes the same candidate files again,
+ * and a re-scan of an unchanged game library repeats all of that work. The
+ * cache is keyed by the path of the file and the number of hashed bytes.
+ * An entry is only used while the size and the modification time of the
+ * file, as reported by FSNode::getFileStatus, still match. On backends
+ * which can not report these, nothing is cached.
+ *
+ * The cache is stored in the savefile directory by flush(), which callers
+ * of the detection should invoke once they are done. Callers which ran the
+ * detection on every file of a directory should call prune() before, so
+ * that the entries of files which were deleted or changed are dropped.
+ */
+class FingerprintCache : public Singleton<FingerprintCache> {
+public:
+	/**
+	 * Get the size of a file and the MD5 of its first md5Bytes bytes.
+	 *
+	 * @param node		the file
+	 * @param md5Bytes	the number of bytes to hash; 0 means the whole file
+	 * @param md5		set to the MD5 of the file, as a string
+	 * @param size		set to the size of the file
+	 * @return true on success, false if the file could not be opened.
+	 */
+	bool getFingerprint(const FSNode &node, uint32 md5Bytes, String &md5, int32 &size);
+
+	/**
+	 * Drop the entries of the files in a directory which were not looked up
+	 * since the cache was loaded. Only call this right after the detection
+	 * was run on the whole directory: the files of these entries are then
+	 * known to be gone or changed, without checking the files again.
+	 *
+	 * @param dir		the directory which was scanned
+	 * @param recursive	whether its subdirectories were scanned as well
+	 */
+	void prune(const FSNode &dir, bool recursive);
+
+	/**
+	 * Write the cache to disk, if it changed since it was loaded.
+	 */
+	void flush();
+
+	/** Number of lookups answered from the cache so far. */
+	uint32 getHits() const { return _hits; }
+
+	/** Number of files which had to be hashed so far. */
+	uint32 getMisses() const { return _misses; }
+
+private:
+	friend class Singleton<SingletonBaseType>;
+	FingerprintCache();
+	~FingerprintCache();
+
+	struct Entry {
+		uint32 size;
+		uint32 modTime;
+		String md5;
+		bool seen;	///< Used or hashed during this run, so known to be current
+	};
+
+	typedef HashMap<String, Entry> EntryMap;
+
+	static String makeKey(const String &path, uint32 md5Bytes);
+
+	void load();
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+	uint32 _hits;
+	uint32 _misses;
+};
+
+} // End of namespace Common
+
+/** Shortcut for accessing the fingerprint cache. */
+#define FingerprintMan Common::FingerprintCache::instance()
+
+#endif
@@ -0,0 +1,542 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The probing scheme and the control byte layout in this file are
+// modelled after the "Swiss table" design used by Abseil's flat_hash_map.
+
+#ifndef COMMON_FLAT_HASHMAP_H
+#define COMMON_FLAT_HASHMAP_H
+
+#include "common/func.h"
+#include "common/textconsole.h" // For error()
+
+namespace Common {
+
+/**
+ * FlatHashMap<Key,Val> is a drop-in replacement for HashMap<Key,Val> which
+ * keeps its nodes inline in a single open-addressed array instead of
+ * allocating them one by one.
+ *
+ * Next to the node array, the map keeps one control byte per slot. A control
+ * byte either marks the slot as empty or erased, or holds seven bits of the
+ * key's hash. Probing only compares keys whose control byte matches, so a
+ * lookup usually touches one control byte and one node, and never chases a
+ * pointer. This allows a higher load factor than HashMap uses.
+ *
+ * The API mirrors HashMap, including the guarantee that erasing the element
+ * an iterator points at does not invalidate other iterators. Unlike HashMap,
+ * any insertion may move the nodes, so references to values must not be
+ * kept across an insertion.
+ */
+template<class Key, class Val, class HashFunc = Hash<Key>, class EqualFunc = EqualTo<Key> >
+class FlatHashMap {
+public:
+	typedef uint size_type;
+
+private:
+
+	typedef FlatHashMap<Key, Val, HashFunc, EqualFunc> FHM_t;
+
+	struct Node {
+		const Key _key;
+		Val _value;
+		explicit Node(const Key &key) : _key(key), _value() {}
+	};
+
+	enum {
+		FLATHASHMAP_MIN_CAPACITY = 16,
+
+		// The quotient of the next two constants controls how much the
+		// internal storage may fill up (erased slots included) before
+		// it is rebuilt.
+		FLATHASHMAP_LOADFACTOR_NUMERATOR = 7,
+		FLATHASHMAP_LOADFACTOR_DENOMINATOR = 8
+	};
+
+	enum {
+		kCtrlEmpty = 0x80,   ///< Slot has never been used since the last rebuild
+		kCtrlDeleted = 0xFE  ///< Slot held an erased node; probing continues past it
+		// Any value below 0x80 marks a used slot and holds the hash tag of its key
+	};
+
+	byte *_ctrl;		///< Control bytes, one per slot
+	Node *_slots;		///< Node storage; only slots with a used control byte are constructed
+	size_type _mask;	///< Capacity minus one; the capacity is a power of two
+	size_type _size;
+	size_type _deleted;	///< Number of kCtrlDeleted slots
+
+	HashFunc _hash;
+	EqualFunc _equal;
+
+	/** Default value, returned by the const getVal. */
+	const Val _defaultVal;
+
+	/**
+	 * Compute the slot where probing for a hash starts. Folding in the high
+	 * half keeps keys which only differ in their high bits apart, while
+	 * small dense keys (with identity hashes) still map to distinct slots.
+	 */
+	size_type homeSlot(size_type hash) const {
+		return (hash ^ (hash >> 16)) & _mask;
+	}
+
+	/**
+	 * Compute the tag stored in the control byte of a used slot. The tag is
+	 * taken from the top bits of a scrambled copy of the hash, since many
+	 * of our hash functors are the identity, which would otherwise leave
+	 * the tag all zero for small integers.
+	 */
+	static byte hashTag(size_type hash) {
+		hash *= 0x9E3779B1;
+		return (byte)((hash >> 25) & 0x7F);
+	}
+
+	static bool isUsed(byte ctrl) {
+		return ctrl < kCtrlEmpty;
+	}
+
+	void allocStorage(size_type capacity);
+	void freeStorage();
+	void assign(const FHM_t &map);
+	size_type lookup(const Key &key) const;
+	size_type lookupAndCreateIfMissing(const Key &key);
+	void rehash(size_type newCapacity);
+
+	template<class T> friend class IteratorImpl;
+
+	/**
+	 * Simple FlatHashMap iterator implementation.
+	 */
+	template<class NodeType>
+	class IteratorImpl {
+		friend class FlatHashMap;
+		template<class T> friend class IteratorImpl;
+	protected:
+		typedef const FlatHashMap hashmap_t;
+
+		size_type _idx;
+		hashmap_t *_hashmap;
+
+	protected:
+		IteratorImpl(size_type idx, hashmap_t *hashmap) : _idx(idx), _hashmap(hashmap) {}
+
+		NodeType *deref() const {
+			assert(_hashmap != 0);
+			assert(_idx <= _hashmap->_mask);
+			assert(isUsed(_hashmap->_ctrl[_idx]));
+			return &_hashmap->_slots[_idx];
+		}
+
+	public:
+		IteratorImpl() : _idx(0), _hashmap(0) {}
+		template<class T>
+		IteratorImpl(const IteratorImpl<T> &c) : _idx(c._idx), _hashmap(c._hashmap) {}
+
+		NodeType &operator*() const { return *deref(); }
+		NodeType *operator->() const { return deref(); }
+
+		bool operator==(const IteratorImpl &iter) const { return _idx == iter._idx && _hashmap == iter._hashmap; }
+		bool operator!=(const IteratorImpl &iter) const { return !(*this == iter); }
+
+		IteratorImpl &operator++() {
+			assert(_hashmap);
+			do {
+				_idx++;
+			} while (_idx <= _hashmap->_mask && !isUsed(_hashmap->_ctrl[_idx]));
+			if (_idx > _hashmap->_mask)
+				_idx = (size_type)-1;
+
+			return *this;
+		}
+
+		IteratorImpl operator++(int) {
+			IteratorImpl old = *this;
+			operator ++();
+			return old;
+		}
+	};
+
+public:
+	typedef IteratorImpl<Node> iterator;
+	typedef IteratorImpl<const Node> const_iterator;
+
+	FlatHashMap();
+	FlatHashMap(const FHM_t &map);
+	~FlatHashMap();
+
+	FHM_t &operator=(const FHM_t &map) {
+		if (this == &map)
+			return *this;
+
+		// Remove the previous content and ...
+		freeStorage();
+		// ... copy the new stuff.
+		assign(map);
+		return *this;
+	}
+
+	bool contains(const Key &key) const;
+
+	Val &operator[](const Key &key);
+	const Val &operator[](const Key &key) const;
+
+	Val &getVal(const Key &key);
+	const Val &getVal(const Key &key) const;
+	const Val &getVal(const Key &key, const Val &defaultVal) const;
+	void setVal(const Key &key, const Val &val);
+
+	void clear(bool shrinkArray = 0);
+
+	void erase(iterator entry);
+	void erase(const Key &key);
+
+	size_type size() const { return _size; }
+
+	/** Number of slots currently allocated. */
+	size_type capacity() const { return _mask + 1; }
+
+	iterator	begin() {
+		// Find and return the first used entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isUsed(_ctrl[ctr]))
+				return iterator(ctr, this);
+		}
+		return end();
+	}
+	iterator	end() {
+		return iterator((size_type)-1, this);
+	}
+
+	const_iterator	begin() const {
+		// Find and return the first used entry
+		for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+			if (isUsed(_ctrl[ctr]))
+				return const_iterator(ctr, this);
+		}
+		return end();
+	}
+	const_iterator	end() const {
+		return const_iterator((size_type)-1, this);
+	}
+
+	iterator	find(const Key &key) {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return iterator(ctr, this);
+		return end();
+	}
+
+	const_iterator	find(const Key &key) const {
+		size_type ctr = lookup(key);
+		if (ctr <= _mask)
+			return const_iterator(ctr, this);
+		return end();
+	}
+
+	bool empty() const {
+		return (_size == 0);
+	}
+};
+
+//-------------------------------------------------------
+// FlatHashMap functions
+
+/**
+ * Base constructor, creates an empty map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap() : _defaultVal() {
+	allocStorage(FLATHASHMAP_MIN_CAPACITY);
+}
+
+/**
+ * Copy constructor, creates a full copy of the given map.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::FlatHashMap(const FHM_t &map) : _defaultVal() {
+	assign(map);
+}
+
+/**
+ * Destructor, frees all used memory.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+FlatHashMap<Key, Val, HashFunc, EqualFunc>::~FlatHashMap() {
+	freeStorage();
+}
+
+/**
+ * Internal method for allocating empty storage with the given capacity.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::allocStorage(size_type capacity) {
+	assert(capacity >= FLATHASHMAP_MIN_CAPACITY && (capacity & (capacity - 1)) == 0);
+
+	_ctrl = (byte *)malloc(capacity);
+	_slots = (Node *)malloc(capacity * sizeof(Node));
+	if (!_ctrl || !_slots)
+		::error("Common::FlatHashMap: failure to allocate %u slots", capacity);
+	memset(_ctrl, kCtrlEmpty, capacity);
+
+	_mask = capacity - 1;
+	_size = 0;
+	_deleted = 0;
+}
+
+/**
+ * Internal method for destroying all nodes and releasing the storage.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::freeStorage() {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(_ctrl[ctr]))
+			_slots[ctr].~Node();
+	}
+
+	free(_slots);
+	free(_ctrl);
+	_slots = 0;
+	_ctrl = 0;
+}
+
+/**
+ * Internal method for assigning the content of another FlatHashMap
+ * to this one. The slot layout, erased slots included, is copied verbatim,
+ * so no rehashing is required.
+ *
+ * @note We do *not* deallocate the previous storage here -- the caller is
+ *       responsible for doing that!
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::assign(const FHM_t &map) {
+	allocStorage(map._mask + 1);
+	memcpy(_ctrl, map._ctrl, _mask + 1);
+
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(_ctrl[ctr]))
+			new ((void *)&_slots[ctr]) Node(map._slots[ctr]);
+	}
+
+	_size = map._size;
+	_deleted = map._deleted;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::clear(bool shrinkArray) {
+	for (size_type ctr = 0; ctr <= _mask; ++ctr) {
+		if (isUsed(_ctrl[ctr]))
+			_slots[ctr].~Node();
+	}
+
+	if (shrinkArray && _mask >= FLATHASHMAP_MIN_CAPACITY) {
+		free(_slots);
+		free(_ctrl);
+		allocStorage(FLATHASHMAP_MIN_CAPACITY);
+	} else {
+		memset(_ctrl, kCtrlEmpty, _mask + 1);
+		_size = 0;
+		_deleted = 0;
+	}
+}
+
+/**
+ * Internal method for rebuilding the storage with the given capacity.
+ * This also drops all erased slots.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::rehash(size_type newCapacity) {
+	const size_type oldSize = _size;
+	const size_type oldMask = _mask;
+	byte *oldCtrl = _ctrl;
+	Node *oldSlots = _slots;
+
+	allocStorage(newCapacity);
+
+	for (size_type ctr = 0; ctr <= oldMask; ++ctr) {
+		if (!isUsed(oldCtrl[ctr]))
+			continue;
+
+		// Since we know that no key exists twice in the old table, we
+		// only have to look for the first empty slot.
+		const size_type hash = _hash(oldSlots[ctr]._key);
+		size_type idx = homeSlot(hash);
+		for (size_type step = 1; _ctrl[idx] != kCtrlEmpty; ++step)
+			idx = (idx + step) & _mask;
+
+		new ((void *)&_slots[idx]) Node(oldSlots[ctr]);
+		_ctrl[idx] = hashTag(hash);
+		oldSlots[ctr].~Node();
+		_size++;
+	}
+
+	// Perform a sanity check: Old number of elements should match the new one!
+	// This check will fail if some previous operation corrupted this map.
+	assert(_size == oldSize);
+	(void)oldSize;
+
+	free(oldSlots);
+	free(oldCtrl);
+}
+
+/**
+ * Returns the slot holding the given key, or _mask + 1 if there is none.
+ */
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookup(const Key &key) const {
+	const size_type hash = _hash(key);
+	const byte tag = hashTag(hash);
+	size_type idx = homeSlot(hash);
+
+	// Triangular probing visits every slot of a power of two sized table.
+	// The load factor guarantees there is always an empty slot to stop at.
+	for (size_type step = 1; ; ++step) {
+		const byte ctrl = _ctrl[idx];
+		if (ctrl == tag && _equal(_slots[idx]._key, key))
+			return idx;
+		if (ctrl == kCtrlEmpty)
+			return _mask + 1;
+		idx = (idx + step) & _mask;
+	}
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+typename FlatHashMap<Key, Val, HashFunc, EqualFunc>::size_type FlatHashMap<Key, Val, HashFunc, EqualFunc>::lookupAndCreateIfMissing(const Key &key) {
+	const size_type hash = _hash(key);
+	const byte tag = hashTag(hash);
+	const size_type NONE_FOUND = _mask + 1;
+	size_type firstFree = NONE_FOUND;
+	size_type idx = homeSlot(hash);
+
+	for (size_type step = 1; ; ++step) {
+		const byte ctrl = _ctrl[idx];
+		if (ctrl == tag && _equal(_slots[idx]._key, key))
+			return idx;
+		if (ctrl == kCtrlEmpty)
+			break;
+		if (ctrl == kCtrlDeleted && firstFree == NONE_FOUND)
+			firstFree = idx;
+		idx = (idx + step) & _mask;
+	}
+
+	// Reuse the first erased slot on the probe sequence, if any
+	if (firstFree != NONE_FOUND) {
+		idx = firstFree;
+		_deleted--;
+	}
+
+	new ((void *)&_slots[idx]) Node(key);
+	_ctrl[idx] = tag;
+	_size++;
+
+	// Keep the load factor below a certain threshold.
+	// Erased slots are also counted, since they lengthen the probe sequences.
+	size_type capacity = _mask + 1;
+	if ((_size + _deleted) * FLATHASHMAP_LOADFACTOR_DENOMINATOR >
+	        capacity * FLATHASHMAP_LOADFACTOR_NUMERATOR) {
+		// Only grow if the live elements need it; otherwise rebuilding at
+		// the same size is enough to get rid of the erased slots.
+		if (_size * 2 >= capacity)
+			capacity *= 2;
+		rehash(capacity);
+		idx = lookup(key);
+		assert(idx <= _mask);
+	}
+
+	return idx;
+}
+
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+bool FlatHashMap<Key, Val, HashFunc, EqualFunc>::contains(const Key &key) const {
+	return lookup(key) <= _mask;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::operator[](const Key &key) const {
+	return getVal(key);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	return _slots[ctr]._value;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key) const {
+	return getVal(key, _defaultVal);
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+const Val &FlatHashMap<Key, Val, HashFunc, EqualFunc>::getVal(const Key &key, const Val &defaultVal) const {
+	size_type ctr = lookup(key);
+	if (ctr <= _mask)
+		return _slots[ctr]._value;
+	else
+		return defaultVal;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::setVal(const Key &key, const Val &val) {
+	size_type ctr = lookupAndCreateIfMissing(key);
+	_slots[ctr]._value = val;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(iterator entry) {
+	// Check whether we have a valid iterator
+	assert(entry._hashmap == this);
+	const size_type ctr = entry._idx;
+	assert(ctr <= _mask);
+	assert(isUsed(_ctrl[ctr]));
+
+	// If we remove a key, we leave a marker behind so that probing
+	// for other keys continues past this slot.
+	_slots[ctr].~Node();
+	_ctrl[ctr] = kCtrlDeleted;
+	_size--;
+	_deleted++;
+}
+
+template<class Key, class Val, class HashFunc, class EqualFunc>
+void FlatHashMap<Key, Val, HashFunc, EqualFunc>::erase(const Key &key) {
+	size_type ctr = lookup(key);
+	if (ctr > _mask)
+		return;
+
+	_slots[ctr].~Node();
+	_ctrl[ctr] = kCtrlDeleted;
+	_size--;
+	_deleted++;
+}
+
+} // End of namespace Common
+
+#endif
@@ -213,6 +213,17 @@ public:
 	 */
 	bool isWritable() const;
 
+	/**
+	 * Retrieves the size and the last modification time of the file referred
+	 * by this node, without opening it. Not all backends support this.
+	 *
+	 * @param size		the size of the file in bytes
+	 * @param modTime	the modification time, in seconds since some backend
+	 *					specific epoch; only useful to detect changes
+	 * @return true if the information is available, false otherwise.
+	 */
+	bool getFileStatus(uint32 &size, uint32 &modTime) const;
+
 	/**
 	 * Creates a SeekableReadStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
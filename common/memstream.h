@@ -64,6 +64,17 @@ public:
 
 	uint32 read(void *dataPtr, uint32 dataSize);
 
+	const byte *getReadWindow(uint32 &size) {
+		size = _size - _pos;
+		return _ptr;
+	}
+
+	void consumeReadWindow(uint32 size) {
+		assert(size <= _size - _pos);
+		_ptr += size;
+		_pos += size;
+	}
+
 	bool eos() const { return _eos; }
 	void clearErr() { _eos = false; }
 
@@ -10,6 +10,7 @@ MODULE_OBJS := \
 	EventDispatcher.o \
 	EventMapper.o \
 	file.o \
+	fingerprint-cache.o \
 	fs.o \
 	gui_options.o \
 	hashmap.o \
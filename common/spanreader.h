@@ -0,0 +1,182 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#ifndef COMMON_SPANREADER_H
+#define COMMON_SPANREADER_H
+
+#include "common/stream.h"
+
+namespace Common {
+
+/**
+ * Fast sequential reader on top of a ReadStream.
+ *
+ * The read methods of ReadStream each go through the virtual read() call,
+ * which dominates the cost of decoders reading a byte or word at a time.
+ * SpanReader instead reads from the window a stream exposes through
+ * ReadStream::getReadWindow() with inlined, bounds checked accesses, and
+ * only calls into the stream again when the window is used up. Streams
+ * without a window (anything but MemoryReadStream and BufferedReadStream
+ * at the moment) still work, they are simply read through read().
+ *
+ * The position of the underlying stream only catches up with the reader
+ * in sync(), which is also done on destruction. So client code must call
+ * sync() before using the stream directly while a SpanReader is active.
+ */
+class SpanReader {
+public:
+	SpanReader(ReadStream &stream) : _stream(stream), _start(0), _cur(0), _end(0) {
+		refill();
+	}
+
+	~SpanReader() {
+		sync();
+	}
+
+	/** Advance the stream over everything read so far. */
+	void sync() {
+		_stream.consumeReadWindow(_cur - _start);
+		_start = _cur;
+	}
+
+	/**
+	 * Returns true if a read failed because the end of the stream was
+	 * reached, like ReadStream::eos().
+	 */
+	bool eos() const { return _cur == _end && _stream.eos(); }
+
+	bool err() const { return _stream.err(); }
+
+	byte readByte() {
+		if (_cur == _end && !refill())
+			return _stream.readByte();
+		return *_cur++;
+	}
+
+	int8 readSByte() {
+		return (int8)readByte();
+	}
+
+	uint16 readUint16LE() {
+		if (_end - _cur < 2) {
+			byte b = readByte();
+			return b | (readByte() << 8);
+		}
+		uint16 val = READ_LE_UINT16(_cur);
+		_cur += 2;
+		return val;
+	}
+
+	uint16 readUint16BE() {
+		if (_end - _cur < 2) {
+			byte b = readByte();
+			return (b << 8) | readByte();
+		}
+		uint16 val = READ_BE_UINT16(_cur);
+		_cur += 2;
+		return val;
+	}
+
+	uint32 readUint32LE() {
+		if (_end - _cur < 4) {
+			uint32 val = readUint16LE();
+			return val | ((uint32)readUint16LE() << 16);
+		}
+		uint32 val = READ_LE_UINT32(_cur);
+		_cur += 4;
+		return val;
+	}
+
+	uint32 readUint32BE() {
+		if (_end - _cur < 4) {
+			uint32 val = (uint32)readUint16BE() << 16;
+			return val | readUint16BE();
+		}
+		uint32 val = READ_BE_UINT32(_cur);
+		_cur += 4;
+		return val;
+	}
+
+	int16 readSint16LE() { return (int16)readUint16LE(); }
+	int16 readSint16BE() { return (int16)readUint16BE(); }
+	int32 readSint32LE() { return (int32)readUint32LE(); }
+	int32 readSint32BE() { return (int32)readUint32BE(); }
+
+	/**
+	 * Read data into a buffer, with the semantics of ReadStream::read().
+	 */
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		const uint32 avail = _end - _cur;
+		if (dataSize <= avail) {
+			memcpy(dataPtr, _cur, dataSize);
+			_cur += dataSize;
+			return dataSize;
+		}
+
+		memcpy(dataPtr, _cur, avail);
+		_cur = _end;
+		sync();
+		const uint32 n = _stream.read((byte *)dataPtr + avail, dataSize - avail);
+		refill();
+		return avail + n;
+	}
+
+	/**
+	 * Skip bytes. Returns false if the end of the stream was reached first.
+	 */
+	bool skip(uint32 offset) {
+		while (offset > (uint32)(_end - _cur)) {
+			offset -= _end - _cur;
+			_cur = _end;
+			if (!refill()) {
+				byte b;
+				while (offset--) {
+					if (_stream.read(&b, 1) != 1)
+						return false;
+				}
+				return true;
+			}
+		}
+		_cur += offset;
+		return true;
+	}
+
+private:
+	/** Fetch the next window. Returns false if the stream provides none. */
+	bool refill() {
+		sync();
+		uint32 size;
+		_start = _cur = _stream.getReadWindow(size);
+		_end = _cur + size;
+		return size != 0;
+	}
+
+	ReadStream &_stream;
+	const byte *_start; ///< Start of the part of the window not yet consumed in the stream
+	const byte *_cur;   ///< Read position within the window
+	const byte *_end;   ///< End of the window
+};
+
+} // End of namespace Common
+
+#endif
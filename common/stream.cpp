@@ -275,6 +275,9 @@ public:
 	virtual void clearErr() { _eos = false; _parentStream->clearErr(); }
 
 	virtual uint32 read(void *dataPtr, uint32 dataSize);
+
+	virtual const byte *getReadWindow(uint32 &size);
+	virtual void consumeReadWindow(uint32 size);
 };
 
 BufferedReadStream::BufferedReadStream(ReadStream *parentStream, uint32 bufSize, DisposeAfterUse::Flag disposeParentStream)
@@ -342,6 +345,22 @@ uint32 BufferedReadStream::read(void *dataPtr, uint32 dataSize) {
 	return alreadyRead + dataSize;
 }
 
+const byte *BufferedReadStream::getReadWindow(uint32 &size) {
+	// The window is the unread part of the buffer, refill it once it is used up
+	if (_pos == _bufSize && !_eos) {
+		_bufSize = _parentStream->read(_buf, _realBufSize);
+		_pos = 0;
+	}
+
+	size = _bufSize - _pos;
+	return _buf + _pos;
+}
+
+void BufferedReadStream::consumeReadWindow(uint32 size) {
+	assert(size <= _bufSize - _pos);
+	_pos += size;
+}
+
 } // End of anonymous namespace
 
 
@@ -223,6 +223,32 @@ public:
 	 */
 	virtual uint32 read(void *dataPtr, uint32 dataSize) = 0;
 
+	/**
+	 * Give direct access to the data following the current position, for
+	 * streams which have it in memory anyway. The position is not changed,
+	 * use consumeReadWindow() to advance over (part of) the window. The
+	 * window is only valid until the next call of any other method.
+	 *
+	 * Streams which cannot provide such a window return no data, which is
+	 * the default. Client code normally uses this through SpanReader.
+	 *
+	 * @param size	set to the number of bytes available at the returned pointer
+	 * @return a pointer to the data at the current position
+	 */
+	virtual const byte *getReadWindow(uint32 &size) {
+		size = 0;
+		return 0;
+	}
+
+	/**
+	 * Advance the position over data obtained with getReadWindow().
+	 *
+	 * @param size	number of bytes of the window which were used
+	 */
+	virtual void consumeReadWindow(uint32 size) {
+		assert(size == 0);
+	}
+
 
 	// The remaining methods all have default implementations; subclasses
 	// in general should not overload them.
@@ -106,6 +106,8 @@ typedef struct {
 #include "common/fs.h"
 #include "common/unzip.h"
 #include "common/memstream.h"
+#include "common/substream.h"
+#include "common/array.h"
 
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -1419,12 +1421,278 @@ int unzGetGlobalComment(unzFile file, char *szComment, uLong uSizeBuf) {
 
 namespace Common {
 
+enum {
+	// Larger members are streamed from their own handle to the archive
+	kMaxMemoryMemberSize = 256 * 1024
+};
+
+/**
+ * Checks the CRC-32 of a streamed member. Only the data which continues the
+ * part checked so far counts, so data read again after a seek back is not
+ * added twice. The check is done once the end of the member was reached.
+ */
+class ZipMemberCRC {
+	const uint32 _expected;
+	const uint32 _size;
+	uint32 _value;
+	uint32 _checked;
+
+public:
+	ZipMemberCRC(uint32 expected, uint32 size) : _expected(expected), _size(size), _value(0), _checked(0) {}
+
+	/** Adds len bytes read at pos, returns false if the member turned out to be corrupt */
+	bool update(uint32 pos, const byte *data, uint32 len) {
+#ifdef USE_ZLIB
+		if (pos <= _checked && pos + len > _checked) {
+			const uint32 skip = _checked - pos;
+			_value = crc32(_value, data + skip, len - skip);
+			_checked = pos + len;
+			if (_checked == _size && _value != _expected)
+				return false;
+		}
+#endif
+		return true;
+	}
+};
+
+/**
+ * A large stored (uncompressed) archive member, read from its own stream of
+ * the archive file, so it does not disturb other members of the archive or
+ * depend on the thread they are read from.
+ */
+class ZipStoredStream : public SeekableSubReadStream {
+	ZipMemberCRC _crc;
+	bool _crcError;
+
+public:
+	ZipStoredStream(SeekableReadStream *archive, uint32 begin, uint32 size, uint32 crc)
+		: SeekableSubReadStream(archive, begin, begin + size, DisposeAfterUse::YES), _crc(crc, size), _crcError(false) {
+	}
+
+	bool err() const { return _crcError || SeekableSubReadStream::err(); }
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		const uint32 start = pos();
+		const uint32 done = SeekableSubReadStream::read(dataPtr, dataSize);
+		if (!_crc.update(start, (const byte *)dataPtr, done)) {
+			warning("ZipStoredStream: CRC mismatch");
+			_crcError = true;
+		}
+		return done;
+	}
+};
+
+#ifdef USE_ZLIB
+
+/**
+ * A large deflated archive member, inflated on the fly with its own zlib
+ * state from its own stream of the archive file.
+ *
+ * Forward seeks inflate and discard. To make backward seeks cheap, a copy of
+ * the inflate state is kept every kCheckpointInterval bytes of output, and a
+ * seek resumes from the closest checkpoint before the target instead of
+ * starting over.
+ */
+class ZipInflateStream : public SeekableReadStream {
+	enum {
+		kBufferSize = UNZ_BUFSIZE,
+		kCheckpointInterval = 1024 * 1024
+	};
+
+	struct Checkpoint {
+		uint32 pos;
+		z_stream *state;
+	};
+
+	SeekableReadStream *_archive;
+	const uint32 _dataStart;
+	const uint32 _compressedSize;
+	const uint32 _size;
+	ZipMemberCRC _crc;
+
+	z_stream _stream;
+	int _zlibErr;
+	byte *_buf;
+	uint32 _pos;
+	bool _eos;
+	Array<Checkpoint> _checkpoints;
+
+	/** Inflate up to len bytes into dst, or discard them if dst is 0 */
+	uint32 inflateTo(byte *dst, uint32 len) {
+		byte skipBuf[512];
+		uint32 done = 0;
+
+		while (done < len && _zlibErr == Z_OK) {
+			if (_stream.avail_in == 0) {
+				const uint32 consumed = _stream.total_in;
+				if (consumed >= _compressedSize)
+					break;
+				_archive->seek(_dataStart + consumed, SEEK_SET);
+				const uint32 n = _archive->read(_buf, MIN<uint32>(kBufferSize, _compressedSize - consumed));
+				if (n == 0) {
+					_zlibErr = Z_DATA_ERROR;
+					break;
+				}
+				_stream.next_in = _buf;
+				_stream.avail_in = n;
+			}
+
+			// Stop at the next checkpoint position, so the state there can be saved
+			uint32 chunk = len - done;
+			const uint32 nextCheckpoint = (_checkpoints.size() + 1) * kCheckpointInterval;
+			if (_pos < nextCheckpoint)
+				chunk = MIN(chunk, nextCheckpoint - _pos);
+			if (!dst)
+				chunk = MIN<uint32>(chunk, sizeof(skipBuf));
+
+			byte *out = dst ? dst + done : skipBuf;
+			_stream.next_out = out;
+			_stream.avail_out = chunk;
+			_zlibErr = inflate(&_stream, Z_SYNC_FLUSH);
+			const uint32 produced = chunk - _stream.avail_out;
+
+			if (!_crc.update(_pos, out, produced)) {
+				warning("ZipInflateStream: CRC mismatch");
+				_zlibErr = Z_DATA_ERROR;
+			}
+			done += produced;
+			_pos += produced;
+
+			// Z_BUF_ERROR only means that more input is needed
+			if (_zlibErr == Z_BUF_ERROR)
+				_zlibErr = Z_OK;
+			else if (_zlibErr == Z_STREAM_END)
+				break;
+
+			if (_pos == nextCheckpoint && _pos < _size)
+				addCheckpoint();
+		}
+
+		return done;
+	}
+
+	void addCheckpoint() {
+		Checkpoint checkpoint;
+		checkpoint.pos = _pos;
+		checkpoint.state = new z_stream;
+		if (inflateCopy(checkpoint.state, &_stream) != Z_OK) {
+			delete checkpoint.state;
+			return;
+		}
+		_checkpoints.push_back(checkpoint);
+	}
+
+	void restart(const Checkpoint *checkpoint) {
+		inflateEnd(&_stream);
+		if (checkpoint) {
+			_zlibErr = inflateCopy(&_stream, checkpoint->state);
+			_pos = checkpoint->pos;
+		} else {
+			_stream.zalloc = Z_NULL;
+			_stream.zfree = Z_NULL;
+			_stream.opaque = Z_NULL;
+			_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+			_pos = 0;
+		}
+		// The copied state may point into an older buffer, so refill
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+	}
+
+public:
+	ZipInflateStream(SeekableReadStream *archive, uint32 dataStart, uint32 compressedSize, uint32 size, uint32 crc)
+		: _archive(archive), _dataStart(dataStart), _compressedSize(compressedSize), _size(size), _crc(crc, size), _stream(), _pos(0), _eos(false) {
+		_buf = new byte[kBufferSize];
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		// windowBits < 0 since zip members carry no zlib header
+		_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+	}
+
+	~ZipInflateStream() {
+		inflateEnd(&_stream);
+		for (uint i = 0; i < _checkpoints.size(); ++i) {
+			inflateEnd(_checkpoints[i].state);
+			delete _checkpoints[i].state;
+		}
+		delete[] _buf;
+		delete _archive;
+	}
+
+	bool err() const { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
+	void clearErr() {
+		// only reset _eos; I/O errors are not recoverable
+		_eos = false;
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		if (dataSize > _size - _pos) {
+			dataSize = _size - _pos;
+			_eos = true;
+		}
+		const uint32 done = inflateTo((byte *)dataPtr, dataSize);
+		if (done < dataSize)
+			_eos = true;
+		return done;
+	}
+
+	bool eos() const { return _eos; }
+	int32 pos() const { return _pos; }
+	int32 size() const { return _size; }
+
+	bool seek(int32 offset, int whence = SEEK_SET) {
+		int32 newPos = 0;
+		switch (whence) {
+		default:
+			// fallthrough intended
+		case SEEK_SET:
+			newPos = offset;
+			break;
+		case SEEK_CUR:
+			newPos = _pos + offset;
+			break;
+		case SEEK_END:
+			newPos = _size + offset;
+			break;
+		}
+
+		if (newPos < 0 || (uint32)newPos > _size)
+			return false;
+
+		const uint32 target = newPos;
+
+		// Resume from the closest checkpoint when going back, or when it
+		// lets us skip inflating a long stretch going forward
+		const Checkpoint *checkpoint = 0;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].pos <= target; ++i)
+			checkpoint = &_checkpoints[i];
+
+		if (target < _pos)
+			restart(checkpoint);
+		else if (checkpoint && checkpoint->pos > _pos)
+			restart(checkpoint);
+
+		if (target > _pos)
+			inflateTo(0, target - _pos);
+
+		_eos = false;
+		return _pos == target && !err();
+	}
+};
+
+#endif
 
 class ZipArchive : public Archive {
 	unzFile _zipFile;
+	// Where to open the archive file again for streamed members
+	FSNode _node;
+	String _name;
+
+	SeekableReadStream *openArchiveStream() const;
+	SeekableReadStream *createStreamForLargeMember() const;
 
 public:
-	ZipArchive(unzFile zipFile);
+	ZipArchive(unzFile zipFile, const FSNode &node, const String &name);
 
 
 	~ZipArchive();
@@ -1453,7 +1721,7 @@ public:
 };
 */
 
-ZipArchive::ZipArchive(unzFile zipFile) : _zipFile(zipFile) {
+ZipArchive::ZipArchive(unzFile zipFile, const FSNode &node, const String &name) : _zipFile(zipFile), _node(node), _name(name) {
 	assert(_zipFile);
 }
 
@@ -1485,15 +1753,69 @@ const ArchiveMemberPtr ZipArchive::getMember(const String &name) const {
 	return ArchiveMemberPtr(new GenericArchiveMember(name, this));
 }
 
+SeekableReadStream *ZipArchive::openArchiveStream() const {
+	if (!_name.empty())
+		return SearchMan.createReadStreamForMember(_name);
+	if (_node.exists())
+		return _node.createReadStream();
+	return 0;
+}
+
+SeekableReadStream *ZipArchive::createStreamForLargeMember() const {
+	unz_s *s = (unz_s *)_zipFile;
+	const unz_file_info &fileInfo = s->cur_file_info;
+	if (fileInfo.compression_method != 0) {
+#ifdef USE_ZLIB
+		if (fileInfo.compression_method != Z_DEFLATED)
+#endif
+			return 0;
+	}
+
+	uInt iSizeVar;
+	uLong offsetLocalExtrafield;
+	uInt sizeLocalExtrafield;
+	if (unzlocal_CheckCurrentFileCoherencyHeader(s, &iSizeVar, &offsetLocalExtrafield, &sizeLocalExtrafield) != UNZ_OK)
+		return 0;
+
+	SeekableReadStream *archive = openArchiveStream();
+	if (!archive)
+		return 0;
+
+	const uint32 dataStart = s->cur_file_info_internal.offset_curfile + SIZEZIPLOCALHEADER + iSizeVar + s->byte_before_the_zipfile;
+	if (fileInfo.compression_method == 0)
+		return new ZipStoredStream(archive, dataStart, fileInfo.uncompressed_size, fileInfo.crc);
+
+#ifdef USE_ZLIB
+	ZipInflateStream *stream = new ZipInflateStream(archive, dataStart, fileInfo.compressed_size, fileInfo.uncompressed_size, fileInfo.crc);
+	if (stream->err()) {
+		delete stream;
+		return 0;
+	}
+	return stream;
+#else
+	return 0;
+#endif
+}
+
 SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) const {
 	if (unzLocateFile(_zipFile, name.c_str(), 2) != UNZ_OK)
 		return 0;
 
 	unz_file_info fileInfo;
-	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
+	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
 		return 0;
 
-	if (unzGetCurrentFileInfo(_zipFile, &fileInfo, NULL, 0, NULL, 0, NULL, 0) != UNZ_OK)
+	// Large members are streamed, if the archive file can be opened again.
+	// All streams of the same archive share one read position, so a member
+	// stream which reads from the archive stream of the ZipArchive could
+	// not be used alongside other members, or from another thread.
+	if (fileInfo.uncompressed_size > kMaxMemoryMemberSize) {
+		SeekableReadStream *stream = createStreamForLargeMember();
+		if (stream)
+			return stream;
+	}
+
+	if (unzOpenCurrentFile(_zipFile) != UNZ_OK)
 		return 0;
 
 	byte *buffer = (byte *)malloc(fileInfo.uncompressed_size);
@@ -1510,22 +1832,9 @@ SeekableReadStream *ZipArchive::createReadStreamForMember(const String &name) co
 	}
 
 	return new MemoryReadStream(buffer, fileInfo.uncompressed_size, DisposeAfterUse::YES);
-
-	// FIXME: instead of reading all into a memory stream, we could
-	// instead create a new ZipStream class. But then we have to be
-	// careful to handle the case where the client code opens multiple
-	// files in the archive and tries to use them independently.
-}
-
-Archive *makeZipArchive(const String &name) {
-	return makeZipArchive(SearchMan.createReadStreamForMember(name));
 }
 
-Archive *makeZipArchive(const FSNode &node) {
-	return makeZipArchive(node.createReadStream());
-}
-
-Archive *makeZipArchive(SeekableReadStream *stream) {
+static Archive *makeZipArchive(SeekableReadStream *stream, const FSNode &node, const String &name) {
 	if (!stream)
 		return 0;
 	unzFile zipFile = unzOpen(stream);
@@ -1534,7 +1843,19 @@ Archive *makeZipArchive(SeekableReadStream *stream) {
 		// goes wrong.
 		return 0;
 	}
-	return new ZipArchive(zipFile);
+	return new ZipArchive(zipFile, node, name);
+}
+
+Archive *makeZipArchive(const String &name) {
+	return makeZipArchive(SearchMan.createReadStreamForMember(name), FSNode(), name);
+}
+
+Archive *makeZipArchive(const FSNode &node) {
+	return makeZipArchive(node.createReadStream(), node, String());
+}
+
+Archive *makeZipArchive(SeekableReadStream *stream) {
+	return makeZipArchive(stream, FSNode(), String());
 }
 
 } // End of namespace Common
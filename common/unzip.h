@@ -52,6 +52,8 @@ Archive *makeZipArchive(const FSNode &node);
  * of the given ZIP compressed datastream.
  * This takes ownership of the stream,  in particular, it is deleted when the
  * ZipArchive is deleted.
+ * Since the archive cannot be opened again, all its members are read into
+ * memory, while the other two factories stream the large ones.
  *
  * May return 0 in case of a failure. In this case stream will still be deleted.
  */
@@ -27,6 +27,8 @@
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
+#include "common/substream.h"
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/textconsole.h"
 
@@ -145,15 +147,36 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
 static bool _shownBackwardSeekingWarning = false;
 #endif
 
+enum {
+	kGZipIndexVersion = 2
+};
+
 /**
  * A simple wrapper class which can be used to wrap around an arbitrary
  * other SeekableReadStream and will then provide on-the-fly decompression support.
  * Assumes the compressed data to be in gzip format.
+ *
+ * Forward seeks inflate and discard. To make other seeks cheap, a checkpoint
+ * is kept about every kCheckpointInterval bytes of output while reading, at
+ * the end of a deflate block: the position of the next compressed bit and
+ * the last 32 KiB of output, which is all the state inflate needs to resume
+ * there. A seek resumes from the closest checkpoint before the target
+ * instead of starting over. The checkpoints can be saved to an index, so
+ * the next stream over the same data does not have to build them again.
  */
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,		// 1 << MAX_WBITS
+		kWindowSize = 32768,
+		kCheckpointInterval = 1024 * 1024
+	};
+
+	struct Checkpoint {
+		uint32 pos;		///< position in the decompressed data
+		uint32 in;		///< position of the next compressed byte in the wrapped stream
+		byte bits;		///< number of bits of the byte before 'in' which are not inflated yet
+		byte *window;	///< the kWindowSize bytes of output before pos
 	};
 
 	byte	_buf[BUFSIZE];
@@ -164,10 +187,100 @@ protected:
 	uint32 _pos;
 	uint32 _origSize;
 	bool _eos;
+	byte _trailer[8];		///< the last bytes of the wrapped stream
+
+	Array<Checkpoint> _checkpoints;
+	byte *_window;			///< ring buffer with the latest output, for the next checkpoint
+	uint32 _windowHead;		///< where the next output goes in _window
+	uint32 _windowFill;		///< valid bytes in _window
+	uint32 _windowEnd;		///< position after the last output in _window
+
+	uint32 nextCheckpointPos() const {
+		const uint32 interval = kCheckpointInterval;
+		return _checkpoints.empty() ? interval : _checkpoints.back().pos + interval;
+	}
+
+	/** Keep the output of the last inflate() call, if it is close to the next checkpoint */
+	void updateWindow(const byte *data, uint32 len) {
+		const uint32 end = _pos + len;
+		if (end + kWindowSize <= nextCheckpointPos())
+			return;
+
+		if (!_window)
+			_window = new byte[kWindowSize];
+		if (_windowEnd != _pos)
+			_windowFill = 0;
+
+		if (len > kWindowSize) {
+			data += len - kWindowSize;
+			len = kWindowSize;
+		}
+		const uint32 first = MIN<uint32>(len, kWindowSize - _windowHead);
+		memcpy(_window + _windowHead, data, first);
+		memcpy(_window, data + first, len - first);
+		_windowHead = (_windowHead + len) % kWindowSize;
+		_windowFill = MIN<uint32>(_windowFill + len, kWindowSize);
+		_windowEnd = end;
+	}
+
+	void addCheckpoint() {
+		if (_windowFill < kWindowSize || _windowEnd != _pos)
+			return;
+
+		Checkpoint checkpoint;
+		checkpoint.pos = _pos;
+		checkpoint.in = _wrapped->pos() - _stream.avail_in;
+		checkpoint.bits = _stream.data_type & 7;
+		checkpoint.window = new byte[kWindowSize];
+		memcpy(checkpoint.window, _window + _windowHead, kWindowSize - _windowHead);
+		memcpy(checkpoint.window + kWindowSize - _windowHead, _window, _windowHead);
+		_checkpoints.push_back(checkpoint);
+	}
+
+	/** Restart inflating at a checkpoint, or at the start of the data if checkpoint is 0 */
+	bool restart(const Checkpoint *checkpoint) {
+		inflateEnd(&_stream);
+		_stream.zalloc = Z_NULL;
+		_stream.zfree = Z_NULL;
+		_stream.opaque = Z_NULL;
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_eos = false;
+
+		if (!checkpoint) {
+			_pos = 0;
+			_wrapped->seek(0, SEEK_SET);
+			_zlibErr = inflateInit2(&_stream, MAX_WBITS + 32);
+		} else {
+			// Checkpoints are in the middle of the deflate data, past any header
+			_pos = checkpoint->pos;
+			_zlibErr = inflateInit2(&_stream, -MAX_WBITS);
+			if (_zlibErr == Z_OK && checkpoint->bits) {
+				_wrapped->seek(checkpoint->in - 1, SEEK_SET);
+				const byte partial = _wrapped->readByte();
+				_zlibErr = inflatePrime(&_stream, checkpoint->bits, partial >> (8 - checkpoint->bits));
+			} else {
+				_wrapped->seek(checkpoint->in, SEEK_SET);
+			}
+			if (_zlibErr == Z_OK)
+				_zlibErr = inflateSetDictionary(&_stream, checkpoint->window, kWindowSize);
+		}
+
+		_windowFill = 0;
+		_windowEnd = _pos;
+		return _zlibErr == Z_OK && !_wrapped->err();
+	}
+
+	void clearCheckpoints() {
+		for (uint i = 0; i < _checkpoints.size(); ++i)
+			delete[] _checkpoints[i].window;
+		_checkpoints.clear();
+	}
 
 public:
 
-	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
+	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream(),
+		_window(0), _windowHead(0), _windowFill(0), _windowEnd(0) {
 		assert(w != 0);
 
 		// Verify file header is correct
@@ -176,10 +289,18 @@ public:
 		assert(header == 0x1F8B ||
 		       ((header & 0x0F00) == 0x0800 && header % 31 == 0));
 
+		// The trailer holds a checksum of all data: the CRC-32 and size in
+		// gzip format, the Adler-32 in zlib format. A seek index is only
+		// used for data with the same trailer.
+		memset(_trailer, 0, sizeof(_trailer));
+		if (w->size() >= (int32)sizeof(_trailer)) {
+			w->seek(-(int32)sizeof(_trailer), SEEK_END);
+			w->read(_trailer, sizeof(_trailer));
+		}
+
 		if (header == 0x1F8B) {
 			// Retrieve the original file size
-			w->seek(-4, SEEK_END);
-			_origSize = w->readUint32LE();
+			_origSize = READ_LE_UINT32(_trailer + 4);
 		} else {
 			// Original size not available in zlib format
 			// use an otherwise known size if supplied.
@@ -205,6 +326,8 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+		clearCheckpoints();
+		delete[] _window;
 	}
 
 	bool err() const { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -214,26 +337,40 @@ public:
 	}
 
 	uint32 read(void *dataPtr, uint32 dataSize) {
-		_stream.next_out = (byte *)dataPtr;
-		_stream.avail_out = dataSize;
+		byte *dst = (byte *)dataPtr;
+		uint32 done = 0;
 
 		// Keep going while we get no error
-		while (_zlibErr == Z_OK && _stream.avail_out) {
+		while (_zlibErr == Z_OK && done < dataSize) {
 			if (_stream.avail_in == 0 && !_wrapped->eos()) {
 				// If we are out of input data: Read more data, if available.
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
-			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
-		}
 
-		// Update the position counter
-		_pos += dataSize - _stream.avail_out;
+			// Past the next checkpoint position, stop at the end of each
+			// block until one can be added
+			const bool wantCheckpoint = _pos >= nextCheckpointPos();
+
+			_stream.next_out = dst + done;
+			_stream.avail_out = dataSize - done;
+			_zlibErr = inflate(&_stream, wantCheckpoint ? Z_BLOCK : Z_NO_FLUSH);
+
+			// Update the position counter
+			const uint32 produced = dataSize - done - _stream.avail_out;
+			updateWindow(dst + done, produced);
+			done += produced;
+			_pos += produced;
+
+			// Bit 7 of data_type is set at the end of a block, bit 6 if it was the last one
+			if (wantCheckpoint && _zlibErr == Z_OK && (_stream.data_type & 0xC0) == 0x80)
+				addCheckpoint();
+		}
 
-		if (_zlibErr == Z_STREAM_END && _stream.avail_out > 0)
+		if (_zlibErr == Z_STREAM_END && done < dataSize)
 			_eos = true;
 
-		return dataSize - _stream.avail_out;
+		return done;
 	}
 
 	bool eos() const {
@@ -255,17 +392,23 @@ public:
 			newPos = _pos + offset;
 			break;
 		case SEEK_END:
-			// NOTE: This can be an expensive operation (see below).
+			// NOTE: This can be an expensive operation the first time,
+			// before there are checkpoints near the end (see below).
 			newPos = size() + offset;
 			break;
 		}
 
 		assert(newPos >= 0);
 
-		if ((uint32)newPos < _pos) {
-			// To search backward, we have to restart the whole decompression
-			// from the start of the file. A rather wasteful operation, best
-			// to avoid it. :/
+		// Resume from the closest checkpoint when going back, or when it
+		// lets us skip inflating a long stretch going forward
+		const Checkpoint *checkpoint = 0;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i].pos <= (uint32)newPos; ++i)
+			checkpoint = &_checkpoints[i];
+
+		if ((uint32)newPos < _pos && !checkpoint) {
+			// To search backward before the first checkpoint, we have to
+			// restart the whole decompression from the start of the file.
 
 #ifndef RELEASE_BUILD
 			if (!_shownBackwardSeekingWarning) {
@@ -277,21 +420,18 @@ public:
 			}
 #endif
 
-			_pos = 0;
-			_wrapped->seek(0, SEEK_SET);
-			_zlibErr = inflateReset(&_stream);
-			if (_zlibErr != Z_OK)
+			if (!restart(0))
+				return false;	// FIXME: STREAM REWRITE
+		} else if ((uint32)newPos < _pos || (checkpoint && checkpoint->pos > _pos)) {
+			if (!restart(checkpoint))
 				return false;	// FIXME: STREAM REWRITE
-			_stream.next_in = _buf;
-			_stream.avail_in = 0;
 		}
 
 		offset = newPos - _pos;
 
-		// Skip the given amount of data (very inefficient if one tries to skip
-		// huge amounts of data, but usually client code will only skip a few
-		// bytes, so this should be fine.
-		byte tmpBuf[1024];
+		// Skip the given amount of data, which is at most about one
+		// checkpoint interval once the stream has been read that far.
+		byte tmpBuf[4096];
 		while (!err() && offset > 0) {
 			offset -= read(tmpBuf, MIN((int32)sizeof(tmpBuf), offset));
 		}
@@ -299,6 +439,76 @@ public:
 		_eos = false;
 		return true;	// FIXME: STREAM REWRITE
 	}
+
+	/**
+	 * Inflate the rest of the data, so there are checkpoints all over it.
+	 * @return false if the data is broken
+	 */
+	bool addAllCheckpoints() {
+		byte tmpBuf[4096];
+		while (!err() && !eos())
+			read(tmpBuf, sizeof(tmpBuf));
+		return !err();
+	}
+
+	/** Write the checkpoints to an index, see writeCompressedStreamIndex */
+	void saveIndex(WriteStream &index) const {
+		index.writeUint32BE(MKTAG('G', 'Z', 'I', 'X'));
+		index.writeUint32LE(kGZipIndexVersion);
+		index.writeUint32LE(_wrapped->size());
+		index.write(_trailer, sizeof(_trailer));
+		index.writeUint32LE(kCheckpointInterval);
+		index.writeUint32LE(_checkpoints.size());
+		for (uint i = 0; i < _checkpoints.size(); ++i) {
+			index.writeUint32LE(_checkpoints[i].pos);
+			index.writeUint32LE(_checkpoints[i].in);
+			index.writeByte(_checkpoints[i].bits);
+			index.write(_checkpoints[i].window, kWindowSize);
+		}
+	}
+
+	/**
+	 * Replace the checkpoints with those of an index.
+	 * @return false if the index is broken or was made for other data
+	 */
+	bool loadIndex(SeekableReadStream &index) {
+		if (index.readUint32BE() != MKTAG('G', 'Z', 'I', 'X') || index.readUint32LE() != kGZipIndexVersion)
+			return false;
+		if (index.readUint32LE() != (uint32)_wrapped->size())
+			return false;
+		byte trailer[sizeof(_trailer)];
+		if (index.read(trailer, sizeof(trailer)) != sizeof(trailer) || memcmp(trailer, _trailer, sizeof(trailer)))
+			return false;
+		if (index.readUint32LE() != kCheckpointInterval)
+			return false;
+
+		const uint32 count = index.readUint32LE();
+		Array<Checkpoint> checkpoints;
+		bool valid = !index.err() && !index.eos();
+		for (uint32 i = 0; valid && i < count; ++i) {
+			Checkpoint checkpoint;
+			checkpoint.pos = index.readUint32LE();
+			checkpoint.in = index.readUint32LE();
+			checkpoint.bits = index.readByte();
+			checkpoint.window = new byte[kWindowSize];
+			checkpoints.push_back(checkpoint);
+
+			valid = index.read(checkpoint.window, kWindowSize) == kWindowSize && checkpoint.bits < 8 &&
+			        checkpoint.in > 0 && checkpoint.in <= (uint32)_wrapped->size() &&
+			        (i == 0 ? checkpoint.pos > 0 : checkpoint.pos > checkpoints[i - 1].pos);
+		}
+
+		if (!valid) {
+			for (uint i = 0; i < checkpoints.size(); ++i)
+				delete[] checkpoints[i].window;
+			return false;
+		}
+
+		// The stream position is kept, it may be past some new checkpoints
+		clearCheckpoints();
+		_checkpoints = checkpoints;
+		return true;
+	}
 };
 
 /**
@@ -413,16 +623,23 @@ public:
 
 #endif	// USE_ZLIB
 
-SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize) {
+static bool isCompressedStream(SeekableReadStream *stream) {
+	uint16 header = stream->readUint16BE();
+	bool isCompressed = (header == 0x1F8B ||
+			     ((header & 0x0F00) == 0x0800 &&
+			      header % 31 == 0));
+	stream->seek(-2, SEEK_CUR);
+	return isCompressed;
+}
+
+SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize, SeekableReadStream *index) {
 	if (toBeWrapped) {
-		uint16 header = toBeWrapped->readUint16BE();
-		bool isCompressed = (header == 0x1F8B ||
-				     ((header & 0x0F00) == 0x0800 &&
-				      header % 31 == 0));
-		toBeWrapped->seek(-2, SEEK_CUR);
-		if (isCompressed) {
+		if (isCompressedStream(toBeWrapped)) {
 #if defined(USE_ZLIB)
-			return new GZipReadStream(toBeWrapped, knownSize);
+			GZipReadStream *stream = new GZipReadStream(toBeWrapped, knownSize);
+			if (index && !stream->loadIndex(*index))
+				warning("wrapCompressedReadStream: Ignoring an index which does not match the data");
+			return stream;
 #else
 			delete toBeWrapped;
 			return NULL;
@@ -432,6 +649,22 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 	return toBeWrapped;
 }
 
+bool writeCompressedStreamIndex(SeekableReadStream *compressed, WriteStream *index) {
+#if defined(USE_ZLIB)
+	if (!compressed || !index || !isCompressedStream(compressed))
+		return false;
+
+	GZipReadStream stream(new SeekableSubReadStream(compressed, 0, compressed->size()));
+	if (!stream.addAllCheckpoints())
+		return false;
+
+	stream.saveIndex(*index);
+	return !index->err();
+#else
+	return false;
+#endif
+}
+
 WriteStream *wrapCompressedWriteStream(WriteStream *toBeWrapped) {
 #if defined(USE_ZLIB)
 	if (toBeWrapped)
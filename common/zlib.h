@@ -115,10 +115,29 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
  *
+ * Seeking back, or far ahead, resumes inflating at the closest checkpoint
+ * kept while reading. An index written by writeCompressedStreamIndex() for
+ * the same data provides all checkpoints up front. It is read right away
+ * and not deleted; an index which does not match the data is ignored.
+ *
  * @param toBeWrapped	the stream to be wrapped (if it is in gzip-format)
  * @param knownSize		a supplied length of the compressed data (if not available directly)
+ * @param index			an optional seek index for the compressed data
+ */
+SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0, SeekableReadStream *index = 0);
+
+/**
+ * Inflate gzip or zlib compressed data once, and write an index of seek
+ * checkpoints for it, about one per MiB of decompressed data at 32 KiB
+ * each. Only worth it for large files which are read at random positions
+ * more than once.
+ *
+ * @param compressed	the compressed data, which is not deleted
+ * @param index			the stream to write the index to
+ * @return true on success, false if the data is not compressed, broken,
+ *         or there is no ZLIB support
  */
-SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0);
+bool writeCompressedStreamIndex(SeekableReadStream *compressed, WriteStream *index);
 
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which provides
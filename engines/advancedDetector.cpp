@@ -23,6 +23,7 @@
 #include "common/debug.h"
 #include "common/util.h"
 #include "common/file.h"
+#include "common/fingerprint-cache.h"
 #include "common/macresman.h"
 #include "common/md5.h"
 #include "common/config-manager.h"
@@ -403,14 +404,9 @@ bool AdvancedMetaEngine::getFileProperties(const Common::FSNode &parent, const F
 	if (!allFiles.contains(fname))
 		return false;
 
-	Common::File testFile;
-
-	if (!testFile.open(allFiles[fname]))
-		return false;
-
-	fileProps.size = (int32)testFile.size();
-	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
-	return true;
+	// Several engines usually look at the same files, so share the
+	// fingerprints between them and between runs.
+	return FingerprintMan.getFingerprint(allFiles[fname], _md5Bytes, fileProps.md5, fileProps.size);
 }
 
 ADGameDescList AdvancedMetaEngine::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra) const {
@@ -54,10 +54,14 @@ namespace Director {
 void Lingo::execute(int pc) {
 	for(_pc = pc; (*_currentScript)[_pc] != STOP && !_returning;) {
 
-		for (uint i = 0; i < _stack.size(); i++) {
-			debugN(5, "%d ", _stack[i].u.i);
+		// Only dump the stack when it is shown, this loop runs for
+		// every instruction
+		if (gDebugLevel >= 5) {
+			for (uint i = 0; i < _stack.size(); i++) {
+				debugN(5, "%d ", _stack[i].u.i);
+			}
+			debug(5, "%s", "");
 		}
-		debug(5, "%s", "");
 
 		_pc++;
 		(*((*_currentScript)[_pc - 1]))();
@@ -88,7 +92,10 @@ Symbol *Lingo::lookupVar(const char *name, bool create, bool putInGlobalList) {
 		}
 	}
 
-	if (!_localvars->contains(name)) { // Create variable if it was not defined
+	// A single lookup, this runs for every variable access
+	SymbolHash::iterator var = _localvars->find(name);
+
+	if (var == _localvars->end()) { // Create variable if it was not defined
 		if (!create)
 			return NULL;
 
@@ -105,7 +112,7 @@ Symbol *Lingo::lookupVar(const char *name, bool create, bool putInGlobalList) {
 			_globalvars[name] = sym;
 		}
 	} else {
-		sym = (*_localvars)[name];
+		sym = var->_value;
 
 		if (sym->global)
 			sym = _globalvars[name];
@@ -148,6 +155,8 @@ void Lingo::define(Common::String &name, int start, int nargs, Common::String *p
 
 	sym->u.defn = new ScriptData(&(*_currentScript)[start], _currentScript->size() - start + 1);
 	sym->nargs = nargs;
+
+	optimizeScript(sym->u.defn);
 }
 
 int Lingo::codeString(const char *str) {
@@ -284,4 +293,241 @@ void Lingo::codeFactory(Common::String &name) {
 	_handlers[name] = sym;
 }
 
+/** A constant pushed by the code emitted by optimizeScript() */
+struct FoldedConstant {
+	uint outPos;	///< where it starts in the new code
+	uint pc;		///< where it started in the old code
+	Datum value;
+};
+
+int Lingo::instructionLength(const ScriptData &script, uint pc) {
+	inst op = script[pc];
+	int length = 1;
+	bool hasString = false;
+
+	if (op == c_constpush) {
+		length = 2;
+	} else if (op == c_fconstpush) {
+		length = 1 + calcCodeAlignment(sizeof(double));
+	} else if (op == c_stringpush || op == c_varpush || op == c_eval || op == c_global) {
+		hasString = true;
+	} else if (op == c_theentitypush || op == c_theentityassign) {
+		length = 3;
+	} else if (op == c_repeatwhilecode) {
+		length = 3;
+	} else if (op == c_ifcode) {
+		length = 5;
+	} else if (op == c_repeatwithcode) {
+		length = 6;
+		hasString = true;
+	} else if (op == c_call) {
+		hasString = true;
+	}
+
+	if (pc + length > script.size())
+		return -1;
+
+	if (hasString) {
+		const char *s = (const char *)&script[pc + length];
+		const void *end = memchr(s, 0, (script.size() - pc - length) * sizeof(inst));
+		if (!end)
+			return -1;
+
+		length += calcCodeAlignment((const char *)end - s + 1);
+
+		// The number of arguments
+		if (op == c_call)
+			length++;
+
+		if (pc + length > script.size())
+			return -1;
+	}
+
+	return length;
+}
+
+bool Lingo::isFoldable(inst op, int &numArgs) {
+	numArgs = 2;
+
+	if (op == c_negate || op == c_not) {
+		numArgs = 1;
+		return true;
+	}
+
+	return op == c_add || op == c_sub || op == c_mul || op == c_div ||
+		op == c_eq || op == c_neq || op == c_gt || op == c_lt || op == c_ge || op == c_le ||
+		op == c_and || op == c_or;
+}
+
+bool Lingo::foldConstants(inst op, int numArgs, Datum &result) {
+	// Division by zero is an error, which has to happen when the script runs
+	if (op == c_div && ((_stack.back().type == INT && _stack.back().u.i == 0) ||
+			(_stack.back().type == FLOAT && _stack.back().u.f == 0.0))) {
+		for (int i = 0; i < numArgs; i++)
+			pop();
+		return false;
+	}
+
+	// The operations on numbers only use the stack, so running them
+	// now gives exactly what they would give later
+	(*op)();
+	result = pop();
+
+	return result.type == INT || result.type == FLOAT;
+}
+
+/**
+ * Rewrite a compiled script to compute the operations on constants once,
+ * here, instead of every time the script runs.
+ *
+ * Nothing which is the target of a jump is merged with the instructions
+ * before it, and the targets are moved along with the code. Scripts which
+ * can not be decoded are kept as they are.
+ */
+void Lingo::optimizeScript(ScriptData *script) {
+	if (!_optimize)
+		return;
+
+	const uint size = script->size();
+
+	// Find the instructions, and the targets of the control instructions
+	Common::Array<int> lengths;
+	Common::Array<bool> isTarget;
+	lengths.resize(size + 1);
+	isTarget.resize(size + 1);
+	for (uint i = 0; i <= size; i++) {
+		lengths[i] = 0;
+		isTarget[i] = false;
+	}
+
+	Common::Array<uint> controls;
+	for (uint pc = 0; pc < size; pc += lengths[pc]) {
+		int length = instructionLength(*script, pc);
+		if (length < 0) {
+			debug(2, "optimizeScript: cannot decode instruction at %d", pc);
+			return;
+		}
+		lengths[pc] = length;
+
+		inst op = (*script)[pc];
+		if (op == c_ifcode || op == c_repeatwhilecode || op == c_repeatwithcode)
+			controls.push_back(pc);
+	}
+
+	for (uint i = 0; i < controls.size(); i++) {
+		uint pc = controls[i];
+		inst op = (*script)[pc];
+		int numTargets = (op == c_ifcode) ? 3 : (op == c_repeatwhilecode ? 2 : 5);
+
+		for (int j = 1; j <= numTargets; j++) {
+			// The loop increment
+			if (op == c_repeatwithcode && j == 4)
+				continue;
+
+			uint target = READ_UINT32(&(*script)[pc + j]);
+			if (target > size || (target < size && !lengths[target])) {
+				debug(2, "optimizeScript: jump from %d to %d is not an instruction", pc, target);
+				return;
+			}
+			isTarget[target] = true;
+		}
+	}
+
+	// Emit the new code
+	ScriptData *savedScript = _currentScript;
+	ScriptData out;
+	_currentScript = &out;
+
+	Common::Array<int> newPos;
+	newPos.resize(size + 1);
+	for (uint i = 0; i <= size; i++)
+		newPos[i] = -1;
+
+	// The constants at the end of the emitted code
+	Common::Array<FoldedConstant> constants;
+
+	for (uint pc = 0; pc < size; pc += lengths[pc]) {
+		inst op = (*script)[pc];
+		uint next = pc + lengths[pc];
+		int numArgs;
+
+		if (isTarget[pc])
+			constants.clear();
+
+		newPos[pc] = out.size();
+
+		if (op == c_constpush || op == c_fconstpush) {
+			FoldedConstant c;
+			c.outPos = out.size();
+			c.pc = pc;
+			if (op == c_constpush) {
+				c.value.u.i = READ_UINT32(&(*script)[pc + 1]);
+				c.value.type = INT;
+			} else {
+				c.value.u.f = *((const double *)&(*script)[pc + 1]);
+				c.value.type = FLOAT;
+			}
+			constants.push_back(c);
+
+			for (uint i = pc; i < next; i++)
+				code1((*script)[i]);
+			continue;
+		}
+
+		if (isFoldable(op, numArgs) && (int)constants.size() >= numArgs) {
+			uint first = constants.size() - numArgs;
+			for (uint i = first; i < constants.size(); i++)
+				push(constants[i].value);
+
+			Datum result;
+			if (foldConstants(op, numArgs, result)) {
+				FoldedConstant c = constants[first];
+				for (uint i = first + 1; i < constants.size(); i++)
+					newPos[constants[i].pc] = -1;
+				newPos[pc] = -1;
+				constants.resize(first);
+
+				out.resize(c.outPos);
+				if (result.type == INT) {
+					codeConst(result.u.i);
+				} else {
+					code1(c_fconstpush);
+					codeFloat(result.u.f);
+				}
+
+				c.value = result;
+				constants.push_back(c);
+				continue;
+			}
+		}
+
+		constants.clear();
+
+		for (uint i = pc; i < next; i++)
+			code1((*script)[i]);
+	}
+	newPos[size] = out.size();
+
+	// Move the jump targets along
+	for (uint i = 0; i < controls.size(); i++) {
+		uint pc = newPos[controls[i]];
+		inst op = out[pc];
+		int numTargets = (op == c_ifcode) ? 3 : (op == c_repeatwhilecode ? 2 : 5);
+
+		for (int j = 1; j <= numTargets; j++) {
+			if (op == c_repeatwithcode && j == 4)
+				continue;
+
+			int target = newPos[READ_UINT32(&out[pc + j])];
+			assert(target >= 0);
+			WRITE_UINT32(&out[pc + j], target);
+		}
+	}
+
+	debug(2, "optimizeScript: %d code words instead of %d", out.size(), size);
+
+	_currentScript = savedScript;
+	*script = out;
+}
+
 }
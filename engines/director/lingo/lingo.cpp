@@ -21,6 +21,7 @@
  */
 
 #include "common/str-array.h"
+#include "common/system.h"
 
 #include "director/lingo/lingo.h"
 #include "director/lingo/lingo-gr.h"
@@ -79,6 +80,18 @@ Symbol::Symbol() {
 	global = false;
 }
 
+void StackData::grow() {
+	const uint capacity = _capacity * 2;
+	Datum *data = new Datum[capacity];
+	for (uint i = 0; i < _size; i++)
+		data[i] = _data[i];
+
+	if (_data != _inline)
+		delete[] _data;
+	_data = data;
+	_capacity = capacity;
+}
+
 Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 	g_lingo = this;
 
@@ -98,6 +111,8 @@ Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 
 	_hadError = false;
 
+	_optimize = true;
+
 	_inFactory = false;
 
 	_floatPrecision = 4;
@@ -193,6 +208,9 @@ void Lingo::addCode(const char *code, ScriptType type, uint16 id) {
 		parse(code);
 
 		code1(STOP);
+
+		if (!_hadError)
+			optimizeScript(_currentScript);
 	}
 
 	_inFactory = false;
@@ -385,12 +403,17 @@ void Lingo::runTests() {
 			warning("Compiling file %s of size %d, id: %d", fileList[i].c_str(), size, counter);
 
 			_hadError = false;
+			uint32 startTime = g_system->getMillis();
 			addCode(script, kMovieScript, counter);
+			const uint32 compileTime = g_system->getMillis() - startTime;
 
-			if (!_hadError)
+			if (!_hadError) {
+				startTime = g_system->getMillis();
 				executeScript(kMovieScript, counter);
-			else
+				warning("Compiled in %u ms, executed in %u ms", compileTime, g_system->getMillis() - startTime);
+			} else {
 				warning("Skipping execution");
+			}
 
 			free(script);
 
@@ -26,6 +26,7 @@
 #include "common/debug.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
+#include "common/noncopyable.h"
 #include "audio/audiostream.h"
 #include "common/str.h"
 #include "engines/director/director.h"
@@ -122,6 +123,46 @@ struct Datum {	/* interpreter stack type */
 	const char *type2str(bool isk = false);
 };
 
+/**
+ * The interpreter stack. It starts out in a fixed array, so that pushing
+ * and popping don't allocate. Only deeper stacks move to the heap.
+ */
+class StackData : Common::NonCopyable {
+public:
+	enum {
+		kInlineSize = 1024
+	};
+
+	StackData() : _data(_inline), _capacity(kInlineSize), _size(0) {}
+	~StackData() {
+		if (_data != _inline)
+			delete[] _data;
+	}
+
+	uint size() const { return _size; }
+	bool empty() const { return _size == 0; }
+
+	Datum &operator[](uint idx) { return _data[idx]; }
+	Datum &back() { return _data[_size - 1]; }
+
+	void push_back(const Datum &d) {
+		if (_size == _capacity)
+			grow();
+
+		_data[_size++] = d;
+	}
+
+	void pop_back() { _size--; }
+
+private:
+	void grow();
+
+	Datum _inline[kInlineSize];
+	Datum *_data;
+	uint _capacity;
+	uint _size;
+};
+
 struct Builtin {
 	void (*func)(void);
 	int nargs;
@@ -130,7 +171,6 @@ struct Builtin {
 };
 
 typedef Common::HashMap<int32, ScriptData *> ScriptHash;
-typedef Common::Array<Datum> StackData;
 typedef Common::HashMap<Common::String, Symbol *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> SymbolHash;
 typedef Common::HashMap<Common::String, Builtin *, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> BuiltinHash;
 
@@ -166,6 +206,7 @@ private:
 
 public:
 	void execute(int pc);
+	void optimizeScript(ScriptData *script);
 	void pushContext();
 	void popContext();
 	Symbol *lookupVar(const char *name, bool create = true, bool putInGlobalList = false);
@@ -382,10 +423,16 @@ public:
 
 	bool _hadError;
 
+	bool _optimize;
+
 	bool _inFactory;
 	Common::String _currentFactory;
 
 private:
+	int instructionLength(const ScriptData &script, uint pc);
+	bool foldConstants(inst op, int numArgs, Datum &result);
+	bool isFoldable(inst op, int &numArgs);
+
 	int parse(const char *code);
 	void push(Datum d);
 	Datum pop(void);
@@ -0,0 +1,156 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/gamescanner.h"
+#include "engines/metaengine.h"
+#include "base/plugins.h"
+#include "common/config-manager.h"
+#include "common/fingerprint-cache.h"
+#include "common/system.h"
+
+/** Remove trailing slashes, so that "/foo" and "/foo/" match. */
+static Common::String normalizePath(Common::String path) {
+	// This works around a bug in the POSIX FS code (and others?)
+	// where paths are not normalized (so FSNodes refering to identical
+	// FS objects may return different values in path()).
+	while (path != "/" && path.lastChar() == '/')
+		path.deleteLastChar();
+	return path;
+}
+
+GameScanner::GameScanner(const Common::FSNode &startDir, bool recursive, bool allVariants)
+	: _startDir(startDir), _recursive(recursive), _allVariants(allVariants), _unreadableDirs(false),
+	  _dirsScanned(0), _dirTotal(1), _newGamesCount(0), _oldGamesCount(0) {
+	// The dir we start our scan at
+	_scanQueue.push(startDir);
+
+	// Build a map from all configured game paths to the targets using them
+	const Common::ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
+	Common::ConfigManager::DomainMap::const_iterator iter;
+	for (iter = domains.begin(); iter != domains.end(); ++iter) {
+
+#ifdef __DS__
+		// DS port uses an extra section called 'ds'.  This prevents the section from being
+		// detected as a game.
+		if (iter->_key == "ds") {
+			continue;
+		}
+#endif
+
+		Common::String path(normalizePath(iter->_value.getVal("path")));
+		if (!path.empty())
+			_pathToTargets[path].push_back(iter->_key);
+	}
+}
+
+bool GameScanner::scan(uint32 maxTime) {
+	const uint32 start = g_system->getMillis();
+
+	// Perform a breadth-first scan of the filesystem, always finishing the
+	// directory we started on so that every slice makes progress.
+	while (!_scanQueue.empty()) {
+		scanDirectory(_scanQueue.pop());
+
+		// Every file below the start dir was looked at now, so cached
+		// fingerprints of files which were not are stale. That does not
+		// hold if some directory could not be read.
+		if (_scanQueue.empty() && !_unreadableDirs)
+			FingerprintMan.prune(_startDir, _recursive);
+
+		if (maxTime && g_system->getMillis() - start >= maxTime)
+			break;
+	}
+
+	return _scanQueue.empty();
+}
+
+void GameScanner::scanDirectory(const Common::FSNode &dir) {
+	Common::FSList files;
+	if (!dir.getChildren(files, Common::FSNode::kListAll)) {
+		_unreadableDirs = true;
+		return;
+	}
+
+	// Only directories which could be read count as scanned
+	_dirsScanned++;
+
+	// Run the detector on the dir
+	GameList candidates(EngineMan.detectGames(files));
+
+	// Just add all detected games / game variants. If we get more than one,
+	// that either means the directory contains multiple games, or the detector
+	// could not fully determine which game variant it was seeing. In either
+	// case, let the user choose which entries he wants to keep.
+	//
+	// However, we only add games which are not already in the config file.
+	const Common::String path(normalizePath(dir.getPath()));
+	bool ambiguous = !_allVariants && candidates.size() > 1;
+	for (GameList::iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
+		if (isConfigured(path, *cand)) {
+			_oldGamesCount++;
+			ambiguous = false;
+			break;	// Skip duplicates
+		}
+
+		if (ambiguous)
+			continue;
+
+		(*cand)["path"] = path;
+		_games.push(*cand);
+		_newGamesCount++;
+	}
+
+	if (ambiguous)
+		_ambiguousDirs.push(path);
+
+	if (!_recursive)
+		return;
+
+	// Recurse into all subdirs
+	for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
+		if (file->isDirectory()) {
+			_scanQueue.push(*file);
+			_dirTotal++;
+		}
+	}
+}
+
+bool GameScanner::isConfigured(const Common::String &path, const GameDescriptor &game) const {
+	// Check for existing config entries for this path/gameid/lang/platform combination
+	if (!_pathToTargets.contains(path))
+		return false;
+
+	const Common::StringArray &targets = _pathToTargets[path];
+	for (Common::StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
+		// If the gameid, platform and language match -> skip it
+		Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
+		assert(dom);
+
+		if ((*dom)["gameid"] == game["gameid"] &&
+		    (*dom)["platform"] == game["platform"] &&
+		    (*dom)["language"] == game["language"]) {
+			return true;
+		}
+	}
+
+	return false;
+}
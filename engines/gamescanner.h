@@ -0,0 +1,116 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_GAMESCANNER_H
+#define ENGINES_GAMESCANNER_H
+
+#include "engines/game.h"
+#include "common/fs.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/queue.h"
+#include "common/str-array.h"
+
+/**
+ * Walks a directory tree and runs the game detection of all engines on
+ * every directory in it, as done by the mass add dialog and the --add
+ * command line option.
+ *
+ * The work is split into slices by scan(), so that the GUI can stay
+ * responsive while a large library is being scanned. Detected games are
+ * queued up as they are found, and can be fetched with popGame() while the
+ * scan is still in progress. Games which are already present in the config
+ * file are not reported again.
+ *
+ * When the detector returns several candidates for a directory, the mass add
+ * dialog lists all of them and lets the user choose. Without a user to ask,
+ * such directories can be skipped instead, and fetched with
+ * popAmbiguousDir().
+ */
+class GameScanner {
+public:
+	/**
+	 * @param startDir	the directory to start the scan at
+	 * @param recursive	whether to descend into the subdirectories of startDir
+	 * @param allVariants	whether to report all candidates of a directory,
+	 *			or to skip directories with more than one
+	 */
+	GameScanner(const Common::FSNode &startDir, bool recursive = true, bool allVariants = true);
+
+	/**
+	 * Scan directories until all have been scanned or maxTime
+	 * milliseconds have passed.
+	 *
+	 * @param maxTime	the time budget in milliseconds; 0 means no limit
+	 * @return true once the scan is complete
+	 */
+	bool scan(uint32 maxTime = 0);
+
+	/** Whether all directories have been scanned. */
+	bool isDone() const { return _scanQueue.empty(); }
+
+	/** Whether there are detected games which were not fetched yet. */
+	bool hasGames() const { return !_games.empty(); }
+
+	/**
+	 * Fetch the next detected game. Its "path" entry is set to the
+	 * directory the game was found in.
+	 */
+	GameDescriptor popGame() { return _games.pop(); }
+
+	/** Whether there are skipped directories which were not fetched yet. */
+	bool hasAmbiguousDirs() const { return !_ambiguousDirs.empty(); }
+
+	/** Fetch the path of the next directory skipped for having several candidates. */
+	Common::String popAmbiguousDir() { return _ambiguousDirs.pop(); }
+
+	int getDirsScanned() const { return _dirsScanned; }
+	int getDirTotal() const { return _dirTotal; }
+	int getNewGamesCount() const { return _newGamesCount; }
+	int getOldGamesCount() const { return _oldGamesCount; }
+
+private:
+	void scanDirectory(const Common::FSNode &dir);
+	bool isConfigured(const Common::String &path, const GameDescriptor &game) const;
+
+	Common::Queue<Common::FSNode> _scanQueue;
+	Common::Queue<GameDescriptor> _games;
+	Common::Queue<Common::String> _ambiguousDirs;
+	Common::FSNode _startDir;
+	bool _recursive;
+	bool _allVariants;
+	bool _unreadableDirs;
+
+	/**
+	 * Map each path occuring in the config file to the target(s) using that path.
+	 * Used to detect whether a potential new target is already present in the
+	 * config manager.
+	 */
+	Common::HashMap<Common::String, Common::StringArray> _pathToTargets;
+
+	int _dirsScanned;
+	int _dirTotal;
+	int _newGamesCount;
+	int _oldGamesCount;
+};
+
+#endif
@@ -22,6 +22,8 @@
 
 #include "groovie/cell.h"
 
+#include "common/system.h"
+
 namespace Groovie {
 
 CellGame::CellGame() {
@@ -34,6 +36,26 @@ CellGame::CellGame() {
 	_coeff3 = 0;
 
 	_moveCount = 0;
+
+	_fastSearch = true;
+	_searchNodes = _searchHits = 0;
+	_searchBudget = _searchStart = 0;
+	_budgetActive = false;
+
+	// Fixed Zobrist keys, a xorshift sequence is random enough for these
+	uint32 key = 0x12345678;
+	for (int i = 0; i < 49; ++i) {
+		for (int j = 0; j < 5; ++j) {
+			key ^= key << 13;
+			key ^= key >> 17;
+			key ^= key << 5;
+			_zobristKeys[i][j] = key;
+		}
+	}
+
+	_searchTable = new SearchEntry[1 << kSearchTableBits];
+	for (int i = 0; i < (1 << kSearchTableBits); ++i)
+		_searchTable[i].used = false;
 }
 
 byte CellGame::getStartX() {
@@ -73,6 +95,7 @@ byte CellGame::getEndY() {
 }
 
 CellGame::~CellGame() {
+	delete[] _searchTable;
 }
 
 const int8 possibleMoves[][9] = {
@@ -464,6 +487,15 @@ bool CellGame::canMoveFunc2(int8 color) {
 	return false;
 }
 
+bool CellGame::nextMove(int type, int8 color) {
+	if (type == 1)
+		return canMoveFunc2(color);
+	else if (type == 2)
+		return canMoveFunc1(color);
+	else
+		return canMoveFunc3(color);
+}
+
 void CellGame::makeMove(int8 color) {
 	copyToTempBoard();
 	_tempBoard[_board[54]] = color;
@@ -550,7 +582,102 @@ void CellGame::chooseBestMove(int8 color) {
 	_endY = _stack_endXY[0] / 7;
 }
 
+uint32 CellGame::hashSearchEntry(const SearchEntry &key) const {
+	uint32 hash = 0;
+	for (int i = 0; i < 49; ++i)
+		hash ^= _zobristKeys[i][key.board[i]];
+
+	hash ^= (key.depth << 24) ^ ((key.bestWeight & 0xFF) << 16) ^ (key.color1 << 12) ^ (key.color2 << 8) ^ key.coeff3;
+	return (hash * 0x9E3779B1) >> (32 - kSearchTableBits);
+}
+
+bool CellGame::sameSearchKey(const SearchEntry &a, const SearchEntry &b) {
+	return a.color1 == b.color1 && a.color2 == b.color2 && a.coeff3 == b.coeff3 && a.bestWeight == b.bestWeight &&
+		a.depth == b.depth && !memcmp(a.board, b.board, sizeof(a.board));
+}
+
+void CellGame::checkSearchBudget() {
+	// Looking at the clock for every position would be too slow
+	if (_budgetActive && !(_searchNodes & 63) && g_system->getMillis() - _searchStart >= _searchBudget)
+		_flag1 = true;
+}
+
 int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight) {
+	++_searchNodes;
+	checkSearchBudget();
+
+	if (!_fastSearch)
+		return searchBestWeight(color1, color2, depth, bestWeight);
+
+	// The weight only depends on the position and the parameters of the
+	// search, so it is shared by all the move orders which lead to it
+	SearchEntry key;
+	memcpy(key.board, _tempBoard, sizeof(key.board));
+	key.color1 = color1;
+	key.color2 = color2;
+	key.coeff3 = _coeff3;
+	key.bestWeight = bestWeight;
+	key.depth = depth;
+	key.used = true;
+
+	SearchEntry &entry = _searchTable[hashSearchEntry(key)];
+	if (entry.used && sameSearchKey(entry, key)) {
+		++_searchHits;
+		return entry.result;
+	}
+
+	key.result = searchBestWeight(color1, color2, depth, bestWeight);
+
+	// An aborted search has no valid result
+	if (!_flag1)
+		entry = key;
+
+	return key.result;
+}
+
+int8 CellGame::searchOrderedMoves(int8 color1, int8 curColor, int type, uint16 depth, int bestWeight, int8 res, int8 currBoardWeight) {
+	Move moves[kMaxMoves];
+	int numMoves = 0;
+
+	// The replies which are the best for the opponent are the most likely
+	// to cut off the search, so try them first. The order of equal moves
+	// is kept.
+	while (nextMove(type, curColor)) {
+		int8 weight = getBoardWeight(color1, curColor);
+		if (_board[55] == 2 && weight == currBoardWeight)
+			continue;
+
+		assert(numMoves < kMaxMoves);
+		int i = numMoves++;
+		for (; i > 0 && moves[i - 1].weight > weight; --i)
+			moves[i] = moves[i - 1];
+
+		moves[i].startXY = _board[53];
+		moves[i].endXY = _board[54];
+		moves[i].pass = _board[55];
+		moves[i].weight = weight;
+	}
+
+	for (int i = 0; i < numMoves; ++i) {
+		_board[53] = moves[i].startXY;
+		_board[54] = moves[i].endXY;
+		_board[55] = moves[i].pass;
+		makeMove(curColor);
+
+		int8 weight = calcBestWeight(color1, curColor, depth, bestWeight);
+		if (_flag1)
+			break;
+
+		if (weight < res)
+			res = weight;
+		if (res < bestWeight)
+			break;
+	}
+
+	return res;
+}
+
+int8 CellGame::searchBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight) {
 	int8 res;
 	int8 curColor;
 	bool canMove;
@@ -616,14 +743,18 @@ int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWe
 	}
 
 	currBoardWeight = _coeff3 + 2 * (2 * _board[color1 + 48] - _board[49] - _board[50] - _board[51] - _board[52]);
+
+	// Only the opponent's moves can cut off the search, so the order of
+	// the own moves does not matter. At the last ply, the order of the
+	// moves is part of the move generation, see the type 1 case below.
+	if (_fastSearch && depth && color1 != curColor) {
+		res = searchOrderedMoves(color1, curColor, type, depth, bestWeight, res, currBoardWeight);
+		popBoard();
+		return _flag1 ? bestWeight + 1 : res;
+	}
+
 	while (1) {
-		if (type == 1) {
-			canMove = canMoveFunc2(curColor);
-		} else if (type == 2) {
-			canMove = canMoveFunc1(curColor);
-		} else {
-			canMove = canMoveFunc3(curColor);
-		}
+		canMove = nextMove(type, curColor);
 
 		if (!canMove)
 			break;
@@ -662,6 +793,35 @@ int8 CellGame::calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWe
 	return res;
 }
 
+int16 CellGame::doGameDeepening(int8 color, int depth) {
+	if (!_searchBudget || depth <= 1)
+		return doGame(color, depth);
+
+	_searchStart = g_system->getMillis();
+
+	// The shallowest search always completes, so that there is a move to
+	// fall back to when the budget runs out
+	int16 result = doGame(color, 1);
+	for (int curDepth = 2; result && curDepth <= depth; ++curDepth) {
+		byte startX = _startX, startY = _startY, endX = _endX, endY = _endY;
+
+		_budgetActive = true;
+		result = doGame(color, curDepth);
+		_budgetActive = false;
+
+		if (_flag1) {
+			_flag1 = false;
+			_startX = startX;
+			_startY = startY;
+			_endX = endX;
+			_endY = endY;
+			return 1;
+		}
+	}
+
+	return result;
+}
+
 int16 CellGame::doGame(int8 color, int depth) {
 	bool canMove;
 	int type;
@@ -750,6 +910,7 @@ int16 CellGame::calcMove(int8 color, uint16 depth) {
 	int result = 0;
 
 	_flag1 = false;
+	_searchNodes = _searchHits = 0;
 	++_moveCount;
 	if (depth) {
 		if (depth == 1) {
@@ -763,7 +924,7 @@ int16 CellGame::calcMove(int8 color, uint16 depth) {
 			if (newDepth >= 20) {
 				assert(0); // This branch is not implemented
 			} else {
-				result = doGame(color, newDepth);
+				result = doGameDeepening(color, newDepth);
 			}
 		}
 	} else {
@@ -45,7 +45,52 @@ public:
 	byte getEndY();
 	int playStauf(byte color, uint16 depth, byte *scriptBoard);
 
+	/**
+	 * Enable the transposition table and the move ordering of the search.
+	 * Both leave the chosen move unchanged, disabling them is only useful
+	 * to compare against the plain search.
+	 */
+	void setFastSearch(bool enable) { _fastSearch = enable; }
+
+	/**
+	 * Limit the time spent on a move. The search is then deepened one ply
+	 * at a time, and if the budget runs out, the move of the deepest
+	 * completed search is used. 0 means no limit.
+	 */
+	void setSearchBudget(uint32 millis) { _searchBudget = millis; }
+
+	/** Number of positions searched for the last move. */
+	uint32 getSearchNodes() const { return _searchNodes; }
+
+	/** Number of positions of the last move found in the transposition table. */
+	uint32 getSearchHits() const { return _searchHits; }
+
 private:
+	enum {
+		kSearchTableBits = 14,
+		kMaxMoves = 49 * 17
+	};
+
+	/** A position searched by calcBestWeight, and its result */
+	struct SearchEntry {
+		int8 board[53];
+		int8 color1;
+		int8 color2;
+		int8 coeff3;
+		int16 bestWeight;
+		uint16 depth;
+		int8 result;
+		bool used;
+	};
+
+	/** A move of the current color, as stored in _board[53..55] */
+	struct Move {
+		int8 startXY;
+		int8 endXY;
+		int8 pass;
+		int8 weight;
+	};
+
 	void copyToTempBoard();
 	void copyFromTempBoard();
 	void copyToShadowBoard();
@@ -59,6 +104,7 @@ private:
 	bool canMoveFunc1(int8 color);
 	bool canMoveFunc2(int8 color);
 	bool canMoveFunc3(int8 color);
+	bool nextMove(int type, int8 color);
 	void takeCells(uint16 whereTo, int8 color);
 	void countAllCells();
 	int countCellsOnTempBoard(int8 color);
@@ -66,7 +112,13 @@ private:
 	int getBoardWeight(int8 color1, int8 color2);
 	void chooseBestMove(int8 color);
 	int8 calcBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight);
+	int8 searchBestWeight(int8 color1, int8 color2, uint16 depth, int bestWeight);
+	int8 searchOrderedMoves(int8 color1, int8 curColor, int type, uint16 depth, int bestWeight, int8 res, int8 currBoardWeight);
+	uint32 hashSearchEntry(const SearchEntry &key) const;
+	static bool sameSearchKey(const SearchEntry &a, const SearchEntry &b);
+	void checkSearchBudget();
 	int16 doGame(int8 color, int depth);
+	int16 doGameDeepening(int8 color, int depth);
 	int16 calcMove(int8 color, uint16 depth);
 
 	byte _startX;
@@ -90,6 +142,16 @@ private:
 	int _coeff3;
 	bool _flag1, _flag2, _flag4;
 	int _moveCount;
+
+	bool _fastSearch;
+	uint32 _zobristKeys[49][5];
+	SearchEntry *_searchTable;
+	uint32 _searchNodes;
+	uint32 _searchHits;
+
+	uint32 _searchBudget;
+	uint32 _searchStart;
+	bool _budgetActive;
 };
 
 } // End of Groovie namespace
@@ -1477,9 +1477,14 @@ void Script::o_cellmove() {
 
 	debugC(1, kDebugScript, "CELL MOVE var[0x%02X]", depth);
 
-	if (!_staufsMove)
+	if (!_staufsMove) {
 		_staufsMove = new CellGame;
 
+		// A full search takes a few milliseconds, only very slow systems
+		// should ever fall back to a shallower one
+		_staufsMove->setSearchBudget(1000);
+	}
+
 	_staufsMove->playStauf(2, depth, scriptBoard);
 
 	startX = _staufsMove->getStartX();
@@ -51,6 +51,7 @@
 #include "video/avi_decoder.h"
 #include "sci/video/seq_decoder.h"
 #ifdef ENABLE_SCI32
+#include "sci/graphics/celobj32.h"
 #include "sci/graphics/frameout.h"
 #include "sci/graphics/paint32.h"
 #include "video/coktel_decoder.h"
@@ -111,6 +112,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_stats",		WRAP_METHOD(Console, cmdResourceStats));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
 	registerCmd("verify_scripts",		WRAP_METHOD(Console, cmdVerifyScripts));
@@ -144,6 +146,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("vpi",                WRAP_METHOD(Console, cmdVisiblePlaneItemList));	// alias
 	registerCmd("saved_bits",         WRAP_METHOD(Console, cmdSavedBits));
 	registerCmd("show_saved_bits",    WRAP_METHOD(Console, cmdShowSavedBits));
+	registerCmd("cel_cache",          WRAP_METHOD(Console, cmdCelCache));
 	// Segments
 	registerCmd("segment_table",		WRAP_METHOD(Console, cmdPrintSegmentTable));
 	registerCmd("segtable",			WRAP_METHOD(Console, cmdPrintSegmentTable));	// alias
@@ -361,6 +364,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_stats - Shows resource cache statistics\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
 	debugPrintf(" verify_scripts - Performs sanity checks on SCI1.1-SCI2.1 game scripts (e.g. if they're up to 64KB in total)\n");
@@ -390,6 +394,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" visible_plane_items / vpi - Shows a list of all items for a plane in the visible draw list (SCI2+)\n");
 	debugPrintf(" saved_bits - List saved bits on the hunk\n");
 	debugPrintf(" show_saved_bits - Display saved bits\n");
+	debugPrintf(" cel_cache - Shows and sets up the cache of cel objects (SCI2+)\n");
 	debugPrintf("\n");
 	debugPrintf("Segments:\n");
 	debugPrintf(" segment_table / segtable - Lists all segments\n");
@@ -970,6 +975,18 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceStats(int argc, const char **argv) {
+	const ResourceManager *resMan = _engine->getResMan();
+	const ResourceManager::CacheStats &stats = resMan->getCacheStats();
+
+	debugPrintf("Cache: %d of %d bytes used, %d bytes locked\n", resMan->getLRUMemory(), resMan->getMaxLRUMemory(), resMan->getLockedMemory());
+	debugPrintf("Requests: %u hits, %u misses, %u evictions\n", stats.hits, stats.misses, stats.evictions);
+	debugPrintf("Load time: %u ms on request, %u ms while idle\n", stats.loadMillis, stats.prefetchMillis);
+	debugPrintf("Prefetched: %u resources, %u of them used\n", stats.prefetches, stats.prefetchHits);
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -2023,6 +2040,30 @@ bool Console::cmdShowSavedBits(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdCelCache(int argc, const char **argv) {
+#ifdef ENABLE_SCI32
+	if (argc > 1 && !scumm_stricmp(argv[1], "reset")) {
+		CelObj::resetCacheStats();
+	} else if (argc > 2 && !scumm_stricmp(argv[1], "capacity")) {
+		CelObj::setCacheCapacity(atoi(argv[2]));
+	} else if (argc > 2 && !scumm_stricmp(argv[1], "precache")) {
+		CelObj::setPrecacheViews(!scumm_stricmp(argv[2], "on"));
+	} else if (argc > 1) {
+		debugPrintf("Usage: %s [reset | capacity <cels> | precache on|off]\n", argv[0]);
+		return true;
+	}
+
+	const CelCacheStats &stats = CelObj::getCacheStats();
+	debugPrintf("Cache: %u of %u cels, precaching views is %s\n", CelObj::getCacheSize(),
+		CelObj::getCacheCapacity(), CelObj::getPrecacheViews() ? "on" : "off");
+	debugPrintf("Requests: %u hits, %u misses, %u evictions, %u cels precached\n",
+		stats.hits, stats.misses, stats.evictions, stats.precached);
+#else
+	debugPrintf("SCI32 isn't included in this compiled executable\n");
+#endif
+	return true;
+}
+
 
 bool Console::cmdParseGrammar(int argc, const char **argv) {
 	debugPrintf("Parse grammar, in strict GNF:\n");
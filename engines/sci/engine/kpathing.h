@@ -0,0 +1,137 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_KPATHING_H
+#define SCI_ENGINE_KPATHING_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Sci {
+
+struct VisibilityGraph;
+
+/**
+ * A polygon of an AvoidPath polygon list, with its points in the order
+ * they are stored in the game scripts.
+ */
+struct AvoidPathPolygon {
+	int type;
+	Common::Array<Common::Point> points;
+};
+
+typedef Common::Array<AvoidPathPolygon> AvoidPathPolygonList;
+
+/**
+ * Game specific workarounds of the pathfinder. kAvoidPath selects them
+ * from the current game and room.
+ */
+enum AvoidPathWorkaround {
+	kAvoidPathNoWorkaround = 0,
+	kAvoidPathLSL5Room660 = 1 << 0,		///< Walk around a priority glitch, see convert_polygon_set()
+	kAvoidPathQFG1VGARoom81 = 1 << 1	///< No penalty for vertices on the screen border, see AStar()
+};
+
+/**
+ * Remembers which vertices can see each other, for the last few polygon
+ * sets AvoidPath was called for.
+ *
+ * Actors usually walk many times through the same room, and the polygons
+ * of a room rarely change, so most calls can skip the visibility tests
+ * between the polygon vertices. The graphs are keyed by the points of the
+ * polygons, after the polygons which do not apply to the start and end
+ * points have been removed. Changes of the polygon data by the scripts
+ * therefore simply lead to a different graph.
+ */
+class AvoidPathCache {
+public:
+	AvoidPathCache();
+	~AvoidPathCache();
+
+	/**
+	 * Gets the visibility graph of a polygon set, and creates an empty one
+	 * if it is not in the cache yet. The least recently used graph is
+	 * dropped when the cache is full.
+	 * @param polygonSizes	the number of vertices of each polygon
+	 * @param points		the vertices of all polygons
+	 * @return the graph, or NULL if the set has too many vertices to be cached
+	 */
+	VisibilityGraph *getGraph(const Common::Array<uint16> &polygonSizes, const Common::Array<Common::Point> &points);
+
+	/** Drops all graphs. */
+	void clear();
+
+	/** Number of calls which found their graph in the cache. */
+	uint32 getHits() const { return _hits; }
+
+	/** Number of calls which had to start a new graph. */
+	uint32 getMisses() const { return _misses; }
+
+private:
+	Common::Array<VisibilityGraph *> _graphs;
+	uint32 _useCounter;
+	uint32 _hits;
+	uint32 _misses;
+};
+
+/**
+ * Computes a path from start to end which avoids the polygons, like
+ * kAvoidPath does for the game scripts.
+ *
+ * @param polygons		the polygons of the room
+ * @param start			the start point
+ * @param end			the end point
+ * @param width			the width of the screen
+ * @param height		the height of the screen
+ * @param opt			the optimization level (0, 1 or 2)
+ * @param workarounds	a combination of AvoidPathWorkaround flags
+ * @param cache			the cache of visibility graphs to use, or NULL to
+ *						compute the visibility of all vertices on demand
+ * @param path			set to the points of the path, including the start
+ *						and end points
+ * @return the number of vertices on the path found by the search, 0 if the
+ *		   end point is unreachable, or -1 if no valid start or end point was
+ *		   found
+ */
+int findAvoidPath(const AvoidPathPolygonList &polygons, const Common::Point &start, const Common::Point &end,
+				  int width, int height, int opt, uint workarounds, AvoidPathCache *cache,
+				  Common::Array<Common::Point> &path);
+
+/**
+ * Checks whether a point lies inside or on the edge of a polygon, like
+ * kAvoidPath does when it is called with a single polygon. The type of the
+ * polygon is ignored.
+ */
+bool avoidPathPolygonContains(const AvoidPathPolygon &polygon, const Common::Point &point);
+
+/**
+ * Extends a polygon to also cover another polygon it intersects, like
+ * kMergePoly does for each polygon of its list.
+ * @param work		the points of the polygon to extend
+ * @param polygon	the polygon to merge into work
+ * @return true if the polygons intersect and work was extended
+ */
+bool mergeAvoidPathPolygon(Common::Array<Common::Point> &work, const AvoidPathPolygon &polygon);
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_KPATHING_H
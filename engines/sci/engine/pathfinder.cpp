@@ -0,0 +1,2053 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "sci/sci.h"
+#include "sci/engine/kpathing.h"
+
+#include "common/debug.h"
+#include "common/list.h"
+#include "common/math.h"
+
+//#define DEBUG_MERGEPOLY
+
+namespace Sci {
+
+// TODO: Code cleanup
+
+// SCI-defined polygon types
+enum {
+	POLY_TOTAL_ACCESS = 0,
+	POLY_NEAREST_ACCESS = 1,
+	POLY_BARRED_ACCESS = 2,
+	POLY_CONTAINED_ACCESS = 3
+};
+
+// Polygon containment types
+enum {
+	CONT_OUTSIDE = 0,
+	CONT_ON_EDGE = 1,
+	CONT_INSIDE = 2
+};
+
+#define HUGE_DISTANCE 0xFFFFFFFF
+
+#define VERTEX_HAS_EDGES(V) ((V) != CLIST_NEXT(V))
+
+// Error codes
+enum {
+	PF_OK = 0,
+	PF_ERROR = -1,
+	PF_FATAL = -2
+};
+
+// Floating point struct
+struct FloatPoint {
+	FloatPoint() : x(0), y(0) {}
+	FloatPoint(float x_, float y_) : x(x_), y(y_) {}
+	FloatPoint(Common::Point p) : x(p.x), y(p.y) {}
+
+	Common::Point toPoint() {
+		return Common::Point((int16)(x + 0.5), (int16)(y + 0.5));
+	}
+
+	float operator*(const FloatPoint &p) const {
+		return x*p.x + y*p.y;
+	}
+	FloatPoint operator*(float l) const {
+		return FloatPoint(l*x, l*y);
+	}
+	FloatPoint operator-(const FloatPoint &p) const {
+		return FloatPoint(x-p.x, y-p.y);
+	}
+	float norm() const {
+		return x*x+y*y;
+	}
+
+	float x, y;
+};
+
+struct Vertex {
+	// Location
+	Common::Point v;
+
+	// Vertex circular list entry
+	Vertex *_next;	// next element
+	Vertex *_prev;	// previous element
+
+	// A* cost variables
+	uint32 costF;
+	uint32 costG;
+
+	// Previous vertex in shortest path
+	Vertex *path_prev;
+
+	// Position in PathfindingState::vertex_index
+	int index;
+
+public:
+	Vertex(const Common::Point &p) : v(p) {
+		costG = HUGE_DISTANCE;
+		path_prev = NULL;
+		index = -1;
+	}
+};
+
+class VertexList: public Common::List<Vertex *> {
+public:
+	bool contains(Vertex *v) {
+		for (iterator it = begin(); it != end(); ++it) {
+			if (v == *it)
+				return true;
+		}
+		return false;
+	}
+};
+
+/* Circular list definitions. */
+
+#define CLIST_FOREACH(var, head)					\
+	for ((var) = (head)->first();					\
+		(var);							\
+		(var) = ((var)->_next == (head)->first() ?	\
+		    NULL : (var)->_next))
+
+/* Circular list access methods. */
+#define CLIST_NEXT(elm)		((elm)->_next)
+#define CLIST_PREV(elm)		((elm)->_prev)
+
+class CircularVertexList {
+public:
+	Vertex *_head;
+
+public:
+	CircularVertexList() : _head(0) {}
+
+	Vertex *first() const {
+		return _head;
+	}
+
+	void insertAtEnd(Vertex *elm) {
+		if (_head == NULL) {
+			elm->_next = elm->_prev = elm;
+			_head = elm;
+		} else {
+			elm->_next = _head;
+			elm->_prev = _head->_prev;
+			_head->_prev = elm;
+			elm->_prev->_next = elm;
+		}
+	}
+
+	void insertHead(Vertex *elm) {
+		insertAtEnd(elm);
+		_head = elm;
+	}
+
+	static void insertAfter(Vertex *listelm, Vertex *elm) {
+		elm->_prev = listelm;
+		elm->_next = listelm->_next;
+		listelm->_next->_prev = elm;
+		listelm->_next = elm;
+	}
+
+	void remove(Vertex *elm) {
+		if (elm->_next == elm) {
+			_head = NULL;
+		} else {
+			if (_head == elm)
+				_head = elm->_next;
+			elm->_prev->_next = elm->_next;
+			elm->_next->_prev = elm->_prev;
+		}
+	}
+
+	bool empty() const {
+		return _head == NULL;
+	}
+
+	uint size() const {
+		int n = 0;
+		Vertex *v;
+		CLIST_FOREACH(v, this)
+			++n;
+		return n;
+	}
+
+	/**
+	 * Reverse the order of the elements in this circular list.
+	 */
+	void reverse() {
+		if (!_head)
+			return;
+
+		Vertex *elm = _head;
+		do {
+			SWAP(elm->_prev, elm->_next);
+			elm = elm->_next;
+		} while (elm != _head);
+	}
+};
+
+struct Polygon {
+	// SCI polygon type
+	int type;
+
+	// Circular list of vertices
+	CircularVertexList vertices;
+
+public:
+	Polygon(int t) : type(t) {
+	}
+
+	~Polygon() {
+		while (!vertices.empty()) {
+			Vertex *vertex = vertices.first();
+			vertices.remove(vertex);
+			delete vertex;
+		}
+	}
+};
+
+typedef Common::List<Polygon *> PolygonList;
+
+// Pathfinding state
+struct PathfindingState {
+	// List of all polygons
+	PolygonList polygons;
+
+	// Start and end points for pathfinding
+	Vertex *vertex_start, *vertex_end;
+
+	// Array of all vertices, used for sorting
+	Vertex **vertex_index;
+
+	// Total number of vertices
+	int vertices;
+
+	// Point to prepend and append to final path
+	Common::Point *_prependPoint;
+	Common::Point *_appendPoint;
+
+	// Screen size
+	int _width, _height;
+
+	// Cached visibility of the polygon vertices, NULL if not cached
+	VisibilityGraph *_visibility;
+
+	// Number of vertices in vertex_index before the first one of _visibility
+	int _firstGraphVertex;
+
+	// AvoidPathWorkaround flags
+	uint _workarounds;
+
+	PathfindingState(int width, int height) : _width(width), _height(height) {
+		vertex_start = NULL;
+		vertex_end = NULL;
+		vertex_index = NULL;
+		_prependPoint = NULL;
+		_appendPoint = NULL;
+		vertices = 0;
+		_visibility = NULL;
+		_firstGraphVertex = 0;
+		_workarounds = kAvoidPathNoWorkaround;
+	}
+
+	~PathfindingState() {
+		free(vertex_index);
+
+		delete _prependPoint;
+		delete _appendPoint;
+
+		for (PolygonList::iterator it = polygons.begin(); it != polygons.end(); ++it) {
+			delete *it;
+		}
+	}
+
+	bool pointOnScreenBorder(const Common::Point &p);
+	bool edgeOnScreenBorder(const Common::Point &p, const Common::Point &q);
+	int findNearPoint(const Common::Point &p, Polygon *polygon, Common::Point *ret);
+};
+
+/**
+ * Computes the area of a triangle
+ * Parameters: (const Common::Point &) a, b, c: The points of the triangle
+ * Returns   : (int) The area multiplied by two
+ */
+static int area(const Common::Point &a, const Common::Point &b, const Common::Point &c) {
+	return (b.x - a.x) * (a.y - c.y) - (c.x - a.x) * (a.y - b.y);
+}
+
+/**
+ * Determines whether or not a point is to the left of a directed line
+ * Parameters: (const Common::Point &) a, b: The directed line (a, b)
+ *             (const Common::Point &) c: The query point
+ * Returns   : (int) true if c is to the left of (a, b), false otherwise
+ */
+static bool left(const Common::Point &a, const Common::Point &b, const Common::Point &c) {
+	return area(a, b, c) > 0;
+}
+
+/**
+ * Determines whether or not three points are collinear
+ * Parameters: (const Common::Point &) a, b, c: The three points
+ * Returns   : (int) true if a, b, and c are collinear, false otherwise
+ */
+static bool collinear(const Common::Point &a, const Common::Point &b, const Common::Point &c) {
+	return area(a, b, c) == 0;
+}
+
+/**
+ * Determines whether or not a point lies on a line segment
+ * Parameters: (const Common::Point &) a, b: The line segment (a, b)
+ *             (const Common::Point &) c: The query point
+ * Returns   : (int) true if c lies on (a, b), false otherwise
+ */
+static bool between(const Common::Point &a, const Common::Point &b, const Common::Point &c) {
+	if (!collinear(a, b, c))
+		return false;
+
+	// Assumes a != b.
+	if (a.x != b.x)
+		return ((a.x <= c.x) && (c.x <= b.x)) || ((a.x >= c.x) && (c.x >= b.x));
+	else
+		return ((a.y <= c.y) && (c.y <= b.y)) || ((a.y >= c.y) && (c.y >= b.y));
+}
+
+/**
+ * Determines whether or not two line segments properly intersect
+ * Parameters: (const Common::Point &) a, b: The line segment (a, b)
+ *             (const Common::Point &) c, d: The line segment (c, d)
+ * Returns   : (int) true if (a, b) properly intersects (c, d), false otherwise
+ */
+static bool intersect_proper(const Common::Point &a, const Common::Point &b, const Common::Point &c, const Common::Point &d) {
+	int ab = (left(a, b, c) && left(b, a, d)) || (left(a, b, d) && left(b, a, c));
+	int cd = (left(c, d, a) && left(d, c, b)) || (left(c, d, b) && left(d, c, a));
+
+	return ab && cd;
+}
+
+/**
+ * Polygon containment test
+ * Parameters: (const Common::Point &) p: The point
+ *             (Polygon *) polygon: The polygon
+ * Returns   : (int) CONT_INSIDE if p is strictly contained in polygon,
+ *                   CONT_ON_EDGE if p lies on an edge of polygon,
+ *                   CONT_OUTSIDE otherwise
+ * Number of ray crossing left and right
+ */
+static int contained(const Common::Point &p, Polygon *polygon) {
+	int lcross = 0, rcross = 0;
+	Vertex *vertex;
+
+	// Iterate over edges
+	CLIST_FOREACH(vertex, &polygon->vertices) {
+		const Common::Point &v1 = vertex->v;
+		const Common::Point &v2 = CLIST_NEXT(vertex)->v;
+
+		// Flags for ray straddling left and right
+		int rstrad, lstrad;
+
+		// Check if p is a vertex
+		if (p == v1)
+			return CONT_ON_EDGE;
+
+		// Check if edge straddles the ray
+		rstrad = (v1.y < p.y) != (v2.y < p.y);
+		lstrad = (v1.y > p.y) != (v2.y > p.y);
+
+		if (lstrad || rstrad) {
+			// Compute intersection point x / xq
+			int x = v2.x * v1.y - v1.x * v2.y + (v1.x - v2.x) * p.y;
+			int xq = v1.y - v2.y;
+
+			// Multiply by -1 if xq is negative (for comparison that follows)
+			if (xq < 0) {
+				x = -x;
+				xq = -xq;
+			}
+
+			// Avoid floats by multiplying instead of dividing
+			if (rstrad && (x > xq * p.x))
+				rcross++;
+			else if (lstrad && (x < xq * p.x))
+				lcross++;
+		}
+	}
+
+	// If we counted an odd number of total crossings the point is on an edge
+	if ((lcross + rcross) % 2 == 1)
+		return CONT_ON_EDGE;
+
+	// If there are an odd number of crossings to one side the point is contained in the polygon
+	if (rcross % 2 == 1) {
+		// Invert result for contained access polygons.
+		if (polygon->type == POLY_CONTAINED_ACCESS)
+			return CONT_OUTSIDE;
+		return CONT_INSIDE;
+	}
+
+	// Point is outside polygon. Invert result for contained access polygons
+	if (polygon->type == POLY_CONTAINED_ACCESS)
+		return CONT_INSIDE;
+
+	return CONT_OUTSIDE;
+}
+
+/**
+ * Computes polygon area
+ * Parameters: (Polygon *) polygon: The polygon
+ * Returns   : (int) The area multiplied by two
+ */
+static int polygon_area(Polygon *polygon) {
+	Vertex *first = polygon->vertices.first();
+	Vertex *v;
+	int size = 0;
+
+	v = CLIST_NEXT(first);
+
+	while (CLIST_NEXT(v) != first) {
+		size += area(first->v, v->v, CLIST_NEXT(v)->v);
+		v = CLIST_NEXT(v);
+	}
+
+	return size;
+}
+
+/**
+ * Fixes the vertex order of a polygon if incorrect. Contained access
+ * polygons should have their vertices ordered clockwise, all other types
+ * anti-clockwise
+ * Parameters: (Polygon *) polygon: The polygon
+ */
+static void fix_vertex_order(Polygon *polygon) {
+	int area = polygon_area(polygon);
+
+	// When the polygon area is positive the vertices are ordered
+	// anti-clockwise. When the area is negative the vertices are ordered
+	// clockwise
+	if (((area > 0) && (polygon->type == POLY_CONTAINED_ACCESS))
+	        || ((area < 0) && (polygon->type != POLY_CONTAINED_ACCESS))) {
+
+		polygon->vertices.reverse();
+	}
+}
+
+/**
+ * Determines whether or not a line from a point to a vertex intersects the
+ * interior of the polygon, locally at that vertex
+ * Parameters: (Common::Point) p: The point
+ *             (Vertex *) vertex: The vertex
+ * Returns   : (int) 1 if the line (p, vertex->v) intersects the interior of
+ *                   the polygon, locally at the vertex. 0 otherwise
+ */
+static int inside(const Common::Point &p, Vertex *vertex) {
+	// Check that it's not a single-vertex polygon
+	if (VERTEX_HAS_EDGES(vertex)) {
+		const Common::Point &prev = CLIST_PREV(vertex)->v;
+		const Common::Point &next = CLIST_NEXT(vertex)->v;
+		const Common::Point &cur = vertex->v;
+
+		if (left(prev, cur, next)) {
+			// Convex vertex, line (p, cur) intersects the inside
+			// if p is located left of both edges
+			if (left(cur, next, p) && left(prev, cur, p))
+				return 1;
+		} else {
+			// Non-convex vertex, line (p, cur) intersects the
+			// inside if p is located left of either edge
+			if (left(cur, next, p) || left(prev, cur, p))
+				return 1;
+		}
+	}
+
+	return 0;
+}
+
+/**
+ * Determines whether or not a vertex is visible from another one
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to test
+ * @return true if the line between the vertices does not cross a polygon
+ */
+static bool is_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Edges outside of the bounding box of the line can neither touch nor
+	// cross it
+	const int16 minX = MIN(vertex_cur->v.x, vertex->v.x);
+	const int16 maxX = MAX(vertex_cur->v.x, vertex->v.x);
+	const int16 minY = MIN(vertex_cur->v.y, vertex->v.y);
+	const int16 maxY = MAX(vertex_cur->v.y, vertex->v.y);
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			const Common::Point &p = edge->v;
+			const Common::Point &q = CLIST_NEXT(edge)->v;
+
+			if ((p.x < minX && q.x < minX) || (p.x > maxX && q.x > maxX)
+					|| (p.y < minY && q.y < minY) || (p.y > maxY && q.y > maxY))
+				continue;
+
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Returns a list of all vertices that are visible from a particular vertex.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex
+ * @return list of vertices that are visible from vert
+ */
+static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
+	VertexList *visVerts = new VertexList();
+
+	for (int i = 0; i < s->vertices; i++) {
+		Vertex *vertex = s->vertex_index[i];
+
+		if (is_visible(s, vertex_cur, vertex))
+			visVerts->push_front(vertex);
+	}
+
+	return visVerts;
+}
+
+enum {
+	kMaxGraphs = 4,
+	// A graph of this many vertices takes 64 KB
+	kMaxGraphVertices = 256
+};
+
+// Entries of VisibilityGraph::visibility
+enum {
+	kVisibilityUnknown = 0,
+	kVisibilityVisible = 1,
+	kVisibilityHidden = 2
+};
+
+struct VisibilityGraph {
+	// The polygon set the graph is for
+	Common::Array<uint16> polygonSizes;
+	Common::Array<Common::Point> points;
+
+	// The visibility of each pair of vertices, filled in as the searches
+	// need it
+	Common::Array<byte> visibility;
+
+	uint32 lastUse;
+};
+
+AvoidPathCache::AvoidPathCache() : _useCounter(0), _hits(0), _misses(0) {
+}
+
+AvoidPathCache::~AvoidPathCache() {
+	clear();
+}
+
+void AvoidPathCache::clear() {
+	for (uint i = 0; i < _graphs.size(); i++)
+		delete _graphs[i];
+	_graphs.clear();
+}
+
+VisibilityGraph *AvoidPathCache::getGraph(const Common::Array<uint16> &polygonSizes, const Common::Array<Common::Point> &points) {
+	if (points.size() > kMaxGraphVertices)
+		return NULL;
+
+	_useCounter++;
+
+	VisibilityGraph *graph = NULL;
+	for (uint i = 0; i < _graphs.size(); i++) {
+		if (_graphs[i]->points == points && _graphs[i]->polygonSizes == polygonSizes) {
+			_graphs[i]->lastUse = _useCounter;
+			_hits++;
+			return _graphs[i];
+		}
+
+		if (!graph || _graphs[i]->lastUse < graph->lastUse)
+			graph = _graphs[i];
+	}
+
+	_misses++;
+
+	if (_graphs.size() < kMaxGraphs) {
+		graph = new VisibilityGraph();
+		_graphs.push_back(graph);
+	}
+
+	debugC(kDebugLevelAvoidPath, "AvoidPath: new visibility graph for %d polygons with %d vertices", polygonSizes.size(), points.size());
+
+	graph->polygonSizes = polygonSizes;
+	graph->points = points;
+	graph->visibility.clear();
+	graph->visibility.resize(points.size() * points.size());
+	graph->lastUse = _useCounter;
+	return graph;
+}
+
+/**
+ * Determines whether or not a vertex is visible from another one, and
+ * remembers the result in the visibility graph of the pathfinding state
+ * if both vertices are part of it. The start and end points are only
+ * part of it if they coincide with a polygon vertex.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the vertex to look from
+ * @param vertex		the vertex to test
+ * @return true if the line between the vertices does not cross a polygon
+ */
+static bool is_visible_cached(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	VisibilityGraph *graph = s->_visibility;
+	const int first = s->_firstGraphVertex;
+
+	if (!graph || vertex_cur->index < first || vertex->index < first)
+		return is_visible(s, vertex_cur, vertex);
+
+	// The test is symmetric, so both directions are set at once
+	const uint size = graph->points.size();
+	const uint a = vertex_cur->index - first;
+	const uint b = vertex->index - first;
+	byte &entry = graph->visibility[a * size + b];
+
+	if (entry == kVisibilityUnknown) {
+		entry = is_visible(s, vertex_cur, vertex) ? kVisibilityVisible : kVisibilityHidden;
+		graph->visibility[b * size + a] = entry;
+	}
+
+	return entry == kVisibilityVisible;
+}
+
+/**
+ * Determines if a point lies on the screen border
+ * Parameters: (const Common::Point &) p: The point
+ * Returns   : (int) true if p lies on the screen border, false otherwise
+ */
+bool PathfindingState::pointOnScreenBorder(const Common::Point &p) {
+	return (p.x == 0) || (p.x == _width - 1) || (p.y == 0) || (p.y == _height - 1);
+}
+
+/**
+ * Determines if an edge lies on the screen border
+ * Parameters: (const Common::Point &) p, q: The edge (p, q)
+ * Returns   : (int) true if (p, q) lies on the screen border, false otherwise
+ */
+bool PathfindingState::edgeOnScreenBorder(const Common::Point &p, const Common::Point &q) {
+	return ((p.x == 0 && q.x == 0) || (p.y == 0 && q.y == 0)
+			|| ((p.x == _width - 1) && (q.x == _width - 1))
+			|| ((p.y == _height - 1) && (q.y == _height - 1)));
+}
+
+/**
+ * Searches for a nearby point that is not contained in a polygon
+ * Parameters: (FloatPoint) f: The pointf to search nearby
+ *             (Polygon *) polygon: The polygon
+ * Returns   : (int) PF_OK on success, PF_FATAL otherwise
+ *             (Common::Point) *ret: The non-contained point on success
+ */
+static int find_free_point(FloatPoint f, Polygon *polygon, Common::Point *ret) {
+	Common::Point p;
+
+	// Try nearest point first
+	p = Common::Point((int)floor(f.x + 0.5), (int)floor(f.y + 0.5));
+
+	if (contained(p, polygon) != CONT_INSIDE) {
+		*ret = p;
+		return PF_OK;
+	}
+
+	p = Common::Point((int)floor(f.x), (int)floor(f.y));
+
+	// Try (x, y), (x + 1, y), (x , y + 1) and (x + 1, y + 1)
+	if (contained(p, polygon) == CONT_INSIDE) {
+		p.x++;
+		if (contained(p, polygon) == CONT_INSIDE) {
+			p.y++;
+			if (contained(p, polygon) == CONT_INSIDE) {
+				p.x--;
+				if (contained(p, polygon) == CONT_INSIDE)
+					return PF_FATAL;
+			}
+		}
+	}
+
+	*ret = p;
+	return PF_OK;
+}
+
+/**
+ * Computes the near point of a point contained in a polygon
+ * Parameters: (const Common::Point &) p: The point
+ *             (Polygon *) polygon: The polygon
+ * Returns   : (int) PF_OK on success, PF_FATAL otherwise
+ *             (Common::Point) *ret: The near point of p in polygon on success
+ */
+int PathfindingState::findNearPoint(const Common::Point &p, Polygon *polygon, Common::Point *ret) {
+	Vertex *vertex;
+	FloatPoint near_p;
+	uint32 dist = HUGE_DISTANCE;
+
+	CLIST_FOREACH(vertex, &polygon->vertices) {
+		const Common::Point &p1 = vertex->v;
+		const Common::Point &p2 = CLIST_NEXT(vertex)->v;
+		float u;
+		FloatPoint new_point;
+		uint32 new_dist;
+
+		// Ignore edges on the screen border, except for contained access polygons
+		if ((polygon->type != POLY_CONTAINED_ACCESS) && (edgeOnScreenBorder(p1, p2)))
+			continue;
+
+		// Compute near point
+		u = ((p.x - p1.x) * (p2.x - p1.x) + (p.y - p1.y) * (p2.y - p1.y)) / (float)p1.sqrDist(p2);
+
+		// Clip to edge
+		if (u < 0.0f)
+			u = 0.0f;
+		if (u > 1.0f)
+			u = 1.0f;
+
+		new_point.x = p1.x + u * (p2.x - p1.x);
+		new_point.y = p1.y + u * (p2.y - p1.y);
+
+		new_dist = p.sqrDist(new_point.toPoint());
+
+		if (new_dist < dist) {
+			near_p = new_point;
+			dist = new_dist;
+		}
+	}
+
+	// Find point not contained in polygon
+	return find_free_point(near_p, polygon, ret);
+}
+
+/**
+ * Computes the intersection point of a line segment and an edge (not
+ * including the vertices themselves)
+ * Parameters: (const Common::Point &) a, b: The line segment (a, b)
+ *             (Vertex *) vertex: The first vertex of the edge
+ * Returns   : (int) PF_OK on success, PF_ERROR otherwise
+ *             (FloatPoint) *ret: The intersection point
+ */
+static int intersection(const Common::Point &a, const Common::Point &b, const Vertex *vertex, FloatPoint *ret) {
+	// Parameters of parametric equations
+	float s, t;
+	// Numerator and denominator of equations
+	float num, denom;
+	const Common::Point &c = vertex->v;
+	const Common::Point &d = CLIST_NEXT(vertex)->v;
+
+	denom = a.x * (float)(d.y - c.y) + b.x * (float)(c.y - d.y) +
+	        d.x * (float)(b.y - a.y) + c.x * (float)(a.y - b.y);
+
+	if (denom == 0.0)
+		// Segments are parallel, no intersection
+		return PF_ERROR;
+
+	num = a.x * (float)(d.y - c.y) + c.x * (float)(a.y - d.y) + d.x * (float)(c.y - a.y);
+
+	s = num / denom;
+
+	num = -(a.x * (float)(c.y - b.y) + b.x * (float)(a.y - c.y) + c.x * (float)(b.y - a.y));
+
+	t = num / denom;
+
+	if ((0.0 <= s) && (s <= 1.0) && (0.0 < t) && (t < 1.0)) {
+		// Intersection found
+		ret->x = a.x + s * (b.x - a.x);
+		ret->y = a.y + s * (b.y - a.y);
+		return PF_OK;
+	}
+
+	return PF_ERROR;
+}
+
+/**
+ * Computes the nearest intersection point of a line segment and the polygon
+ * set. Intersection points that are reached from the inside of a polygon
+ * are ignored as are improper intersections which do not obstruct
+ * visibility
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (const Common::Point &) p, q: The line segment (p, q)
+ * Returns   : (int) PF_OK on success, PF_ERROR when no intersections were
+ *                   found, PF_FATAL otherwise
+ *             (Common::Point) *ret: On success, the closest intersection point
+ */
+static int nearest_intersection(PathfindingState *s, const Common::Point &p, const Common::Point &q, Common::Point *ret) {
+	Polygon *polygon = 0;
+	FloatPoint isec;
+	Polygon *ipolygon = 0;
+	uint32 dist = HUGE_DISTANCE;
+
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+		polygon = *it;
+		Vertex *vertex;
+
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			uint32 new_dist;
+			FloatPoint new_isec;
+
+			// Check for intersection with vertex
+			if (between(p, q, vertex->v)) {
+				// Skip this vertex if we hit it from the
+				// inside of the polygon
+				if (inside(q, vertex)) {
+					new_isec.x = vertex->v.x;
+					new_isec.y = vertex->v.y;
+				} else
+					continue;
+			} else {
+				// Check for intersection with edges
+
+				// Skip this edge if we hit it from the
+				// inside of the polygon
+				if (!left(vertex->v, CLIST_NEXT(vertex)->v, q))
+					continue;
+
+				if (intersection(p, q, vertex, &new_isec) != PF_OK)
+					continue;
+			}
+
+			new_dist = p.sqrDist(new_isec.toPoint());
+			if (new_dist < dist) {
+				ipolygon = polygon;
+				isec = new_isec;
+				dist = new_dist;
+			}
+		}
+	}
+
+	if (dist == HUGE_DISTANCE)
+		return PF_ERROR;
+
+	// Find point not contained in polygon
+	return find_free_point(isec, ipolygon, ret);
+}
+
+/**
+ * Checks whether a point is nearby a contained-access polygon (distance 1 pixel)
+ * @param point			the point
+ * @param polygon		the contained-access polygon
+ * @return true when point is nearby polygon, false otherwise
+ */
+static bool nearbyPolygon(const Common::Point &point, Polygon *polygon) {
+	assert(polygon->type == POLY_CONTAINED_ACCESS);
+
+	return ((contained(Common::Point(point.x, point.y + 1), polygon) != CONT_INSIDE)
+			|| (contained(Common::Point(point.x, point.y - 1), polygon) != CONT_INSIDE)
+			|| (contained(Common::Point(point.x + 1, point.y), polygon) != CONT_INSIDE)
+			|| (contained(Common::Point(point.x - 1, point.y), polygon) != CONT_INSIDE));
+}
+
+/**
+ * Checks that the start point is in a valid position, and takes appropriate action if it's not.
+ * @param s				the pathfinding state
+ * @param start			the start point
+ * @return a valid start point on success, NULL otherwise
+ */
+static Common::Point *fixup_start_point(PathfindingState *s, const Common::Point &start) {
+	PolygonList::iterator it = s->polygons.begin();
+	Common::Point *new_start = new Common::Point(start);
+
+	while (it != s->polygons.end()) {
+		int cont = contained(start, *it);
+		int type = (*it)->type;
+
+		switch (type) {
+		case POLY_TOTAL_ACCESS:
+			// Remove totally accessible polygons that contain the start point
+			if (cont != CONT_OUTSIDE) {
+				delete *it;
+				it = s->polygons.erase(it);
+				continue;
+			}
+			break;
+		case POLY_CONTAINED_ACCESS:
+			// Remove contained access polygons that do not contain
+			// the start point (containment test is inverted here).
+			// SSCI appears to be using a small margin of error here,
+			// so we do the same.
+			if ((cont == CONT_INSIDE) && !nearbyPolygon(start, *it)) {
+				delete *it;
+				it = s->polygons.erase(it);
+				continue;
+			}
+			// Fall through
+		case POLY_BARRED_ACCESS:
+		case POLY_NEAREST_ACCESS:
+			if (cont != CONT_OUTSIDE) {
+				if (s->_prependPoint != NULL) {
+					// We shouldn't get here twice.
+					// We need to break in this case, otherwise we'll end in an infinite
+					// loop.
+					warning("AvoidPath: start point is contained in multiple polygons");
+					break;
+				}
+
+				if (s->findNearPoint(start, (*it), new_start) != PF_OK) {
+					delete new_start;
+					return NULL;
+				}
+
+				if ((type == POLY_BARRED_ACCESS) || (type == POLY_CONTAINED_ACCESS))
+					debugC(kDebugLevelAvoidPath, "AvoidPath: start position at unreachable location");
+
+				// The original start position is in an invalid location, so we
+				// use the moved point and add the original one to the final path
+				// later on.
+				if (start != *new_start)
+					s->_prependPoint = new Common::Point(start);
+			}
+		}
+
+		++it;
+	}
+
+	return new_start;
+}
+
+/**
+ * Checks that the end point is in a valid position, and takes appropriate action if it's not.
+ * @param s				the pathfinding state
+ * @param end			the end point
+ * @return a valid end point on success, NULL otherwise
+ */
+static Common::Point *fixup_end_point(PathfindingState *s, const Common::Point &end) {
+	PolygonList::iterator it = s->polygons.begin();
+	Common::Point *new_end = new Common::Point(end);
+
+	while (it != s->polygons.end()) {
+		int cont = contained(end, *it);
+		int type = (*it)->type;
+
+		switch (type) {
+		case POLY_TOTAL_ACCESS:
+			// Remove totally accessible polygons that contain the end point
+			if (cont != CONT_OUTSIDE) {
+				delete *it;
+				it = s->polygons.erase(it);
+				continue;
+			}
+			break;
+		case POLY_CONTAINED_ACCESS:
+		case POLY_BARRED_ACCESS:
+		case POLY_NEAREST_ACCESS:
+			if (cont != CONT_OUTSIDE) {
+				if (s->_appendPoint != NULL) {
+					// We shouldn't get here twice.
+					// Happens in LB2CD, inside the speakeasy when walking from the
+					// speakeasy (room 310) into the bathroom (room 320), after having
+					// consulted the notebook (bug #3036299).
+					// We need to break in this case, otherwise we'll end in an infinite
+					// loop.
+					warning("AvoidPath: end point is contained in multiple polygons");
+					break;
+				}
+
+				// The original end position is in an invalid location, so we move the point
+				if (s->findNearPoint(end, (*it), new_end) != PF_OK) {
+					delete new_end;
+					return NULL;
+				}
+
+				// For near-point access polygons we need to add the original end point
+				// to the path after pathfinding.
+				if ((type == POLY_NEAREST_ACCESS) && (end != *new_end))
+					s->_appendPoint = new Common::Point(end);
+			}
+		}
+
+		++it;
+	}
+
+	return new_end;
+}
+
+/**
+ * Merges a point into the polygon set. A new vertex is allocated for this
+ * point, unless a matching vertex already exists. If the point is on an
+ * already existing edge that edge is split up into two edges connected by
+ * the new vertex
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ *             (const Common::Point &) v: The point to merge
+ * Returns   : (Vertex *) The vertex corresponding to v
+ */
+static Vertex *merge_point(PathfindingState *s, const Common::Point &v) {
+	Vertex *vertex;
+	Vertex *v_new;
+	Polygon *polygon;
+
+	// Check for already existing vertex
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+		polygon = *it;
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			if (vertex->v == v)
+				return vertex;
+		}
+	}
+
+	v_new = new Vertex(v);
+
+	// Check for point being on an edge
+	for (PolygonList::iterator it = s->polygons.begin(); it != s->polygons.end(); ++it) {
+		polygon = *it;
+		// Skip single-vertex polygons
+		if (VERTEX_HAS_EDGES(polygon->vertices.first())) {
+			CLIST_FOREACH(vertex, &polygon->vertices) {
+				Vertex *next = CLIST_NEXT(vertex);
+
+				if (between(vertex->v, next->v, v)) {
+					// Split edge by adding vertex. The visibility of the
+					// other vertices may change, so the cached graph of
+					// the polygon set can not be used.
+					polygon->vertices.insertAfter(vertex, v_new);
+					s->_visibility = NULL;
+					return v_new;
+				}
+			}
+		}
+	}
+
+	// Add point as single-vertex polygon
+	polygon = new Polygon(POLY_BARRED_ACCESS);
+	polygon->vertices.insertHead(v_new);
+	s->polygons.push_front(polygon);
+	s->_firstGraphVertex++;
+
+	return v_new;
+}
+
+/**
+ * Converts the points of an SCI polygon into a Polygon
+ * Parameters: (const AvoidPathPolygon &) poly: The SCI polygon to convert
+ * Returns   : (Polygon *) The converted polygon
+ */
+static Polygon *convert_polygon(const AvoidPathPolygon &poly) {
+	Polygon *polygon = new Polygon(poly.type);
+
+	for (uint i = 0; i < poly.points.size(); i++) {
+		Vertex *vertex = new Vertex(poly.points[i]);
+		polygon->vertices.insertHead(vertex);
+	}
+
+	fix_vertex_order(polygon);
+
+	return polygon;
+}
+
+/**
+ * Changes the polygon list for optimization level 0 (used for keyboard
+ * support). Totally accessible polygons are removed and near-point
+ * accessible polygons are changed into totally accessible polygons.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void change_polygons_opt_0(PathfindingState *s) {
+
+	PolygonList::iterator it = s->polygons.begin();
+	while (it != s->polygons.end()) {
+		Polygon *polygon = *it;
+		assert(polygon);
+
+		if (polygon->type == POLY_TOTAL_ACCESS) {
+			delete polygon;
+			it = s->polygons.erase(it);
+		} else {
+			if (polygon->type == POLY_NEAREST_ACCESS)
+				polygon->type = POLY_TOTAL_ACCESS;
+			++it;
+		}
+	}
+}
+
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (const AvoidPathPolygonList &) polygons: The polygons
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ *             (uint) workarounds: AvoidPathWorkaround flags
+ *             (AvoidPathCache *) cache: The cache of visibility graphs, or NULL
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(const AvoidPathPolygonList &polygons, Common::Point start, Common::Point end, int width, int height, int opt, uint workarounds, AvoidPathCache *cache) {
+	Polygon *polygon;
+	int count = 0;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+	pf_s->_workarounds = workarounds;
+
+	// Convert all polygons
+	for (uint i = 0; i < polygons.size(); i++) {
+		pf_s->polygons.push_back(convert_polygon(polygons[i]));
+		count += polygons[i].points.size();
+	}
+
+	if (opt == 0)
+		change_polygons_opt_0(pf_s);
+
+	Common::Point *new_start = fixup_start_point(pf_s, start);
+
+	if (!new_start) {
+		warning("AvoidPath: Couldn't fixup start position for pathfinding");
+		delete pf_s;
+		return NULL;
+	}
+
+	Common::Point *new_end = fixup_end_point(pf_s, end);
+
+	if (!new_end) {
+		warning("AvoidPath: Couldn't fixup end position for pathfinding");
+		delete new_start;
+		delete pf_s;
+		return NULL;
+	}
+
+	if (opt == 0) {
+		// Keyboard support. Only the first edge of the path we compute
+		// here matches the path returned by SSCI. This is assumed to be
+		// sufficient as all known use cases only use the first two
+		// vertices of the returned path.
+		// Pharkas uses this mode for a secondary polygon set containing
+		// rectangular polygons used to block an actor's path.
+
+		// If we have a prepended point, we do nothing here as the
+		// actor is in barred territory and should be moved outside of
+		// it ASAP. This matches the behavior of SSCI.
+		if (!pf_s->_prependPoint) {
+			// Actor position is OK, find nearest obstacle.
+			int err = nearest_intersection(pf_s, start, *new_end, new_start);
+
+			if (err == PF_FATAL) {
+				warning("AvoidPath: error finding nearest intersection");
+				delete new_start;
+				delete new_end;
+				delete pf_s;
+				return NULL;
+			}
+
+			if (err == PF_OK)
+				pf_s->_prependPoint = new Common::Point(start);
+		}
+	} else {
+		// WORKAROUND LSL5 room 660. Priority glitch due to us choosing a different path
+		// than SSCI. Happens when Patti walks to the control room.
+		if ((workarounds & kAvoidPathLSL5Room660) && (Common::Point(67, 131) == *new_start) && (Common::Point(229, 101) == *new_end)) {
+			debug(1, "[avoidpath] Applying fix for priority problem in LSL5, room 660");
+			pf_s->_prependPoint = new_start;
+			new_start = new Common::Point(77, 107);
+		}
+	}
+
+	// Look up the visibility of the polygon vertices, before the start and
+	// end points are added
+	if (cache) {
+		Common::Array<uint16> polygonSizes;
+		Common::Array<Common::Point> points;
+
+		for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+			Vertex *vertex;
+			uint16 size = 0;
+
+			CLIST_FOREACH(vertex, &(*it)->vertices) {
+				points.push_back(vertex->v);
+				size++;
+			}
+
+			polygonSizes.push_back(size);
+		}
+
+		pf_s->_visibility = cache->getGraph(polygonSizes, points);
+	}
+
+	// Merge start and end points into polygon set
+	pf_s->vertex_start = merge_point(pf_s, *new_start);
+	pf_s->vertex_end = merge_point(pf_s, *new_end);
+
+	delete new_start;
+	delete new_end;
+
+	// Allocate and build vertex index
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+
+	count = 0;
+
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it) {
+		polygon = *it;
+		Vertex *vertex;
+
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
+			pf_s->vertex_index[count++] = vertex;
+		}
+	}
+
+	pf_s->vertices = count;
+
+	return pf_s;
+}
+
+/**
+ * Computes a shortest path from vertex_start to vertex_end. The caller can
+ * construct the resulting path by following the path_prev links from
+ * vertex_end back to vertex_start. If no path exists vertex_end->path_prev
+ * will be NULL.
+ * This version searches the open set linearly and tests the visibility of
+ * all vertices again for each visited vertex. AStar() finds the same path.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void AStarList(PathfindingState *s) {
+	// Vertices of which the shortest path is known
+	VertexList closedSet;
+
+	// The remaining vertices
+	VertexList openSet;
+
+	openSet.push_front(s->vertex_start);
+	s->vertex_start->costG = 0;
+	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+
+	while (!openSet.empty()) {
+		// Find vertex in open set with lowest F cost
+		VertexList::iterator vertex_min_it = openSet.end();
+		Vertex *vertex_min = 0;
+		uint32 min = HUGE_DISTANCE;
+
+		for (VertexList::iterator it = openSet.begin(); it != openSet.end(); ++it) {
+			Vertex *vertex = *it;
+			if (vertex->costF < min) {
+				vertex_min_it = it;
+				vertex_min = *vertex_min_it;
+				min = vertex->costF;
+			}
+		}
+
+		assert(vertex_min != 0);	// the vertex cost should never be bigger than HUGE_DISTANCE
+
+		// Check if we are done
+		if (vertex_min == s->vertex_end)
+			break;
+
+		// Move vertex from set open to set closed
+		closedSet.push_front(vertex_min);
+		openSet.erase(vertex_min_it);
+
+		VertexList *visVerts = visible_vertices(s, vertex_min);
+
+		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
+			uint32 new_dist;
+			Vertex *vertex = *it;
+
+			if (closedSet.contains(vertex))
+				continue;
+
+			if (!openSet.contains(vertex))
+				openSet.push_front(vertex);
+
+			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
+
+			// When travelling to a vertex on the screen edge, we
+			// add a penalty score to make this path less appealing.
+			// NOTE: If an obstacle has only one vertex on a screen edge,
+			// later SSCI pathfinders will treat that vertex like any
+			// other, while we apply a penalty to paths traversing it.
+			// This difference might lead to problems, but none are
+			// known at the time of writing.
+
+			// WORKAROUND: This check fails in QFG1VGA, room 81 (bug report #3568452).
+			// However, it is needed in other SCI1.1 games, such as LB2. Therefore, we
+			// add this workaround for that scene in QFG1VGA, until our algorithm matches
+			// better what SSCI is doing. With this workaround, QFG1VGA no longer freezes
+			// in that scene.
+			bool qfg1VgaWorkaround = (s->_workarounds & kAvoidPathQFG1VGARoom81) != 0;
+
+			if (s->pointOnScreenBorder(vertex->v) && !qfg1VgaWorkaround)
+				new_dist += 10000;
+
+			if (new_dist < vertex->costG) {
+				vertex->costG = new_dist;
+				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
+				vertex->path_prev = vertex_min;
+			}
+		}
+
+		delete visVerts;
+	}
+
+	if (openSet.empty())
+		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
+}
+
+struct OpenVertex {
+	uint32 costF;
+	uint32 order;	// Number of vertices opened before this one
+	Vertex *vertex;
+
+	OpenVertex() : costF(0), order(0), vertex(0) {}
+	OpenVertex(uint32 c, uint32 o, Vertex *v) : costF(c), order(o), vertex(v) {}
+};
+
+typedef Common::Array<OpenVertex> OpenSet;
+
+static bool isBefore(const OpenVertex &a, const OpenVertex &b) {
+	// Of vertices with equal costs, AStarList() takes the one which was
+	// opened last, so we do the same
+	if (a.costF != b.costF)
+		return a.costF < b.costF;
+	return a.order > b.order;
+}
+
+static void pushOpen(OpenSet &openSet, const OpenVertex &entry) {
+	openSet.push_back(entry);
+
+	// Sift the new entry up
+	uint i = openSet.size() - 1;
+	while (i > 0) {
+		const uint parent = (i - 1) / 2;
+		if (!isBefore(openSet[i], openSet[parent]))
+			break;
+		SWAP(openSet[i], openSet[parent]);
+		i = parent;
+	}
+}
+
+static OpenVertex popOpen(OpenSet &openSet) {
+	OpenVertex entry = openSet[0];
+
+	openSet[0] = openSet.back();
+	openSet.pop_back();
+
+	// Sift the moved entry down
+	const uint size = openSet.size();
+	uint i = 0;
+	for (;;) {
+		uint best = i;
+		const uint leftChild = 2 * i + 1;
+		const uint rightChild = leftChild + 1;
+		if (leftChild < size && isBefore(openSet[leftChild], openSet[best]))
+			best = leftChild;
+		if (rightChild < size && isBefore(openSet[rightChild], openSet[best]))
+			best = rightChild;
+		if (best == i)
+			break;
+		SWAP(openSet[i], openSet[best]);
+		i = best;
+	}
+
+	return entry;
+}
+
+/**
+ * Computes a shortest path from vertex_start to vertex_end, like
+ * AStarList(), with a binary heap as open set. The visibility of the
+ * polygon vertices is taken from the visibility graph of the state, if it
+ * has one.
+ * Parameters: (PathfindingState *) s: The pathfinding state
+ */
+static void AStar(PathfindingState *s) {
+	enum {
+		kUnseen = 0,
+		kOpen = 1,
+		kClosed = 2
+	};
+
+	// The state of each vertex, and the order in which they were opened
+	Common::Array<byte> status;
+	Common::Array<uint32> order;
+	status.resize(s->vertices);
+	order.resize(s->vertices);
+	uint32 opened = 0;
+
+	// The open set may hold outdated entries of vertices whose costs were
+	// lowered later on, or which are closed already. They are skipped.
+	OpenSet openSet;
+
+	// See AStarList() for the penalty on the screen border
+	const bool borderPenalty = !(s->_workarounds & kAvoidPathQFG1VGARoom81);
+
+	Vertex *vertex_start = s->vertex_start;
+	vertex_start->costG = 0;
+	vertex_start->costF = (uint32)sqrt((float)vertex_start->v.sqrDist(s->vertex_end->v));
+	status[vertex_start->index] = kOpen;
+	order[vertex_start->index] = opened++;
+	pushOpen(openSet, OpenVertex(vertex_start->costF, order[vertex_start->index], vertex_start));
+
+	bool found = false;
+
+	while (!openSet.empty()) {
+		const OpenVertex entry = popOpen(openSet);
+		Vertex *vertex_min = entry.vertex;
+
+		if (status[vertex_min->index] == kClosed || entry.costF != vertex_min->costF)
+			continue;
+
+		// Check if we are done
+		if (vertex_min == s->vertex_end) {
+			found = true;
+			break;
+		}
+
+		status[vertex_min->index] = kClosed;
+
+		// Visit the visible vertices in the same order as AStarList()
+		for (int i = s->vertices - 1; i >= 0; i--) {
+			Vertex *vertex = s->vertex_index[i];
+
+			if (status[i] == kClosed || !is_visible_cached(s, vertex_min, vertex))
+				continue;
+
+			if (status[i] == kUnseen) {
+				status[i] = kOpen;
+				order[i] = opened++;
+			}
+
+			uint32 new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
+
+			if (borderPenalty && s->pointOnScreenBorder(vertex->v))
+				new_dist += 10000;
+
+			if (new_dist < vertex->costG) {
+				vertex->costG = new_dist;
+				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
+				vertex->path_prev = vertex_min;
+				pushOpen(openSet, OpenVertex(vertex->costF, order[i], vertex));
+			}
+		}
+	}
+
+	if (!found)
+		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
+}
+
+/**
+ * Collects the points of the final path
+ * Parameters: (PathfindingState *) p: The pathfinding state
+ *             (Common::Array<Common::Point> &) path: Set to the points of the path
+ * Returns   : (int) The number of vertices on the path found by AStar, 0 if
+ *                   the end point is unreachable
+ */
+static int get_path(PathfindingState *p, Common::Array<Common::Point> &path) {
+	int path_len = 0;
+	Vertex *vertex = p->vertex_end;
+	int unreachable = vertex->path_prev == NULL;
+
+	path.clear();
+
+	if (unreachable) {
+		// If pathfinding failed we only return the path up to vertex_start
+
+		if (p->_prependPoint)
+			path.push_back(*p->_prependPoint);
+		else
+			path.push_back(p->vertex_start->v);
+
+		path.push_back(p->vertex_start->v);
+
+		return 0;
+	}
+
+	while (vertex) {
+		// Compute path length
+		path_len++;
+		vertex = vertex->path_prev;
+	}
+
+	if (p->_prependPoint)
+		path.push_back(*p->_prependPoint);
+
+	const int offset = path.size();
+	path.resize(offset + path_len);
+
+	vertex = p->vertex_end;
+	for (int i = path_len - 1; i >= 0; i--) {
+		path[offset + i] = vertex->v;
+		vertex = vertex->path_prev;
+	}
+
+	if (p->_appendPoint)
+		path.push_back(*p->_appendPoint);
+
+	return path_len;
+}
+
+int findAvoidPath(const AvoidPathPolygonList &polygons, const Common::Point &start, const Common::Point &end,
+				  int width, int height, int opt, uint workarounds, AvoidPathCache *cache,
+				  Common::Array<Common::Point> &path) {
+	PathfindingState *p = convert_polygon_set(polygons, start, end, width, height, opt, workarounds, cache);
+
+	if (!p)
+		return -1;
+
+	if (cache)
+		AStar(p);
+	else
+		AStarList(p);
+
+	int path_len = get_path(p, path);
+	delete p;
+
+	return path_len;
+}
+
+// ==========================================================================
+// kMergePoly utility functions
+
+// Compute square of the distance of p to the segment a-b.
+static float pointSegDistance(const Common::Point &a, const Common::Point &b,
+                              const Common::Point &p) {
+	FloatPoint ba(b-a);
+	FloatPoint pa(p-a);
+	FloatPoint bp(b-p);
+
+	// Check if the projection of p on the line a-b lies between a and b
+	if (ba*pa >= 0.0f && ba*bp >= 0.0f) {
+		// If yes, return the (squared) distance of p to the line a-b:
+		// translate a to origin, project p and subtract
+		float linedist = (ba*((ba*pa)/(ba*ba)) - pa).norm();
+
+		return linedist;
+	} else {
+		// If no, return the (squared) distance to either a or b, whichever
+		// is closest.
+
+		// distance to a:
+		float adist = pa.norm();
+		// distance to b:
+		float bdist = FloatPoint(p-b).norm();
+
+		return MIN(adist, bdist);
+	}
+}
+
+// find intersection between edges of two polygons.
+// endpoints count, except v2->_next
+static bool segSegIntersect(const Vertex *v1, const Vertex *v2, Common::Point &intp) {
+	const Common::Point &a = v1->v;
+	const Common::Point &b = v1->_next->v;
+	const Common::Point &c = v2->v;
+	const Common::Point &d = v2->_next->v;
+
+	// First handle the endpoint cases manually
+
+	if (collinear(a, b, c) && collinear(a, b, d))
+		return false;
+
+	if (collinear(a, b, c)) {
+		// a, b, c collinear
+		// return true/c if c is between a and b
+		intp = c;
+		if (a.x != b.x) {
+			if ((a.x <= c.x && c.x <= b.x) || (b.x <= c.x && c.x <= a.x))
+				return true;
+		} else {
+			if ((a.y <= c.y && c.y <= b.y) || (b.y <= c.y && c.y <= a.y))
+				return true;
+		}
+	}
+
+	if (collinear(a, b, d)) {
+		intp = d;
+		// a, b, d collinear
+		// return false/d if d is between a and b
+		if (a.x != b.x) {
+			if ((a.x <= d.x && d.x <= b.x) || (b.x <= d.x && d.x <= a.x))
+				return false;
+		} else {
+			if ((a.y <= d.y && d.y <= b.y) || (b.y <= d.y && d.y <= a.y))
+				return false;
+		}
+	}
+
+	int len_dc = c.sqrDist(d);
+
+	if (!len_dc) error("zero length edge in polygon");
+
+	if (pointSegDistance(c, d, a) <= 2.0f) {
+		intp = a;
+		return true;
+	}
+
+	if (pointSegDistance(c, d, b) <= 2.0f) {
+		intp = b;
+		return true;
+	}
+
+	// If not an endpoint, call the generic intersection function
+
+	FloatPoint p;
+	if (intersection(a, b, v2, &p) == PF_OK) {
+		intp = p.toPoint();
+		return true;
+	} else {
+		return false;
+	}
+}
+
+// For intersecting polygon segments, determine if
+// * the v2 edge enters polygon 1 at this intersection: positive return value
+// * the v2 edge and the v1 edges are parallel: zero return value
+// * the v2 edge exits polygon 1 at this intersection: negative return value
+static int intersectDir(const Vertex *v1, const Vertex *v2) {
+	Common::Point p1 = v1->_next->v - v1->v;
+	Common::Point p2 = v2->_next->v - v2->v;
+	return (p1.x*p2.y - p2.x*p1.y);
+}
+
+// Direction of edge in degrees from pos. x-axis, between -180 and 180
+static int edgeDir(const Vertex *v) {
+	Common::Point p = v->_next->v - v->v;
+	int deg = (int)Common::rad2deg((float)atan2((double)p.y, (double)p.x));
+	if (deg < -180) deg += 360;
+	if (deg > 180) deg -= 360;
+	return deg;
+}
+
+// For points p1, p2 on the polygon segment v, determine if
+// * p1 lies before p2: negative return value
+// * p1 and p2 are the same: zero return value
+// * p1 lies after p2: positive return value
+static int liesBefore(const Vertex *v, const Common::Point &p1, const Common::Point &p2) {
+	return v->v.sqrDist(p1) - v->v.sqrDist(p2);
+}
+
+// Structure describing an "extension" to the work polygon following edges
+// of the polygon being merged.
+
+// The patch begins on the point intersection1, being the intersection
+// of the edges starting at indexw1/vertexw1 on the work polygon, and at
+// indexp1/vertexp1 on the polygon being merged.
+// It ends with the point intersection2, being the analogous intersection.
+struct Patch {
+	uint32 indexw1;
+	uint32 indexp1;
+	const Vertex *vertexw1;
+	const Vertex *vertexp1;
+	Common::Point intersection1;
+
+	uint32 indexw2;
+	uint32 indexp2;
+	const Vertex *vertexw2;
+	const Vertex *vertexp2;
+	Common::Point intersection2;
+
+	bool disabled; // If true, this Patch was made superfluous by another Patch
+};
+
+
+// Check if the given vertex on the work polygon is bypassed by this patch.
+static bool isVertexCovered(const Patch &p, uint32 wi) {
+
+	//         /             v       (outside)
+	//  ---w1--1----p----w2--2----
+	//         ^             \       (inside)
+	if (wi > p.indexw1 && wi <= p.indexw2)
+		return true;
+
+	//         v             /       (outside)
+	//  ---w2--2----p----w1--1----
+	//         \             ^       (inside)
+	if (p.indexw1 > p.indexw2 && (wi <= p.indexw2 || wi > p.indexw1))
+		return true;
+
+	//         v  /                  (outside)
+	//  ---w1--2--1-------p-----
+	//     w2  \  ^                  (inside)
+	if (p.indexw1 == p.indexw2 && liesBefore(p.vertexw1, p.intersection1, p.intersection2) > 0)
+		return true; // This patch actually covers _all_ vertices on work
+
+	return false;
+}
+
+// Check if patch p1 makes patch p2 superfluous.
+static bool isPatchCovered(const Patch &p1, const Patch &p2) {
+
+	// Same exit and entry points
+	if (p1.intersection1 == p2.intersection1 && p1.intersection2 == p2.intersection2)
+		return true;
+
+	//           /         *         v       (outside)
+	//  ---p1w1--1----p2w1-1---p1w2--2----
+	//           ^         *         \       (inside)
+	if (p1.indexw1 < p2.indexw1 && p2.indexw1 < p1.indexw2)
+		return true;
+	if (p1.indexw1 > p1.indexw2 && (p2.indexw1 > p1.indexw1 || p2.indexw1 < p1.indexw2))
+		return true;
+
+
+	//            /         *          v       (outside)
+	//  ---p1w1--11----p2w2-2---p1w2--12----
+	//            ^         *          \       (inside)
+	if (p1.indexw1 < p2.indexw2 && p2.indexw2 < p1.indexw2)
+		return true;
+	if (p1.indexw1 > p1.indexw2 && (p2.indexw2 > p1.indexw1 || p2.indexw2 < p1.indexw2))
+		return true;
+
+	// Opposite of two above situations
+	if (p2.indexw1 < p1.indexw1 && p1.indexw1 < p2.indexw2)
+		return false;
+	if (p2.indexw1 > p2.indexw2 && (p1.indexw1 > p2.indexw1 || p1.indexw1 < p2.indexw2))
+		return false;
+
+	if (p2.indexw1 < p1.indexw2 && p1.indexw2 < p2.indexw2)
+		return false;
+	if (p2.indexw1 > p2.indexw2 && (p1.indexw2 > p2.indexw1 || p1.indexw2 < p2.indexw2))
+		return false;
+
+
+	// The above checks covered the cases where one patch covers the other and
+	// the intersections of the patches are on different edges.
+
+	// So, if we passed the above checks, we have to check the order of
+	// intersections on edges.
+
+
+	if (p1.indexw1 != p1.indexw2) {
+
+		//            /    *              v       (outside)
+		//  ---p1w1--11---21--------p1w2--2----
+		//     p2w1   ^    *              \       (inside)
+		if (p1.indexw1 == p2.indexw1)
+			return (liesBefore(p1.vertexw1, p1.intersection1, p2.intersection1) < 0);
+
+		//            /                *    v       (outside)
+		//  ---p1w1--11---------p1w2--21---12----
+		//            ^         p2w1   *    \       (inside)
+		if (p1.indexw2 == p2.indexw1)
+			return (liesBefore(p1.vertexw2, p1.intersection2, p2.intersection1) > 0);
+
+		// If neither of the above, then the intervals of the polygon
+		// covered by patch1 and patch2 are disjoint
+		return false;
+	}
+
+	// p1w1 == p1w2
+	// Also, p1w1/p1w2 isn't strictly between p2
+
+
+	//            v   /             *      (outside)
+	//  ---p1w1--12--11-------p2w1-21----
+	//     p1w2   \   ^             *      (inside)
+
+	//            v   /   /               (outside)
+	//  ---p1w1--12--21--11---------
+	//     p1w2   \   ^   ^               (inside)
+	//     p2w1
+	if (liesBefore(p1.vertexw1, p1.intersection1, p1.intersection2) > 0)
+		return (p1.indexw1 != p2.indexw1);
+
+	// CHECKME: This is meaningless if p2w1 != p2w2 ??
+	if (liesBefore(p2.vertexw1, p2.intersection1, p2.intersection2) > 0)
+		return false;
+
+	// CHECKME: This is meaningless if p1w1 != p2w1 ??
+	if (liesBefore(p2.vertexw1, p2.intersection1, p1.intersection1) <= 0)
+		return false;
+
+	// CHECKME: This is meaningless if p1w2 != p2w1 ??
+	if (liesBefore(p2.vertexw1, p2.intersection1, p1.intersection2) >= 0)
+		return false;
+
+	return true;
+}
+
+// Merge a single polygon into the work polygon.
+// If there is an intersection between work and polygon, this function
+// returns true, and replaces the vertex list of work by an extended version,
+// that covers polygon.
+//
+// NOTE: The strategy used matches qfg1new closely, and is a bit error-prone.
+// A more robust strategy would be inserting all intersection points directly
+// into both vertex lists as a first pass. This would make finding the merged
+// polygon a much more straightforward edge-walk, and avoid cases where SSCI's
+// algorithm mixes up the order of multiple intersections on a single edge.
+bool mergeSinglePolygon(Polygon &work, const Polygon &polygon) {
+#ifdef DEBUG_MERGEPOLY
+	const Vertex *vertex;
+	debugN("work:");
+	CLIST_FOREACH(vertex, &(work.vertices)) {
+		debugN(" (%d,%d) ", vertex->v.x, vertex->v.y);
+	}
+	debugN("\n");
+	debugN("poly:");
+	CLIST_FOREACH(vertex, &(polygon.vertices)) {
+		debugN(" (%d,%d) ", vertex->v.x, vertex->v.y);
+	}
+	debugN("\n");
+#endif
+	uint workSize = work.vertices.size();
+	uint polygonSize = polygon.vertices.size();
+
+	int patchCount = 0;
+	Patch patchList[8];
+
+	const Vertex *workv = work.vertices._head;
+	const Vertex *polyv = polygon.vertices._head;
+	for (uint wi = 0; wi < workSize; ++wi, workv = workv->_next) {
+		for (uint pi = 0; pi < polygonSize; ++pi, polyv = polyv->_next) {
+			Common::Point intersection1;
+			Common::Point intersection2;
+
+			bool intersects = segSegIntersect(workv, polyv, intersection1);
+			if (!intersects)
+				continue;
+
+#ifdef DEBUG_MERGEPOLY
+			debug("mergePoly: intersection at work %d, poly %d", wi, pi);
+#endif
+
+			if (intersectDir(workv, polyv) >= 0)
+				continue;
+
+#ifdef DEBUG_MERGEPOLY
+			debug("mergePoly: intersection in right direction");
+#endif
+
+			int angle = 0;
+			int baseAngle = edgeDir(workv);
+
+			// We now found the point where an edge of 'polygon' left 'work'.
+			// Now find the re-entry point.
+
+			// NOTE: The order in which this searches does not always work
+			// properly if the correct patch would only use a single partial
+			// edge of poly. Because it starts at polyv->_next, it will skip
+			// the correct re-entry and proceed to the next.
+
+			const Vertex *workv2;
+			const Vertex *polyv2 = polyv->_next;
+
+			intersects = false;
+
+			uint pi2, wi2;
+			for (pi2 = 0; pi2 < polygonSize; ++pi2, polyv2 = polyv2->_next) {
+
+				int newAngle = edgeDir(polyv2);
+
+				int relAngle = newAngle - baseAngle;
+				if (relAngle > 180) relAngle -= 360;
+				if (relAngle < -180) relAngle += 360;
+
+				angle += relAngle;
+				baseAngle = newAngle;
+
+				workv2 = workv;
+				for (wi2 = 0; wi2 < workSize; ++wi2, workv2 = workv2->_next) {
+					intersects = segSegIntersect(workv2, polyv2, intersection2);
+					if (!intersects)
+						continue;
+#ifdef DEBUG_MERGEPOLY
+					debug("mergePoly: re-entry intersection at work %d, poly %d", (wi + wi2) % workSize, (pi + 1 + pi2) % polygonSize);
+#endif
+
+					if (intersectDir(workv2, polyv2) > 0) {
+#ifdef DEBUG_MERGEPOLY
+						debug("mergePoly: re-entry intersection in right direction, angle = %d", angle);
+#endif
+						break; // found re-entry point
+					}
+
+				}
+
+				if (intersects)
+					break;
+
+			}
+
+			if (!intersects || angle < 0)
+				continue;
+
+
+			if (patchCount >= 8)
+				error("kMergePoly: Too many patches");
+
+			// convert relative to absolute vertex indices
+			pi2 = (pi + 1 + pi2) % polygonSize;
+			wi2 = (wi + wi2) % workSize;
+
+			Patch &newPatch = patchList[patchCount];
+			newPatch.indexw1 = wi;
+			newPatch.vertexw1 = workv;
+			newPatch.indexp1 = pi;
+			newPatch.vertexp1 = polyv;
+			newPatch.intersection1 = intersection1;
+
+			newPatch.indexw2 = wi2;
+			newPatch.vertexw2 = workv2;
+			newPatch.indexp2 = pi2;
+			newPatch.vertexp2 = polyv2;
+			newPatch.intersection2 = intersection2;
+			newPatch.disabled = false;
+
+#ifdef DEBUG_MERGEPOLY
+			debug("mergePoly: adding patch at work %d, poly %d", wi, pi);
+#endif
+
+			if (patchCount == 0) {
+				patchCount++;
+				continue;
+			}
+
+			bool necessary = true;
+			for (int i = 0; i < patchCount; ++i) {
+				if (isPatchCovered(patchList[i], newPatch)) {
+					necessary = false;
+					break;
+				}
+			}
+
+			if (!necessary)
+				continue;
+
+			patchCount++;
+
+			if (patchCount > 1) {
+				// check if this patch makes other patches superfluous
+				for (int i = 0; i < patchCount-1; ++i)
+					if (isPatchCovered(newPatch, patchList[i]))
+						patchList[i].disabled = true;
+			}
+		}
+	}
+
+
+	if (patchCount == 0)
+		return false; // nothing changed
+
+
+	// Determine merged work by doing a walk over the edges
+	// of work, crossing over to polygon when encountering a patch.
+
+	Polygon output(0);
+
+	workv = work.vertices._head;
+	for (uint wi = 0; wi < workSize; ++wi, workv = workv->_next) {
+
+		bool covered = false;
+		for (int p = 0; p < patchCount; ++p) {
+			if (patchList[p].disabled) continue;
+			if (isVertexCovered(patchList[p], wi)) {
+				covered = true;
+				break;
+			}
+		}
+
+		if (!covered) {
+			// Add vertex to output
+			output.vertices.insertAtEnd(new Vertex(workv->v));
+		}
+
+
+		// CHECKME: Why is this the correct order in which to process
+		// the patches? (What if two of them start on this line segment
+		// in the opposite order?)
+
+		for (int p = 0; p < patchCount; ++p) {
+
+			const Patch &patch = patchList[p];
+			if (patch.disabled) continue;
+			if (patch.indexw1 != wi) continue;
+			if (patch.intersection1 != workv->v) {
+				// Add intersection point to output
+				output.vertices.insertAtEnd(new Vertex(patch.intersection1));
+			}
+
+			// Add vertices from polygon between vertexp1 (excl) and vertexp2 (incl)
+			for (polyv = patch.vertexp1->_next; polyv != patch.vertexp2; polyv = polyv->_next)
+				output.vertices.insertAtEnd(new Vertex(polyv->v));
+
+			output.vertices.insertAtEnd(new Vertex(patch.vertexp2->v));
+
+			if (patch.intersection2 != patch.vertexp2->v) {
+				// Add intersection point to output
+				output.vertices.insertAtEnd(new Vertex(patch.intersection2));
+			}
+
+			// TODO: We could continue after the re-entry point here?
+		}
+	}
+	// Remove last vertex if it's the same as the first vertex
+	if (output.vertices._head->v == output.vertices._head->_prev->v)
+		output.vertices.remove(output.vertices._head->_prev);
+
+
+	// Slight hack: swap vertex lists of output and work polygons.
+	SWAP(output.vertices._head, work.vertices._head);
+
+	return true;
+}
+
+bool avoidPathPolygonContains(const AvoidPathPolygon &polygon, const Common::Point &point) {
+	Polygon *converted = convert_polygon(polygon);
+
+	// Override polygon type to prevent inverted result for contained access polygons
+	converted->type = POLY_BARRED_ACCESS;
+
+	bool result = contained(point, converted) != CONT_OUTSIDE;
+	delete converted;
+	return result;
+}
+
+bool mergeAvoidPathPolygon(Common::Array<Common::Point> &work, const AvoidPathPolygon &polygon) {
+	Polygon workPolygon(0);
+
+	for (uint i = 0; i < work.size(); i++)
+		workPolygon.vertices.insertAtEnd(new Vertex(work[i]));
+
+	Polygon *converted = convert_polygon(polygon);
+
+	// CHECKME: Confirm vertex order that convert_polygon and
+	// fix_vertex_order output. For now, we re-reverse the order since
+	// convert_polygon reads the vertices reversed, and fix up head.
+	converted->vertices.reverse();
+	converted->vertices._head = converted->vertices._head->_next;
+
+	bool intersected = mergeSinglePolygon(workPolygon, *converted);
+	delete converted;
+
+	if (!intersected)
+		return false;
+
+	work.clear();
+
+	Vertex *vertex;
+	CLIST_FOREACH(vertex, &workPolygon.vertices)
+		work.push_back(vertex->v);
+
+	return true;
+}
+
+} // End of namespace Sci
@@ -82,6 +82,12 @@ void Script::load(int script_nr, ResourceManager *resMan, ScriptPatcher *scriptP
 	_nr = script_nr;
 	_bufSize = _scriptSize = script->size;
 
+	// Room scripts usually share their number with the picture and messages
+	// of the room. Hint these, so that they get loaded while the engine idles
+	// instead of when the room first draws.
+	resMan->prefetchResource(ResourceId(kResourceTypePic, script_nr));
+	resMan->prefetchResource(ResourceId(kResourceTypeMessage, script_nr));
+
 	if (getSciVersion() == SCI_VERSION_0_EARLY) {
 		_bufSize += READ_LE_UINT16(script->data) * 2;
 	} else if (getSciVersion() >= SCI_VERSION_1_1 && getSciVersion() <= SCI_VERSION_2_1_LATE) {
@@ -28,6 +28,7 @@
 
 #include "sci/engine/file.h"
 #include "sci/engine/kernel.h"
+#include "sci/engine/kpathing.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/vm.h"
@@ -72,11 +73,14 @@ EngineState::EngineState(SegManager *segMan)
 : _segMan(segMan),
 	_dirseeker() {
 
+	_avoidPathCache = new AvoidPathCache();
+
 	reset(false);
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _avoidPathCache;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -43,6 +43,7 @@ class WriteStream;
 
 namespace Sci {
 
+class AvoidPathCache;
 class FileHandle;
 class DirSeeker;
 class EventManager;
@@ -193,6 +194,8 @@ public:
 
 	MessageState *_msgState;
 
+	AvoidPathCache *_avoidPathCache; /**< Visibility graphs of the polygon sets of kAvoidPath */
+
 	// MemorySegment provides access to a 256-byte block of memory that remains
 	// intact across restarts and restores
 	enum {
@@ -401,6 +401,12 @@ void SciEngine::sleep(uint32 msecs) {
 		_eventMan->getSciEvent(SCI_EVENT_PEEK);
 		time = g_system->getMillis();
 		if (time + 10 < wakeUpTime) {
+			// Use the idle time to load resources hinted by the scripts,
+			// instead of loading them on demand while the game runs
+			if (_resMan->isPrefetchPending()) {
+				_resMan->processPrefetchQueue(wakeUpTime - time - 10);
+				continue;
+			}
 			g_system->delayMillis(10);
 		} else {
 			if (time < wakeUpTime)
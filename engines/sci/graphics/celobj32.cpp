@@ -20,6 +20,7 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "sci/resource.h"
 #include "sci/engine/seg_manager.h"
 #include "sci/engine/state.h"
@@ -89,9 +90,10 @@ void CelObj::init() {
 	CelObj::deinit();
 	_drawBlackLines = false;
 	_nextCacheId = 1;
+	_cacheBasePriority = 0;
 	_scaler = new CelScaler();
 	_cache = new CelCache;
-	_cache->resize(100);
+	resetCacheStats();
 }
 
 void CelObj::deinit() {
@@ -99,7 +101,7 @@ void CelObj::deinit() {
 	_scaler = nullptr;
 	if (_cache != nullptr) {
 		for (CelCache::iterator it = _cache->begin(); it != _cache->end(); ++it) {
-			delete it->celObj;
+			delete it->_value.celObj;
 		}
 	}
 	delete _cache;
@@ -579,47 +581,86 @@ void CelObj::submitPalette() const {
 #pragma mark CelObj - Caching
 
 int CelObj::_nextCacheId = 1;
+uint32 CelObj::_cacheBasePriority = 0;
 CelCache *CelObj::_cache = nullptr;
+uint CelObj::_cacheCapacity = 500;
+bool CelObj::_precacheViews = false;
+bool CelObj::_precaching = false;
+CelCacheStats CelObj::_cacheStats;
 
-int CelObj::searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const {
-	*nextInsertIndex = -1;
-	int oldestId = _nextCacheId + 1;
-	int oldestIndex = 0;
-
-	for (int i = 0, len = _cache->size(); i < len; ++i) {
-		CelCacheEntry &entry = (*_cache)[i];
+void CelObj::resetCacheStats() {
+	memset(&_cacheStats, 0, sizeof(_cacheStats));
+}
 
-		if (entry.celObj == nullptr) {
-			if (*nextInsertIndex == -1) {
-				*nextInsertIndex = i;
-			}
-		} else if (entry.celObj->_info == celInfo) {
-			entry.id = ++_nextCacheId;
-			return i;
-		} else if (oldestId > entry.id) {
-			oldestId = entry.id;
-			oldestIndex = i;
+CelCacheEntry *CelObj::searchCache(const CelInfo32 &celInfo) const {
+	CelCache::iterator it = _cache->find(celInfo);
+	if (it == _cache->end()) {
+		if (!_precaching) {
+			++_cacheStats.misses;
 		}
+		return nullptr;
 	}
 
-	if (*nextInsertIndex == -1) {
-		*nextInsertIndex = oldestIndex;
+	if (!_precaching) {
+		++_cacheStats.hits;
 	}
 
-	return -1;
+	CelCacheEntry &entry = it->_value;
+	entry.id = ++_nextCacheId;
+	entry.priority = _cacheBasePriority + entry.cost;
+	return &entry;
 }
 
-void CelObj::putCopyInCache(const int cacheIndex) const {
-	if (cacheIndex == -1) {
-		error("Invalid cache index");
+/**
+ * A cache entry which can be replaced, in the order of
+ * replacement.
+ */
+struct CelCacheVictim {
+	uint32 priority;
+	int id;
+	CelInfo32 info;
+
+	bool operator<(const CelCacheVictim &other) const {
+		return priority < other.priority || (priority == other.priority && id < other.id);
 	}
+};
+
+void CelObj::putCopyInCache(const bool scannedPixels) const {
+	if (_cache->size() >= _cacheCapacity) {
+		// Replace the entries with the lowest priority, or the
+		// least recently used ones of them. An eighth of the
+		// cache is replaced at once, so it is only searched
+		// once every so many new cels.
+		Common::Array<CelCacheVictim> victims;
+		victims.reserve(_cache->size());
+		for (CelCache::iterator it = _cache->begin(); it != _cache->end(); ++it) {
+			CelCacheVictim victim;
+			victim.priority = it->_value.priority;
+			victim.id = it->_value.id;
+			victim.info = it->_key;
+			victims.push_back(victim);
+		}
+		Common::sort(victims.begin(), victims.end());
 
-	CelCacheEntry &entry = (*_cache)[cacheIndex];
+		const uint count = MIN<uint>(victims.size(), _cache->size() - _cacheCapacity + 1 + _cacheCapacity / 8);
+		for (uint i = 0; i < count; ++i) {
+			CelCache::iterator it = _cache->find(victims[i].info);
+			delete it->_value.celObj;
+			_cache->erase(it);
+		}
 
-	if (entry.celObj != nullptr) {
-		delete entry.celObj;
+		_cacheBasePriority = victims[count - 1].priority;
+		_cacheStats.evictions += count;
 	}
 
+	CelCacheEntry &entry = (*_cache)[_info];
+	delete entry.celObj;
+
+	// Creating the cel object again reads its header, and
+	// all of its pixels if the header does not say whether
+	// the cel has remap or skip colors
+	entry.cost = 1 + (scannedPixels ? (uint32)_width * _height / 1024 : 0);
+	entry.priority = _cacheBasePriority + entry.cost;
 	entry.celObj = duplicate();
 	entry.id = ++_nextCacheId;
 }
@@ -800,16 +841,13 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 	_compressionType = kCelCompressionInvalid;
 	_transparent = true;
 
-	int cacheInsertIndex;
-	int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry.celObj);
+	const CelCacheEntry *const entry = searchCache(_info);
+	if (entry != nullptr) {
+		const CelObjView *const cachedCelObj = dynamic_cast<CelObjView *>(entry->celObj);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjView in cache slot %d", cacheIndex);
+			error("Expected a CelObjView in cache for view %d", viewId);
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -890,6 +928,7 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		error("Compression type not supported - V: %d  L: %d  C: %d", _info.resourceId, _info.loopNo, _info.celNo);
 	}
 
+	bool scannedPixels = false;
 	if (celHeader[10] & 128) {
 		// NOTE: This is correct according to SCI2.1/SQ6/DOS;
 		// the engine re-reads the byte value as a word value
@@ -898,11 +937,73 @@ CelObjView::CelObjView(const GuiResourceId viewId, const int16 loopNo, const int
 		_remap = flags & 2 ? true : false;
 	} else if (_compressionType == kCelCompressionNone) {
 		_remap = analyzeUncompressedForRemap();
+		scannedPixels = true;
 	} else {
 		_remap = analyzeForRemap();
+		scannedPixels = true;
+	}
+
+	putCopyInCache(scannedPixels);
+
+	if (_precacheViews) {
+		precacheView(viewId);
+	}
+}
+
+void CelObjView::precacheView(const GuiResourceId viewId) {
+	if (_precaching) {
+		return;
+	}
+
+	Resource *resource = g_sci->getResMan()->findResource(ResourceId(kResourceTypeView, viewId), false);
+	if (!resource) {
+		return;
+	}
+
+	const byte *const data = resource->data;
+	const uint16 loopCount = data[2];
+	const uint16 viewHeaderSize = READ_SCI11ENDIAN_UINT16(data);
+	const uint8 loopHeaderSize = data[12];
+	const uint8 viewHeaderFieldSize = 2;
+
+	_precaching = true;
+
+	for (int16 loopNo = 0; loopNo < loopCount; ++loopNo) {
+		const byte *loopHeader = data + viewHeaderFieldSize + viewHeaderSize + (loopHeaderSize * loopNo);
+
+		// Mirrored loops use the cels of another loop
+		if ((int8)loopHeader[0] != -1) {
+			loopHeader = data + viewHeaderFieldSize + viewHeaderSize + (loopHeaderSize * (int8)loopHeader[0]);
+		}
+
+		const uint8 celCount = loopHeader[2];
+		for (int16 celNo = 0; celNo < celCount; ++celNo) {
+			// Precaching does not push out cels which are in use
+			if (_cache->size() >= _cacheCapacity) {
+				_precaching = false;
+				return;
+			}
+
+			CelInfo32 info;
+			info.type = kCelTypeView;
+			info.resourceId = viewId;
+			info.loopNo = loopNo;
+			info.celNo = celNo;
+
+			// Cels which the game would fail to draw are left alone
+			const byte *const celHeader = data + READ_SCI11ENDIAN_UINT32(loopHeader + 12) + (data[13] * celNo);
+			if (celHeader[9] != kCelCompressionNone && celHeader[9] != kCelCompressionRLE) {
+				continue;
+			}
+
+			if (!_cache->contains(info)) {
+				CelObjView celObj(viewId, loopNo, celNo);
+				++_cacheStats.precached;
+			}
+		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	_precaching = false;
 }
 
 bool CelObjView::analyzeUncompressedForRemap() const {
@@ -968,16 +1069,13 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 	_transparent = true;
 	_remap = false;
 
-	int cacheInsertIndex;
-	int cacheIndex = searchCache(_info, &cacheInsertIndex);
-	if (cacheIndex != -1) {
-		CelCacheEntry &entry = (*_cache)[cacheIndex];
-		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry.celObj);
+	const CelCacheEntry *const entry = searchCache(_info);
+	if (entry != nullptr) {
+		const CelObjPic *const cachedCelObj = dynamic_cast<CelObjPic *>(entry->celObj);
 		if (cachedCelObj == nullptr) {
-			error("Expected a CelObjPic in cache slot %d", cacheIndex);
+			error("Expected a CelObjPic in cache for pic %d", picId);
 		}
 		*this = *cachedCelObj;
-		entry.id = ++_nextCacheId;
 		return;
 	}
 
@@ -1029,6 +1127,7 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		_scaledHeight = 400;
 	}
 
+	bool scannedPixels = false;
 	if (celHeader[10] & 128) {
 		// NOTE: This is correct according to SCI2.1/SQ6/DOS;
 		// the engine re-reads the byte value as a word value
@@ -1037,13 +1136,14 @@ CelObjPic::CelObjPic(const GuiResourceId picId, const int16 celNo) {
 		_remap = flags & 2 ? true : false;
 	} else {
 		_transparent = _compressionType != kCelCompressionNone ? true : analyzeUncompressedForSkip();
+		scannedPixels = _compressionType == kCelCompressionNone;
 
 		if (_compressionType != kCelCompressionNone && _compressionType != kCelCompressionRLE) {
 			error("Compression type not supported - P: %d  C: %d", picId, celNo);
 		}
 	}
 
-	putCopyInCache(cacheInsertIndex);
+	putCopyInCache(scannedPixels);
 }
 
 bool CelObjPic::analyzeUncompressedForSkip() const {
@@ -23,6 +23,7 @@
 #ifndef SCI_GRAPHICS_CELOBJ32_H
 #define SCI_GRAPHICS_CELOBJ32_H
 
+#include "common/hashmap.h"
 #include "common/rational.h"
 #include "common/rect.h"
 #include "sci/resource.h"
@@ -109,7 +110,7 @@ struct CelInfo32 {
 	// NOTE: This is the equivalence criteria used by
 	// CelObj::searchCache in at least SCI2.1/SQ6. Notably,
 	// it does not check the color field.
-	inline bool operator==(const CelInfo32 &other) {
+	inline bool operator==(const CelInfo32 &other) const {
 		return (
 			type == other.type &&
 			resourceId == other.resourceId &&
@@ -119,11 +120,22 @@ struct CelInfo32 {
 		);
 	}
 
-	inline bool operator!=(const CelInfo32 &other) {
+	inline bool operator!=(const CelInfo32 &other) const {
 		return !(*this == other);
 	}
 };
 
+/**
+ * Hashes the fields of a CelInfo32 which are compared by
+ * its equality operator.
+ */
+struct CelInfo32_Hash {
+	uint operator()(const CelInfo32 &info) const {
+		return info.type ^ (info.resourceId << 4) ^ (info.loopNo << 16) ^ (info.celNo << 24) ^
+			(info.bitmap.getSegment() << 8) ^ info.bitmap.getOffset();
+	}
+};
+
 class CelObj;
 struct CelCacheEntry {
 	/**
@@ -132,11 +144,34 @@ struct CelCacheEntry {
 	 * replacement.
 	 */
 	int id;
+
+	/**
+	 * The cost of creating the cel object again, see
+	 * `CelObj::putCopyInCache`.
+	 */
+	uint32 cost;
+
+	/**
+	 * The entry with the lowest priority is replaced first.
+	 */
+	uint32 priority;
+
 	CelObj *celObj;
-	CelCacheEntry() : id(0), celObj(nullptr) {}
+	CelCacheEntry() : id(0), cost(0), priority(0), celObj(nullptr) {}
 };
 
-typedef Common::Array<CelCacheEntry> CelCache;
+typedef Common::HashMap<CelInfo32, CelCacheEntry, CelInfo32_Hash> CelCache;
+
+/**
+ * Counters of the cel cache, shown by the cel_cache
+ * console command.
+ */
+struct CelCacheStats {
+	uint32 hits;
+	uint32 misses;
+	uint32 evictions;
+	uint32 precached;   // cels created by `CelObjView::precacheView`
+};
 
 #pragma mark -
 #pragma mark CelScaler
@@ -445,6 +480,28 @@ private:
 
 #pragma mark -
 #pragma mark CelObj - Caching
+public:
+	static const CelCacheStats &getCacheStats() { return _cacheStats; }
+	static void resetCacheStats();
+
+	static uint getCacheSize() { return _cache ? _cache->size() : 0; }
+	static uint getCacheCapacity() { return _cacheCapacity; }
+
+	/**
+	 * Sets the number of cel objects which are kept in the
+	 * cache. Entries over the new capacity are removed the
+	 * next time a cel is put into the cache.
+	 */
+	static void setCacheCapacity(const uint capacity) { _cacheCapacity = MAX<uint>(capacity, 1); }
+
+	static bool getPrecacheViews() { return _precacheViews; }
+
+	/**
+	 * When enabled, the first use of a view puts all of its
+	 * cels into the cache, see `CelObjView::precacheView`.
+	 */
+	static void setPrecacheViews(const bool enable) { _precacheViews = enable; }
+
 protected:
 	/**
 	 * A monotonically increasing cache ID used to identify
@@ -453,27 +510,55 @@ protected:
 	 */
 	static int _nextCacheId;
 
+	/**
+	 * The priority of the last replaced cache entry. Used
+	 * entries get this plus their cost, so entries which
+	 * are not used any more are replaced eventually, even
+	 * if they are expensive.
+	 */
+	static uint32 _cacheBasePriority;
+
 	/**
 	 * A cache of cel objects used to avoid reinitialisation
-	 * overhead for cels with the same CelInfo32.
+	 * overhead for cels with the same CelInfo32. The key is
+	 * the CelInfo32 of the cached cel object.
 	 */
-	// NOTE: At least SQ6 uses a fixed cache size of 100.
 	static CelCache *_cache;
 
+	/**
+	 * The number of cel objects kept in the cache.
+	 */
+	// NOTE: At least SQ6 uses a fixed cache size of 100, which
+	// scenes with hundreds of cels cycle through on every frame.
+	static uint _cacheCapacity;
+
+	static bool _precacheViews;
+
+	/**
+	 * Set while `CelObjView::precacheView` runs, whose
+	 * lookups are not counted as hits or misses.
+	 */
+	static bool _precaching;
+
+	static CelCacheStats _cacheStats;
+
 	/**
 	 * Searches the cel cache for a CelObj matching the
-	 * provided CelInfo32. If not found, -1 is returned.
-	 * nextInsertIndex will receive the index of the oldest
-	 * item in the cache, which can be used to replace
-	 * the oldest item with a newer item.
+	 * provided CelInfo32. If not found, nullptr is
+	 * returned.
 	 */
-	int searchCache(const CelInfo32 &celInfo, int *nextInsertIndex) const;
+	CelCacheEntry *searchCache(const CelInfo32 &celInfo) const;
 
 	/**
-	 * Puts a copy of this CelObj into the cache at the
-	 * given cache index.
+	 * Puts a copy of this CelObj into the cache. If the
+	 * cache is full, the entries with the lowest priority
+	 * are replaced, an eighth of the cache at a time.
+	 *
+	 * `scannedPixels` tells whether creating the cel object
+	 * read all of its pixels, which makes it more costly to
+	 * create again.
 	 */
-	void putCopyInCache(int index) const;
+	void putCopyInCache(const bool scannedPixels) const;
 };
 
 #pragma mark -
@@ -514,6 +599,12 @@ public:
 
 	virtual CelObjView *duplicate() const override;
 	virtual byte *getResPointer() const override;
+
+	/**
+	 * Puts the cels of all loops of the given view into
+	 * the cel cache, as long as it has room for them.
+	 */
+	static void precacheView(const GuiResourceId viewId);
 };
 
 #pragma mark -
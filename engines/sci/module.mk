@@ -29,6 +29,7 @@ MODULE_OBJS := \
 	engine/kvideo.o \
 	engine/message.o \
 	engine/object.o \
+	engine/pathfinder.o \
 	engine/savegame.o \
 	engine/script.o \
 	engine/scriptdebug.o \
@@ -25,6 +25,7 @@
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #ifdef ENABLE_SCI32
 #include "common/memstream.h"
@@ -201,6 +202,9 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : _resMan(resMan), _i
 	_source = NULL;
 	_header = NULL;
 	_headerSize = 0;
+	_compressed = false;
+	_prefetched = false;
+	_prefetchQueued = false;
 }
 
 Resource::~Resource() {
@@ -214,6 +218,7 @@ void Resource::unalloc() {
 	delete[] data;
 	data = NULL;
 	_status = kResStatusNoMalloc;
+	_prefetched = false;
 }
 
 void Resource::writeToStream(Common::WriteStream *stream) const {
@@ -877,6 +882,8 @@ void ResourceManager::init() {
 	_memoryLRU = 0;
 	_LRU.clear();
 	_resMap.clear();
+	_prefetchQueue.clear();
+	memset(&_cacheStats, 0, sizeof(_cacheStats));
 	_audioMapSCI1 = NULL;
 
 	// FIXME: put this in an Init() function, so that we can error out if detection fails completely
@@ -1018,10 +1025,28 @@ void ResourceManager::printLRU() {
 }
 
 void ResourceManager::freeOldResources() {
+	// Number of least recently used entries considered for eviction
+	const int kEvictionWindow = 8;
+
 	while (_maxMemoryLRU < _memoryLRU) {
 		assert(!_LRU.empty());
-		Resource *goner = *_LRU.reverse_begin();
+
+		// Reloading an uncompressed resource is a plain read, while a
+		// compressed one has to go through its decompressor again. So among
+		// the oldest few entries, prefer to drop an uncompressed one.
+		Common::List<Resource *>::iterator it = _LRU.reverse_begin();
+		Resource *goner = *it;
+		for (int i = 0; i < kEvictionWindow && goner->_compressed; ++i, --it) {
+			if (!(*it)->_compressed) {
+				goner = *it;
+				break;
+			}
+			if (it == _LRU.begin())
+				break;
+		}
+
 		removeFromLRU(goner);
+		_cacheStats.evictions++;
 		goner->unalloc();
 #ifdef SCI_VERBOSE_RESMAN
 		debug("resMan-debug: LRU: Freeing %s (%d bytes)", goner->_id.toString().c_str(), goner->size);
@@ -1048,9 +1073,20 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_status == kResStatusNoMalloc) {
+		const uint32 startTime = g_system->getMillis();
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+		_cacheStats.loadMillis += g_system->getMillis() - startTime;
+		_cacheStats.misses++;
+	} else {
+		_cacheStats.hits++;
+		if (retval->_prefetched) {
+			_cacheStats.prefetchHits++;
+			retval->_prefetched = false;
+		}
+	}
+
+	if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -1083,6 +1119,49 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	}
 }
 
+void ResourceManager::prefetchResource(ResourceId id) {
+	Resource *res = testResource(id);
+
+	// Scripts are hinted each time they are loaded, queue them only once
+	if (res && res->_status == kResStatusNoMalloc && !res->_prefetchQueued) {
+		res->_prefetchQueued = true;
+		_prefetchQueue.push(id);
+	}
+}
+
+void ResourceManager::processPrefetchQueue(uint32 maxMillis) {
+	const uint32 startTime = g_system->getMillis();
+
+	while (!_prefetchQueue.empty() && g_system->getMillis() - startTime < maxMillis) {
+		Resource *res = testResource(_prefetchQueue.pop());
+		if (!res)
+			continue;
+		res->_prefetchQueued = false;
+
+		// Already loaded on request in the meantime
+		if (res->_status != kResStatusNoMalloc)
+			continue;
+
+		const uint32 loadStart = g_system->getMillis();
+		loadResource(res);
+		_cacheStats.prefetchMillis += g_system->getMillis() - loadStart;
+
+		if (res->_status != kResStatusAllocated)
+			continue;
+
+		// Only fill free cache space, never push out resources which were
+		// actually requested. The size is only reliably known after loading.
+		if (_memoryLRU + (int)res->size > _maxMemoryLRU) {
+			res->unalloc();
+			continue;
+		}
+
+		res->_prefetched = true;
+		_cacheStats.prefetches++;
+		addToLRU(res);
+	}
+}
+
 void ResourceManager::unlockResource(Resource *res) {
 	assert(res);
 
@@ -2010,6 +2089,7 @@ int Resource::decompress(ResVersion volVersion, Common::SeekableReadStream *file
 		return SCI_ERROR_UNKNOWN_COMPRESSION;
 	}
 
+	_compressed = (compression != kCompNone);
 	data = new byte[size];
 	_status = kResStatusAllocated;
 	errorNum = data ? dec->unpack(file, data, szPacked, size) : SCI_ERROR_RESOURCE_TOO_BIG;
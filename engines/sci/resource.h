@@ -26,6 +26,7 @@
 #include "common/str.h"
 #include "common/list.h"
 #include "common/hashmap.h"
+#include "common/queue.h"
 
 #include "sci/graphics/helpers.h"		// for ViewType
 #include "sci/decompressor.h"
@@ -284,6 +285,9 @@ protected:
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
 	ResourceManager *_resMan;
+	bool _compressed; /**< Whether loading the resource runs a decompressor */
+	bool _prefetched; /**< Loaded by the prefetcher and not requested since */
+	bool _prefetchQueued; /**< Waiting in the prefetch queue */
 
 	bool loadPatch(Common::SeekableReadStream *file);
 	bool loadFromPatchFile();
@@ -351,6 +355,39 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	/**
+	 * Hint that a resource will probably be needed soon. The resource is
+	 * loaded into the LRU cache by processPrefetchQueue(), as long as that
+	 * does not push out anything already cached.
+	 * @param id	The resource to prefetch
+	 */
+	void prefetchResource(ResourceId id);
+
+	/**
+	 * Load queued prefetch hints until the time budget runs out. This is
+	 * called while the engine idles, so loading and decompressing happens
+	 * between frames instead of inside findResource().
+	 * @param maxMillis	Time budget in milliseconds
+	 */
+	void processPrefetchQueue(uint32 maxMillis);
+	bool isPrefetchPending() const { return !_prefetchQueue.empty(); }
+
+	/** Cache statistics, shown by the resource_stats console command */
+	struct CacheStats {
+		uint32 hits;			///< Requests served from memory
+		uint32 misses;			///< Requests which had to load the resource
+		uint32 prefetches;		///< Resources loaded by the prefetcher
+		uint32 prefetchHits;	///< Requests served by a prefetched resource
+		uint32 loadMillis;		///< Time spent loading on request
+		uint32 prefetchMillis;	///< Time spent loading while idle
+		uint32 evictions;		///< Resources freed to stay under the LRU limit
+	};
+
+	const CacheStats &getCacheStats() const { return _cacheStats; }
+	int getLRUMemory() const { return _memoryLRU; }
+	int getMaxLRUMemory() const { return _maxMemoryLRU; }
+	int getLockedMemory() const { return _memoryLocked; }
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -439,6 +476,8 @@ protected:
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
 	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	Common::Queue<ResourceId> _prefetchQueue; ///< Resources hinted by prefetchResource()
+	CacheStats _cacheStats;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
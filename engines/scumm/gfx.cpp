@@ -215,9 +215,12 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+	memset(&_stripCache, 0, sizeof(_stripCache));
 }
 
 Gdi::~Gdi() {
+	free(_stripCache.state);
+	free(_stripCache.data);
 }
 
 GdiHE::GdiHE(ScummEngine *vm) : Gdi(vm), _tmskPtr(0) {
@@ -275,6 +278,8 @@ void Gdi::init() {
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	invalidateStripCache();
+	_stripCache.enabled = true;
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -1008,7 +1013,7 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, Gdi::dbRoomBackground);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -1795,6 +1800,8 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	_objectMode = (flag & dbObjectMode) == dbObjectMode;
 	prepareDrawBitmap(ptr, vs, x, y, width, height, stripnr, numstrip);
 
+	const bool useStripCache = (flag & dbRoomBackground) && y == 0 && prepareStripCache(ptr, vs, height, numzbuf);
+
 	sx = x - vs->xstart / 8;
 	if (sx < 0) {
 		numstrip -= -sx;
@@ -1827,7 +1834,10 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		else
 			dstPtr = (byte *)vs->getBasePtr(x * 8, y);
 
-		transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		// Cached strips are never transparent
+		const bool cached = useStripCache && readCachedStrip(dstPtr, vs, x, y, height, stripnr, zplane_list);
+		const bool drawnTransparent = cached ? false : drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		transpStrip = drawnTransparent;
 
 		// COMI and HE games only uses flag value
 		if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
@@ -1841,7 +1851,12 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 				clear8Col(frontBuf, vs->pitch, height, vs->format.bytesPerPixel);
 		}
 
-		decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+		if (!cached) {
+			decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+
+			if (useStripCache)
+				writeCachedStrip(dstPtr, vs, x, y, height, stripnr, zplane_list, drawnTransparent);
+		}
 
 #if 0
 		// HACK: blit mask(s) onto normal screen. Useful to debug masking
@@ -1869,6 +1884,119 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	}
 }
 
+void Gdi::invalidateStripCache() {
+	free(_stripCache.state);
+	free(_stripCache.data);
+	_stripCache.state = 0;
+	_stripCache.data = 0;
+	_stripCache.bitmap = 0;
+	_stripCache.numStrips = 0;
+}
+
+uint32 Gdi::getStripCacheSize() const {
+	if (!_stripCache.data)
+		return 0;
+	return _stripCache.numStrips * (_stripCache.stripSize + 1);
+}
+
+/**
+ * Make sure the strip cache belongs to the given room image and drawing
+ * parameters, and reset it otherwise. Returns false if the cache can not
+ * be used.
+ */
+bool Gdi::prepareStripCache(const byte *ptr, VirtScreen *vs, int height, int numzbuf) {
+	if (!_stripCache.enabled || height > vs->h)
+		return false;
+
+	// The decoded pixels depend on the palette mapping, which scripts can
+	// change while the room is shown
+	int colorsSize;
+	const byte *colors = getRoomColors(colorsSize);
+	assert(colorsSize <= (int)sizeof(_stripCache.roomColors));
+	if (_stripCache.bitmap == ptr && _stripCache.height == height && _stripCache.numZBuffer == numzbuf
+			&& _stripCache.bytesPerPixel == vs->format.bytesPerPixel
+			&& !memcmp(_stripCache.roomColors, colors, colorsSize))
+		return true;
+
+	invalidateStripCache();
+
+	const int numStrips = _vm->_roomWidth / 8;
+	const int stripSize = height * 8 * vs->format.bytesPerPixel + MAX(numzbuf - 1, 0) * height;
+	if (numStrips <= 0)
+		return false;
+
+	_stripCache.state = (byte *)calloc(numStrips, 1);
+	_stripCache.data = (byte *)malloc(numStrips * stripSize);
+	if (!_stripCache.state || !_stripCache.data) {
+		invalidateStripCache();
+		return false;
+	}
+
+	_stripCache.bitmap = ptr;
+	_stripCache.height = height;
+	_stripCache.bytesPerPixel = vs->format.bytesPerPixel;
+	_stripCache.numZBuffer = numzbuf;
+	_stripCache.numStrips = numStrips;
+	_stripCache.stripSize = stripSize;
+	memcpy(_stripCache.roomColors, colors, colorsSize);
+	return true;
+}
+
+bool Gdi::readCachedStrip(byte *dstPtr, VirtScreen *vs, int x, int y, int height,
+				int stripnr, const byte *zplane_list[9]) {
+	if (stripnr < 0 || stripnr >= _stripCache.numStrips || _stripCache.state[stripnr] != kStripCached)
+		return false;
+
+	const byte *src = _stripCache.data + stripnr * _stripCache.stripSize;
+	const int rowSize = 8 * vs->format.bytesPerPixel;
+	for (int h = 0; h < height; h++, dstPtr += vs->pitch, src += rowSize)
+		memcpy(dstPtr, src, rowSize);
+
+	// Planes without data are left alone, like decodeMask does
+	for (int i = 1; i < _stripCache.numZBuffer; i++, src += height) {
+		if (!zplane_list[i])
+			continue;
+
+		byte *mask_ptr = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++)
+			mask_ptr[h * _numStrips] = src[h];
+	}
+
+	_stripCache.hits++;
+	return true;
+}
+
+void Gdi::writeCachedStrip(const byte *srcPtr, VirtScreen *vs, int x, int y, int height,
+				int stripnr, const byte *zplane_list[9], bool transpStrip) {
+	if (stripnr < 0 || stripnr >= _stripCache.numStrips)
+		return;
+
+	_stripCache.misses++;
+
+	// Transparent strips depend on what was drawn below them
+	if (transpStrip) {
+		_stripCache.state[stripnr] = kStripUncacheable;
+		return;
+	}
+
+	byte *dst = _stripCache.data + stripnr * _stripCache.stripSize;
+	const int rowSize = 8 * vs->format.bytesPerPixel;
+	for (int h = 0; h < height; h++, srcPtr += vs->pitch, dst += rowSize)
+		memcpy(dst, srcPtr, rowSize);
+
+	for (int i = 1; i < _stripCache.numZBuffer; i++, dst += height) {
+		if (!zplane_list[i])
+			continue;
+
+		const byte *mask_ptr = getMaskBuffer(x, y, i);
+		for (int h = 0; h < height; h++)
+			dst[h] = mask_ptr[h * _numStrips];
+	}
+
+	_stripCache.state[stripnr] = kStripCached;
+}
+
+
 bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr) {
 	// Do some input verification and make sure the strip/strip offset
@@ -3713,6 +3841,11 @@ void Gdi::unkDecode11(byte *dst, int dstPitch, const byte *src, int height) cons
 void GdiHE16bit::writeRoomColor(byte *dst, byte color) const {
 	WRITE_UINT16(dst, READ_LE_UINT16(_vm->_hePalettes + 2048 + color * 2));
 }
+
+const byte *GdiHE16bit::getRoomColors(int &size) const {
+	size = 512;
+	return _vm->_hePalettes + 2048;
+}
 #endif
 
 void Gdi::writeRoomColor(byte *dst, byte color) const {
@@ -3723,6 +3856,11 @@ void Gdi::writeRoomColor(byte *dst, byte color) const {
 	*dst = _roomPalette[(color + _paletteMod) & 0xFF];
 }
 
+const byte *Gdi::getRoomColors(int &size) const {
+	size = 256;
+	return _vm->_roomPalette;
+}
+
 
 #pragma mark -
 #pragma mark --- Transition effects ---
@@ -197,6 +197,33 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/**
+	 * Cache of the decoded strips and z-plane masks of the room background,
+	 * so that redrawing them, e.g. while scrolling, is a plain copy. It is
+	 * only enabled by Gdi::roomChanged, i.e. not for the tile based
+	 * renderers, and reset whenever the room or its palette mapping changes.
+	 */
+	struct StripCache {
+		bool enabled;
+		const byte *bitmap;	///< the room image the cache was built from
+		int height;
+		int bytesPerPixel;
+		int numZBuffer;
+		int numStrips;
+		int stripSize;		///< bytes per strip: pixels followed by masks
+		byte *state;		///< one of the StripCacheState values per strip
+		byte *data;
+		byte roomColors[512];	///< copy of what getRoomColors() returned
+		uint32 hits;
+		uint32 misses;
+	} _stripCache;
+
+	enum StripCacheState {
+		kStripUnknown = 0,
+		kStripCached,
+		kStripUncacheable
+	};
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -224,6 +251,8 @@ protected:
 
 	void drawStripHE(byte *dst, int dstPitch, const byte *src, int width, int height, const bool transpCheck) const;
 	virtual void writeRoomColor(byte *dst, byte color) const;
+	/** The color table writeRoomColor() maps room colors with, of size bytes. */
+	virtual const byte *getRoomColors(int &size) const;
 
 	/* Mask decompressors */
 	void decompressMaskImgOr(byte *dst, const byte *src, int height) const;
@@ -244,6 +273,13 @@ protected:
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip);
 
+	/* Strip cache */
+	bool prepareStripCache(const byte *ptr, VirtScreen *vs, int height, int numzbuf);
+	bool readCachedStrip(byte *dstPtr, VirtScreen *vs, int x, int y, int height,
+	                int stripnr, const byte *zplane_list[9]);
+	void writeCachedStrip(const byte *srcPtr, VirtScreen *vs, int x, int y, int height,
+	                int stripnr, const byte *zplane_list[9], bool transpStrip);
+
 public:
 	Gdi(ScummEngine *vm);
 	virtual ~Gdi();
@@ -267,10 +303,18 @@ public:
 
 	void resetBackground(int top, int bottom, int strip);
 
+	/** Drop all cached room strips, e.g. after the room image was modified. */
+	void invalidateStripCache();
+	/** Memory used by the strip cache, in bytes. */
+	uint32 getStripCacheSize() const;
+	uint32 getStripCacheHits() const { return _stripCache.hits; }
+	uint32 getStripCacheMisses() const { return _stripCache.misses; }
+
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbObjectMode    = 2 << 2,
+		dbRoomBackground = 1 << 4	///< ptr is the current room image, strips may be cached
 	};
 };
 
@@ -438,6 +482,7 @@ public:
 class GdiHE16bit : public GdiHE {
 protected:
 	virtual void writeRoomColor(byte *dst, byte color) const;
+	virtual const byte *getRoomColors(int &size) const;
 public:
 	GdiHE16bit(ScummEngine *vm);
 };
@@ -149,7 +149,10 @@ enum {
 	STATE_LAUNCH = 10,
 	STATE_CRAWLER_DECISION = 11,
 
-	TREE_DEPTH = 2
+	TREE_DEPTH = 2,
+
+	// Milliseconds per AI call spent on expanding search nodes
+	SEARCH_BUDGET = 8
 };
 
 AI::AI(ScummEngine_v100he *vm) : _vm(vm) {
@@ -1827,7 +1830,7 @@ int *AI::approachTarget(Tree *myTree, int &xTarget, int &yTarget, Node **current
 	int *retVal = NULL;
 
 	*currentNode = NULL;
-	Node *retNode = myTree->aStarSearch_singlePass();
+	Node *retNode = myTree->aStarSearch_singlePass(SEARCH_BUDGET);
 
 	if (*currentNode != NULL)
 		warning("########################################### Got a possible solution");
@@ -1934,7 +1937,7 @@ int *AI::acquireTarget(int targetX, int targetY, Tree *myTree, int &errorCode) {
 	int currentPlayer = getCurrentPlayer();
 	int *retVal = NULL;
 
-	Node *retNode = myTree->aStarSearch_singlePass();
+	Node *retNode = myTree->aStarSearch_singlePass(SEARCH_BUDGET);
 
 	if (myTree->IsBaseNode(retNode))
 		return acquireTarget(targetX, targetY);
@@ -2606,6 +2609,10 @@ int AI::getTimerValue(int timerNum) {
 	return retVal;
 }
 
+uint32 AI::getMillis() {
+	return _vm->_system->getMillis();
+}
+
 int AI::getLastAttacked(int &x, int &y) {
 	int currentPlayer = getCurrentPlayer();
 	x = _vm->_moonbase->callScummFunction(_mcpParams[F_GET_SCUMM_DATA], 2, D_GET_LAST_ATTACKED_X, currentPlayer);
@@ -83,7 +83,7 @@ enum {
 	MIN_DIST = 108
 };
 
-class AI {
+class AI : public SearchClock {
 public:
 	AI(ScummEngine_v100he *vm);
 
@@ -132,8 +132,9 @@ public:
 	int getBuildingTeam(int building);
 
 	int getPlayerEnergy();
-	int getPlayerMaxTime();
-	int getTimerValue(int timerNum);
+	virtual int getPlayerMaxTime();
+	virtual int getTimerValue(int timerNum);
+	virtual uint32 getMillis();
 	int getPlayerTeam(int player);
 
 	int getAnimSpeed();
@@ -24,6 +24,16 @@
 
 namespace Scumm {
 
+enum {
+	kNodesPerBlock = 4096
+};
+
+// The node pool: blocks of kNodesPerBlock nodes, linked through their first
+// chunk, and a list of the free chunks
+static void *s_nodeBlocks = NULL;
+static void *s_freeNodes = NULL;
+static uint32 s_pooledNodes = 0;
+
 IContainedObject::IContainedObject(IContainedObject &sourceContainedObject) {
 	_objID = sourceContainedObject.getObjID();
 	_valueG = sourceContainedObject.getG();
@@ -31,6 +41,53 @@ IContainedObject::IContainedObject(IContainedObject &sourceContainedObject) {
 
 int Node::_nodeCount = 0;
 
+void *Node::operator new(size_t size) {
+	assert(size == sizeof(Node));
+
+	if (!s_freeNodes) {
+		byte *block = (byte *)malloc(kNodesPerBlock * sizeof(Node));
+		if (!block)
+			error("Node: Out of memory");
+
+		*(void **)block = s_nodeBlocks;
+		s_nodeBlocks = block;
+
+		for (int i = kNodesPerBlock - 1; i > 0; i--) {
+			void *chunk = block + i * sizeof(Node);
+			*(void **)chunk = s_freeNodes;
+			s_freeNodes = chunk;
+		}
+	}
+
+	void *chunk = s_freeNodes;
+	s_freeNodes = *(void **)chunk;
+	s_pooledNodes++;
+	return chunk;
+}
+
+void Node::operator delete(void *ptr) {
+	if (!ptr)
+		return;
+
+	*(void **)ptr = s_freeNodes;
+	s_freeNodes = ptr;
+	s_pooledNodes--;
+}
+
+void Node::freePool() {
+	if (s_pooledNodes) {
+		warning("Node: %u nodes still allocated, keeping the pool", s_pooledNodes);
+		return;
+	}
+
+	while (s_nodeBlocks) {
+		void *next = *(void **)s_nodeBlocks;
+		free(s_nodeBlocks);
+		s_nodeBlocks = next;
+	}
+	s_freeNodes = NULL;
+}
+
 Node::Node() {
 	_parent = NULL;
 	_depth = 0;
@@ -77,6 +77,20 @@ public:
 	Node(Node *sourceNode);
 	~Node();
 
+	/**
+	 * Nodes are allocated from a pool, since every search creates and
+	 * destroys them by the thousands. Deleted nodes go back to the pool and
+	 * are reused by the next search.
+	 */
+	static void *operator new(size_t size);
+	static void operator delete(void *ptr);
+
+	/**
+	 * Release the memory of the node pool. Only call this once all nodes
+	 * have been deleted, e.g. when the engine shuts down.
+	 */
+	static void freePool();
+
 	void setParent(Node *parentPtr) { _parent = parentPtr; }
 	Node *getParent() const { return _parent; }
 
@@ -110,6 +110,9 @@ int Sortie::numChildrenToGen() {
 }
 
 IContainedObject *Sortie::createChildObj(int index, int &completionFlag) {
+	// Unlike the travellers, sorties never need results from later frames
+	completionFlag = 1;
+
 	float thisDamage;
 	Sortie *retSortie = new Sortie(_ai);
 	int activeDefenses = 0;
@@ -20,64 +20,61 @@
  *
  */
 
-#include "scumm/he/intern_he.h"
-
-#include "scumm/he/moonbase/moonbase.h"
 #include "scumm/he/moonbase/ai_tree.h"
-#include "scumm/he/moonbase/ai_main.h"
 
 namespace Scumm {
 
-static int compareTreeNodes(const void *a, const void *b) {
-	if (((const TreeNode *)a)->value < ((const TreeNode *)b)->value)
-		return -1;
-	else if (((const TreeNode *)a)->value > ((const TreeNode *)b)->value)
-		return 1;
-	else
-		return 0;
+/**
+ * Order of the open list: lower values first, and among equal values the
+ * most recently inserted node first.
+ */
+static inline bool isBefore(const TreeNode &a, const TreeNode &b) {
+	if (a.value != b.value)
+		return a.value < b.value;
+	return a.order > b.order;
 }
 
-Tree::Tree(AI *ai) : _ai(ai) {
+Tree::Tree(SearchClock *clock) : _clock(clock) {
 	pBaseNode = new Node;
 	_maxDepth = MAX_DEPTH;
 	_maxNodes = MAX_NODES;
 	_currentNode = 0;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
+	_openCount = 0;
+	_expandedNodes = 0;
 }
 
-Tree::Tree(IContainedObject *contents, AI *ai) : _ai(ai) {
+Tree::Tree(IContainedObject *contents, SearchClock *clock) : _clock(clock) {
 	pBaseNode = new Node;
 	pBaseNode->setContainedObject(contents);
 	_maxDepth = MAX_DEPTH;
 	_maxNodes = MAX_NODES;
 	_currentNode = 0;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
+	_openCount = 0;
+	_expandedNodes = 0;
 }
 
-Tree::Tree(IContainedObject *contents, int maxDepth, AI *ai) : _ai(ai) {
+Tree::Tree(IContainedObject *contents, int maxDepth, SearchClock *clock) : _clock(clock) {
 	pBaseNode = new Node;
 	pBaseNode->setContainedObject(contents);
 	_maxDepth = maxDepth;
 	_maxNodes = MAX_NODES;
 	_currentNode = 0;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
+	_openCount = 0;
+	_expandedNodes = 0;
 }
 
-Tree::Tree(IContainedObject *contents, int maxDepth, int maxNodes, AI *ai) : _ai(ai) {
+Tree::Tree(IContainedObject *contents, int maxDepth, int maxNodes, SearchClock *clock) : _clock(clock) {
 	pBaseNode = new Node;
 	pBaseNode->setContainedObject(contents);
 	_maxDepth = maxDepth;
 	_maxNodes = maxNodes;
 	_currentNode = 0;
 	_currentChildIndex = 0;
-
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
+	_openCount = 0;
+	_expandedNodes = 0;
 }
 
 void Tree::duplicateTree(Node *sourceNode, Node *destNode) {
@@ -92,13 +89,14 @@ void Tree::duplicateTree(Node *sourceNode, Node *destNode) {
 	}
 }
 
-Tree::Tree(const Tree *sourceTree, AI *ai) : _ai(ai) {
+Tree::Tree(const Tree *sourceTree, SearchClock *clock) : _clock(clock) {
 	pBaseNode = new Node(sourceTree->getBaseNode());
 	_maxDepth = sourceTree->getMaxDepth();
 	_maxNodes = sourceTree->getMaxNodes();
-	_currentMap = new Common::SortedArray<TreeNode *>(compareTreeNodes);
 	_currentNode = 0;
 	_currentChildIndex = 0;
+	_openCount = 0;
+	_expandedNodes = 0;
 
 	duplicateTree(sourceTree->getBaseNode(), pBaseNode);
 }
@@ -120,13 +118,49 @@ Tree::~Tree() {
 			pTemp = NULL;
 		}
 	}
+}
 
-	delete _currentMap;
+void Tree::pushOpen(float value, Node *node) {
+	_openList.push_back(TreeNode(value, _openCount++, node));
+
+	// Sift the new entry up
+	uint i = _openList.size() - 1;
+	while (i > 0) {
+		const uint parent = (i - 1) / 2;
+		if (!isBefore(_openList[i], _openList[parent]))
+			break;
+		SWAP(_openList[i], _openList[parent]);
+		i = parent;
+	}
 }
 
-Node *Tree::aStarSearch() {
-	Common::SortedArray<TreeNode *> mmfpOpen(compareTreeNodes);
+Node *Tree::popOpen() {
+	Node *node = _openList[0].node;
+
+	_openList[0] = _openList.back();
+	_openList.pop_back();
+
+	// Sift the moved entry down
+	const uint size = _openList.size();
+	uint i = 0;
+	for (;;) {
+		uint best = i;
+		const uint left = 2 * i + 1;
+		const uint right = left + 1;
+		if (left < size && isBefore(_openList[left], _openList[best]))
+			best = left;
+		if (right < size && isBefore(_openList[right], _openList[best]))
+			best = right;
+		if (best == i)
+			break;
+		SWAP(_openList[i], _openList[best]);
+		i = best;
+	}
 
+	return node;
+}
+
+Node *Tree::aStarSearch() {
 	Node *currentNode = NULL;
 	float currentT;
 
@@ -135,11 +169,12 @@ Node *Tree::aStarSearch() {
 	float temp = pBaseNode->getContainedObject()->calcT();
 
 	if (static_cast<int>(temp) != SUCCESS) {
-		mmfpOpen.insert(new TreeNode(pBaseNode->getObjectT(), pBaseNode));
+		_openList.clear();
+		pushOpen(pBaseNode->getObjectT(), pBaseNode);
 
-		while (mmfpOpen.size() && (retNode == NULL)) {
-			currentNode = mmfpOpen.front()->node;
-			mmfpOpen.erase(mmfpOpen.begin());
+		while (_openList.size() && (retNode == NULL)) {
+			currentNode = popOpen();
+			_expandedNodes++;
 
 			if ((currentNode->getDepth() < _maxDepth) && (Node::getNodeCount() < _maxNodes)) {
 				// Generate nodes
@@ -152,7 +187,7 @@ Node *Tree::aStarSearch() {
 					if (currentT == SUCCESS)
 						retNode = *i;
 					else
-						mmfpOpen.insert(new TreeNode(currentT, (*i)));
+						pushOpen(currentT, (*i));
 				}
 			} else {
 				retNode = currentNode;
@@ -174,7 +209,8 @@ Node *Tree::aStarSearch_singlePassInit() {
 	float temp = pBaseNode->getContainedObject()->calcT();
 
 	if (static_cast<int>(temp) != SUCCESS) {
-		_currentMap->insert(new TreeNode(pBaseNode->getObjectT(), pBaseNode));
+		_openList.clear();
+		pushOpen(pBaseNode->getObjectT(), pBaseNode);
 	} else {
 		retNode = pBaseNode;
 	}
@@ -182,34 +218,50 @@ Node *Tree::aStarSearch_singlePassInit() {
 	return retNode;
 }
 
-Node *Tree::aStarSearch_singlePass() {
+Node *Tree::aStarSearch_singlePass(uint32 budget) {
+	if (!budget)
+		return singlePassStep();
+
+	const uint32 start = _clock->getMillis();
+	Node *retNode;
+
+	// A child index of 0 means that the children of the current node need
+	// results which are only available in a later frame
+	do {
+		retNode = singlePassStep();
+	} while (!retNode && _currentChildIndex && _clock->getMillis() - start < budget);
+
+	return retNode;
+}
+
+Node *Tree::singlePassStep() {
 	float currentT = 0.0;
 	Node *retNode = NULL;
 
 	static int maxTime = 0;
 
 	if (_currentChildIndex == 1) {
-		maxTime = _ai->getPlayerMaxTime();
+		maxTime = _clock->getPlayerMaxTime();
 	}
 
 	if (_currentChildIndex) {
-		if (!(_currentMap->size())) {
+		if (!(_openList.size())) {
 			retNode = _currentNode;
 			return retNode;
 		}
 
-		_currentNode = _currentMap->front()->node;
-		_currentMap->erase(_currentMap->begin());
+		_currentNode = popOpen();
+		_expandedNodes++;
 	}
 
-	if ((_currentNode->getDepth() < _maxDepth) && (Node::getNodeCount() < _maxNodes) && ((!maxTime) || (_ai->getTimerValue(3) < maxTime))) {
+	if ((_currentNode->getDepth() < _maxDepth) && (Node::getNodeCount() < _maxNodes) && ((!maxTime) || (_clock->getTimerValue(3) < maxTime))) {
 		// Generate nodes
 		_currentChildIndex = _currentNode->generateChildren();
 
 		if (_currentChildIndex) {
 			Common::Array<Node *> vChildren = _currentNode->getChildren();
 
-			if (!vChildren.size() && !_currentMap->size()) {
+			if (!vChildren.size() && !_openList.size()) {
 				_currentChildIndex = 0;
 				retNode = _currentNode;
 			}
@@ -222,11 +274,11 @@ Node *Tree::aStarSearch_singlePass() {
 					retNode = *i;
 					i = vChildren.end() - 1;
 				} else {
-					_currentMap->insert(new TreeNode(currentT, (*i)));
+					pushOpen(currentT, (*i));
 				}
 			}
 
-			if (!(_currentMap->size()) && (currentT != SUCCESS)) {
+			if (!(_openList.size()) && (currentT != SUCCESS)) {
 				assert(_currentNode != NULL);
 				retNode = _currentNode;
 			}
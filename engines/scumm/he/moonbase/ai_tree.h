@@ -31,13 +31,30 @@ namespace Scumm {
 const int MAX_DEPTH = 100;
 const int MAX_NODES = 1000000;
 
-class AI;
+/**
+ * The time limits of a search, which the owner of a tree provides.
+ */
+class SearchClock {
+public:
+	virtual ~SearchClock() {}
+
+	/** The time the player may spend on a move, or 0 for no limit. */
+	virtual int getPlayerMaxTime() = 0;
+
+	/** The value of one of the timers the player time is measured with. */
+	virtual int getTimerValue(int timerNum) = 0;
+
+	/** The current time in milliseconds, for the search budget. */
+	virtual uint32 getMillis() = 0;
+};
 
 struct TreeNode {
 	float value;
+	uint32 order;	///< insertion count, to break ties between equal values
 	Node *node;
 
-	TreeNode(float v, Node *n) { value = v; node = n; }
+	TreeNode() : value(0), order(0), node(0) {}
+	TreeNode(float v, uint32 o, Node *n) : value(v), order(o), node(n) {}
 };
 
 class Tree {
@@ -49,17 +66,25 @@ private:
 
 	int _currentChildIndex;
 
-	Common::SortedArray<TreeNode *> *_currentMap;
+	/** The open list, as a binary min-heap on the values. */
+	Common::Array<TreeNode> _openList;
+	uint32 _openCount;
 	Node *_currentNode;
 
-	AI *_ai;
+	uint32 _expandedNodes;
+
+	SearchClock *_clock;
+
+	void pushOpen(float value, Node *node);
+	Node *popOpen();
+	Node *singlePassStep();
 
 public:
-	Tree(AI *ai);
-	Tree(IContainedObject *contents, AI *ai);
-	Tree(IContainedObject *contents, int maxDepth, AI *ai);
-	Tree(IContainedObject *contents, int maxDepth, int maxNodes, AI *ai);
-	Tree(const Tree *sourceTree, AI *ai);
+	Tree(SearchClock *clock);
+	Tree(IContainedObject *contents, SearchClock *clock);
+	Tree(IContainedObject *contents, int maxDepth, SearchClock *clock);
+	Tree(IContainedObject *contents, int maxDepth, int maxNodes, SearchClock *clock);
+	Tree(const Tree *sourceTree, SearchClock *clock);
 	~Tree();
 
 	void duplicateTree(Node *sourceNode, Node *destNode);
@@ -74,7 +99,20 @@ public:
 	Node *aStarSearch();
 
 	Node *aStarSearch_singlePassInit();
-	Node *aStarSearch_singlePass();
+
+	/**
+	 * Continue the search started by aStarSearch_singlePassInit().
+	 *
+	 * @param budget	if not 0, keep expanding nodes for up to this many
+	 * 					milliseconds, until a result is found or the
+	 * 					children of a node can only be completed in a
+	 * 					later frame; if 0, expand a single node
+	 * @return the resulting node, or NULL if the search is not done yet
+	 */
+	Node *aStarSearch_singlePass(uint32 budget = 0);
+
+	/** Number of nodes expanded by this tree so far. */
+	uint32 getExpandedNodes() const { return _expandedNodes; }
 
 	int IsBaseNode(Node *thisNode);
 };
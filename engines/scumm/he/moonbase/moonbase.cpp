@@ -23,6 +23,7 @@
 #include "scumm/he/intern_he.h"
 #include "scumm/he/moonbase/moonbase.h"
 #include "scumm/he/moonbase/ai_main.h"
+#include "scumm/he/moonbase/ai_node.h"
 
 namespace Scumm {
 
@@ -34,6 +35,7 @@ Moonbase::Moonbase(ScummEngine_v100he *vm) : _vm(vm) {
 
 Moonbase::~Moonbase() {
 	delete _ai;
+	Node::freePool();
 }
 
 int Moonbase::readFromArray(int array, int y, int x) {
@@ -1134,6 +1134,8 @@ void ResourceManager::resourceStats() {
 	}
 
 	debug(1, "Total allocated size=%d, locked=%d(%d)", _allocatedSize, lockedSize, lockedNum);
+	debug(1, "Room strip cache size=%u, hits=%u, misses=%u", _vm->_gdi->getStripCacheSize(),
+		_vm->_gdi->getStripCacheHits(), _vm->_gdi->getStripCacheMisses());
 }
 
 void ScummEngine_v5::readMAXS(int blockSize) {
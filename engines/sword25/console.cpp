@@ -22,14 +22,31 @@
 
 #include "sword25/console.h"
 #include "sword25/sword25.h"
+#include "sword25/kernel/kernel.h"
+#include "sword25/kernel/resmanager.h"
 
 namespace Sword25 {
 
 Sword25Console::Sword25Console(Sword25Engine *vm) : GUI::Debugger(), _vm(vm) {
 	assert(_vm);
+
+	registerCmd("resources", WRAP_METHOD(Sword25Console, cmdResources));
 }
 
 Sword25Console::~Sword25Console() {
 }
 
+bool Sword25Console::cmdResources(int argc, const char **argv) {
+	ResourceManager *resources = Kernel::getInstance()->getResourceManager();
+	const ResourceManager::Statistics &stats = resources->getStatistics();
+
+	debugPrintf("Memory: %u of %u KB used, %u KB at most\n", resources->getUsedMemory() / 1024,
+		resources->getMaxMemoryUsage() / 1024, stats.peakMemory / 1024);
+	debugPrintf("Requests: %u hits, %u misses\n", stats.hits, stats.misses);
+	debugPrintf("Resources: %u preloaded, %u released, %u ms spent loading\n", stats.preloads,
+		stats.evictions, stats.loadTime);
+
+	return true;
+}
+
 } // End of namespace Sword25
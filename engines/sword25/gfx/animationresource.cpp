@@ -203,6 +203,14 @@ bool AnimationResource::parserCallback_frame(ParserNode *node) {
 AnimationResource::~AnimationResource() {
 }
 
+uint AnimationResource::getSize() const {
+	uint size = sizeof(*this) + getFileName().size();
+	Common::Array<Frame>::const_iterator iter = _frames.begin();
+	for (; iter != _frames.end(); ++iter)
+		size += sizeof(Frame) + iter->fileName.size() + iter->action.size();
+	return size;
+}
+
 bool AnimationResource::precacheAllFrames() const {
 	Common::Array<Frame>::const_iterator iter = _frames.begin();
 	for (; iter != _frames.end(); ++iter) {
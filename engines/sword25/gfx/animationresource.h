@@ -80,6 +80,12 @@ public:
 		return _valid;
 	}
 
+	/**
+	 * Returns the size of the animation description. The frames are
+	 * bitmap resources of their own.
+	 */
+	virtual uint getSize() const;
+
 private:
 	bool _valid;
 
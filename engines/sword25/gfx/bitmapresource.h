@@ -51,6 +51,13 @@ public:
 		return (_pImage != 0);
 	}
 
+	/**
+	 * Returns the size of the decoded image, with four bytes per pixel
+	 */
+	virtual uint getSize() const {
+		return _pImage ? _pImage->getWidth() * _pImage->getHeight() * 4 : 0;
+	}
+
 	/**
 	    @brief Gibt die Breite des Bitmaps zurck.
 	*/
@@ -96,6 +96,14 @@ public:
 		return _bitmapFileName;
 	}
 
+	/**
+	 * Returns the size of the font description. The character map is
+	 * a bitmap resource of its own.
+	 */
+	virtual uint getSize() const {
+		return sizeof(*this) + getFileName().size() + _bitmapFileName.size();
+	}
+
 private:
 	Kernel *_pKernel;
 	bool _valid;
@@ -44,6 +44,7 @@
 #include "sword25/package/packagemanager.h"
 #include "sword25/kernel/inputpersistenceblock.h"
 #include "sword25/kernel/outputpersistenceblock.h"
+#include "sword25/kernel/resmanager.h"
 
 
 #include "sword25/gfx/graphicengine.h"
@@ -146,6 +147,9 @@ bool GraphicEngine::endFrame() {
 
 	g_system->updateScreen();
 
+	// Load the resources queued for the next scene, a few per frame
+	Kernel::getInstance()->getResourceManager()->preloadQueued(5);
+
 	return true;
 }
 
@@ -129,9 +129,14 @@ static int getSubversionRevision(lua_State *L) {
 }
 
 static int getUsedMemory(lua_State *L) {
-	// It doesn't really matter what this call returns,
-	// as it's used in a debug function.
-	lua_pushnumber(L, 0);
+	// This is used in a debug function. Only the memory of the
+	// resource cache is counted.
+	Kernel *pKernel = Kernel::getInstance();
+	assert(pKernel);
+	ResourceManager *pResource = pKernel->getResourceManager();
+	assert(pResource);
+
+	lua_pushnumber(L, pResource->getUsedMemory());
 	return 1;
 }
 
@@ -313,6 +318,8 @@ static int precacheResource(lua_State *L) {
 #ifdef PRECACHE_RESOURCES
 	lua_pushbooleancpp(L, pResource->precacheResource(luaL_checkstring(L, 1)));
 #else
+	// The resource is loaded in the time left over by the next frames
+	pResource->queuePreload(luaL_checkstring(L, 1));
 	lua_pushbooleancpp(L, true);
 #endif
 
@@ -340,9 +347,7 @@ static int getMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This is used for debugging, so it doesn't really matter.
-	// The default value set by the scripts is 256000000 bytes
-	lua_pushnumber(L, 256000000);
+	lua_pushnumber(L, pResource->getMaxMemoryUsage());
 
 	return 1;
 }
@@ -353,8 +358,9 @@ static int setMaxMemoryUsage(lua_State *L) {
 	ResourceManager *pResource = pKernel->getResourceManager();
 	assert(pResource);
 
-	// This call is ignored, we set a limit on the number of
-	// simultaneous resources loaded instead.
+	// The scripts set 256000000 bytes. The number of simultaneously
+	// loaded resources is limited as well.
+	pResource->setMaxMemoryUsage(static_cast<uint>(luaL_checknumber(L, 1)));
 
 	return 0;
 }
@@ -35,6 +35,8 @@
 #include "sword25/kernel/resservice.h"
 #include "sword25/package/packagemanager.h"
 
+#include "common/algorithm.h"
+
 namespace Sword25 {
 
 // Sets the amount of resources that are simultaneously loaded.
@@ -46,8 +48,27 @@ namespace Sword25 {
 // are loaded, the resource manager will start purging resources till it
 // hits the minimum limit above
 #define SWORD25_RESOURCECACHE_MAX 500
+// The most memory the loaded resources may use, in bytes. The game scripts
+// ask for 256000000 bytes, ports for devices with less memory can lower it.
+#ifndef SWORD25_RESOURCECACHE_MEMORY
+#define SWORD25_RESOURCECACHE_MEMORY 256000000
+#endif
+// The most resources waiting to be preloaded. The scripts queue the resources
+// of the next scene, so older entries are dropped first.
+#define SWORD25_PRELOADQUEUE_MAX 100
+
+ResourceManager::ResourceManager(Kernel *pKernel) :
+	_kernelPtr(pKernel),
+	_preloadQueueSize(0),
+	_usedMemory(0),
+	_maxMemory(SWORD25_RESOURCECACHE_MEMORY),
+	_priorityBase(0) {
+	memset(&_statistics, 0, sizeof(_statistics));
+}
 
 ResourceManager::~ResourceManager() {
+	dumpStatistics();
+
 	// Clear all unlocked resources
 	emptyCache();
 
@@ -83,34 +104,48 @@ bool ResourceManager::registerResourceService(ResourceService *pService) {
 }
 
 /**
- * Deletes resources as necessary until the specified memory limit is not being exceeded.
+ * Deletes resources as necessary until the specified limits are not being exceeded.
+ *
+ * Unlocked resources are released by priority. Whenever a resource is requested,
+ * it gets the priority of the last released resource, plus its load time per
+ * kilobyte (the GreedyDual-Size policy). Large resources which load quickly are
+ * released first, and resources which are no longer used age out.
  */
 void ResourceManager::deleteResourcesIfNecessary() {
-	// If enough memory is available, or no resources are loaded, then the function can immediately end
-	if (_resources.size() < SWORD25_RESOURCECACHE_MAX)
+	const bool overCount = _resources.size() >= SWORD25_RESOURCECACHE_MAX;
+	const bool overMemory = _usedMemory > _maxMemory;
+
+	// If enough memory is available, then the function can immediately end
+	if (!overCount && !overMemory)
 		return;
 
-	// Keep deleting resources until the memory usage of the process falls below the set maximum limit.
-	// The list is processed backwards in order to first release those resources that have been
-	// not been accessed for the longest
-	Common::List<Resource *>::iterator iter = _resources.end();
-	do {
-		--iter;
+	// Release some more memory than needed, so this does not happen on every load
+	const uint memoryTarget = _maxMemory - _maxMemory / 8;
 
-		// The resource may be released only if it isn't locked
-		if ((*iter)->getLockCount() == 0)
-			iter = deleteResource(*iter);
-	} while (iter != _resources.begin() && _resources.size() >= SWORD25_RESOURCECACHE_MIN);
+	// Sort the unlocked resources once, rather than searching for the next one
+	// for every resource released
+	Common::Array<EvictionCandidate> candidates;
+	getEvictionCandidates(candidates);
+
+	for (uint i = 0; i < candidates.size() &&
+			((overCount && _resources.size() >= SWORD25_RESOURCECACHE_MIN) ||
+			(overMemory && _usedMemory > memoryTarget)); ++i) {
+		Resource *pResource = candidates[i].resource;
+
+		_priorityBase = pResource->_priority;
+		_statistics.evictions++;
+		deleteResource(pResource);
+	}
 
 	// Are we still above the minimum? If yes, then start releasing locked resources
 	// FIXME: This code shouldn't be needed at all, but it seems like there is a bug
 	// in the resource lock code, and resources are not unlocked when changing rooms.
 	// Only image/animation resources are unlocked forcibly, thus this shouldn't have
 	// any impact on the game itself.
-	if (_resources.size() <= SWORD25_RESOURCECACHE_MIN)
+	if (!overCount || _resources.size() <= SWORD25_RESOURCECACHE_MIN)
 		return;
 
-	iter = _resources.end();
+	Common::List<Resource *>::iterator iter = _resources.end();
 	do {
 		--iter;
 
@@ -172,8 +207,12 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 	// Determine whether the resource is already loaded
 	// If the resource is found, it will be placed at the head of the resource list and returned
 	Resource *pResource = getResource(uniqueFileName);
-	if (!pResource)
+	if (pResource) {
+		_statistics.hits++;
+	} else {
+		_statistics.misses++;
 		pResource = loadResource(uniqueFileName);
+	}
 	if (pResource) {
 		moveToFront(pResource);
 		(pResource)->addReference();
@@ -183,8 +222,6 @@ Resource *ResourceManager::requestResource(const Common::String &fileName) {
 	return NULL;
 }
 
-#ifdef PRECACHE_RESOURCES
-
 /**
  * Loads a resource into the cache
  * @param FileName      The filename of the resource to be cached
@@ -218,10 +255,75 @@ bool ResourceManager::precacheResource(const Common::String &fileName, bool forc
 	return true;
 }
 
-#endif
+/**
+ * Queues a resource to be loaded into the cache by preloadQueued()
+ * @param FileName      The filename of the resource to be cached
+ */
+void ResourceManager::queuePreload(const Common::String &fileName) {
+	Common::String uniqueFileName = getUniqueFileName(fileName);
+	if (uniqueFileName.empty() || getResource(uniqueFileName))
+		return;
+
+	if (_preloadQueueSize >= SWORD25_PRELOADQUEUE_MAX) {
+		debugC(kDebugResource, "Preload queue is full, dropping \"%s\"", _preloadQueue.front().c_str());
+		_preloadQueue.pop_front();
+		--_preloadQueueSize;
+	}
+	_preloadQueue.push_back(uniqueFileName);
+	++_preloadQueueSize;
+}
+
+/**
+ * Loads queued resources, until the given time is used up
+ * @param MaxMillis     The time which may be spent, in milliseconds
+ */
+void ResourceManager::preloadQueued(uint maxMillis) {
+	const uint startTime = _kernelPtr->getMilliTicks();
+
+	while (!_preloadQueue.empty() && _kernelPtr->getMilliTicks() - startTime < maxMillis) {
+		// Preloading must not release the resources which are in use now.
+		// Keep the queue, room may be made by the time of the next frame.
+		if (_resources.size() >= SWORD25_RESOURCECACHE_MIN || _usedMemory > _maxMemory - _maxMemory / 8)
+			break;
+
+		Common::String fileName = _preloadQueue.front();
+		_preloadQueue.pop_front();
+		--_preloadQueueSize;
+
+		// The resource may have been requested in the meantime
+		if (getResource(fileName))
+			continue;
+
+		if (!_kernelPtr->getPackage()->fileExists(fileName)) {
+			debugC(kDebugResource, "Could not preload \"%s\", it does not exist", fileName.c_str());
+			continue;
+		}
+
+		if (loadResource(fileName))
+			_statistics.preloads++;
+	}
+}
+
+/**
+ * Sets the memory the cached resources may use
+ * @param Bytes         The memory limit in bytes
+ */
+void ResourceManager::setMaxMemoryUsage(uint bytes) {
+	_maxMemory = MIN<uint>(bytes, SWORD25_RESOURCECACHE_MEMORY);
+}
+
+/**
+ * Writes the cache statistics to the log file
+ */
+void ResourceManager::dumpStatistics() {
+	debugC(kDebugResource, "Resource cache: %u resources, %u of %u KB used, %u KB at most",
+		_resources.size(), _usedMemory / 1024, _maxMemory / 1024, _statistics.peakMemory / 1024);
+	debugC(kDebugResource, "%u hits, %u misses, %u preloaded, %u released, %u ms spent loading",
+		_statistics.hits, _statistics.misses, _statistics.preloads, _statistics.evictions, _statistics.loadTime);
+}
 
 /**
- * Moves a resource to the top of the resource list
+ * Moves a resource to the top of the resource list, and raises its priority
  * @param pResource     The resource
  */
 void ResourceManager::moveToFront(Resource *pResource) {
@@ -231,6 +333,46 @@ void ResourceManager::moveToFront(Resource *pResource) {
 	_resources.push_front(pResource);
 	// Reset the resource iterator to the repositioned item
 	pResource->_iterator = _resources.begin();
+
+	updatePriority(pResource);
+}
+
+/**
+ * Sets the priority of a resource which was just requested or loaded
+ * @param pResource     The resource
+ */
+void ResourceManager::updatePriority(Resource *pResource) {
+	// Resources which load within a millisecond, or are smaller than a
+	// kilobyte, are not treated as free
+	pResource->_priority = _priorityBase + (float)(pResource->_loadTime + 1) / (pResource->_size / 1024 + 1);
+}
+
+/**
+ * Returns the unlocked resources, sorted in the order they are released in
+ * @param Candidates    The array the resources are stored in
+ */
+void ResourceManager::getEvictionCandidates(Common::Array<EvictionCandidate> &candidates) const {
+	candidates.clear();
+	if (_resources.empty())
+		return;
+
+	// Of resources with the same priority, the one not accessed for the longest
+	// is released first. It is the last of them in the list.
+	uint age = 0;
+	Common::List<Resource *>::const_iterator iter = _resources.end();
+	do {
+		--iter;
+		if ((*iter)->getLockCount() == 0) {
+			EvictionCandidate candidate;
+			candidate.resource = *iter;
+			candidate.priority = (*iter)->_priority;
+			candidate.age = age;
+			candidates.push_back(candidate);
+		}
+		++age;
+	} while (iter != _resources.begin());
+
+	Common::sort(candidates.begin(), candidates.end());
 }
 
 /**
@@ -247,15 +389,24 @@ Resource *ResourceManager::loadResource(const Common::String &fileName) {
 			deleteResourcesIfNecessary();
 
 			// Load the resource
+			const uint startTime = _kernelPtr->getMilliTicks();
 			Resource *pResource = _resourceServices[i]->loadResource(fileName);
 			if (!pResource) {
 				error("Responsible service could not load resource \"%s\".", fileName.c_str());
 				return NULL;
 			}
 
+			pResource->_loadTime = _kernelPtr->getMilliTicks() - startTime;
+			pResource->_size = pResource->getSize();
+
+			_usedMemory += pResource->_size;
+			_statistics.loadTime += pResource->_loadTime;
+			_statistics.peakMemory = MAX(_statistics.peakMemory, _usedMemory);
+
 			// Add the resource to the front of the list
 			_resources.push_front(pResource);
 			pResource->_iterator = _resources.begin();
+			updatePriority(pResource);
 
 			// Also store the resource in the hash table for quick lookup
 			_resourceHashMap[pResource->getFileName()] = pResource;
@@ -296,6 +447,8 @@ Common::List<Resource *>::iterator ResourceManager::deleteResource(Resource *pRe
 	// Remove the resource from the hash table
 	_resourceHashMap.erase(pResource->_fileName);
 
+	_usedMemory -= pResource->_size;
+
 	// Delete the resource from the resource list
 	Common::List<Resource *>::iterator result = _resources.erase(pResource->_iterator);
 
@@ -32,6 +32,7 @@
 #ifndef SWORD25_RESOURCEMANAGER_H
 #define SWORD25_RESOURCEMANAGER_H
 
+#include "common/array.h"
 #include "common/list.h"
 #include "common/hashmap.h"
 #include "common/hash-str.h"
@@ -56,7 +57,6 @@ public:
 	 */
 	Resource *requestResource(const Common::String &fileName);
 
-#ifdef PRECACHE_RESOURCES
 	/**
 	 * Loads a resource into the cache
 	 * @param FileName      The filename of the resource to be cached
@@ -64,7 +64,63 @@ public:
 	 * This is useful for files that may have changed in the interim
 	 */
 	bool precacheResource(const Common::String &fileName, bool forceReload = false);
-#endif
+
+	/**
+	 * Queues a resource to be loaded into the cache by preloadQueued(),
+	 * e.g. for the next scene. If the queue is full, the oldest entry
+	 * is dropped.
+	 * @param FileName      The filename of the resource to be cached
+	 */
+	void queuePreload(const Common::String &fileName);
+
+	/**
+	 * Loads queued resources, until the given time is used up or the cache
+	 * is full. This is called once per frame, after the frame is shown.
+	 * @param MaxMillis     The time which may be spent, in milliseconds
+	 */
+	void preloadQueued(uint maxMillis);
+
+	/**
+	 * Sets the memory the cached resources may use. The value is
+	 * limited to SWORD25_RESOURCECACHE_MEMORY.
+	 * @param Bytes         The memory limit in bytes
+	 */
+	void setMaxMemoryUsage(uint bytes);
+
+	/**
+	 * Returns the memory the cached resources may use, in bytes
+	 */
+	uint getMaxMemoryUsage() const {
+		return _maxMemory;
+	}
+
+	/**
+	 * Returns the estimated memory used by the cached resources, in bytes
+	 */
+	uint getUsedMemory() const {
+		return _usedMemory;
+	}
+
+	/**
+	 * Counters for tuning the size of the cache
+	 */
+	struct Statistics {
+		uint hits;               ///< Requests for resources which were in the cache
+		uint misses;             ///< Requests for resources which had to be loaded
+		uint preloads;           ///< Resources loaded by preloadQueued()
+		uint evictions;          ///< Resources released to stay within the limits
+		uint loadTime;           ///< The total time spent loading resources, in milliseconds
+		uint peakMemory;         ///< The highest memory usage, in bytes
+	};
+
+	const Statistics &getStatistics() const {
+		return _statistics;
+	}
+
+	/**
+	 * Writes the cache statistics to the log file
+	 */
+	void dumpStatistics();
 
 	/**
 	 * Registers a RegisterResourceService. This method is the constructor of
@@ -93,17 +149,39 @@ private:
 	 * Creates a new resource manager
 	 * Only the BS_Kernel class can generate copies this class. Thus, the constructor is private
 	 */
-	ResourceManager(Kernel *pKernel) :
-		_kernelPtr(pKernel)
-	{}
+	ResourceManager(Kernel *pKernel);
 	virtual ~ResourceManager();
 
 	/**
-	 * Moves a resource to the top of the resource list
+	 * Moves a resource to the top of the resource list, and raises its priority
 	 * @param pResource     The resource
 	 */
 	void moveToFront(Resource *pResource);
 
+	/**
+	 * Sets the priority of a resource which was just requested or loaded
+	 * @param pResource     The resource
+	 */
+	void updatePriority(Resource *pResource);
+
+	/**
+	 * An unlocked resource, with the position it is released in
+	 */
+	struct EvictionCandidate {
+		Resource *resource;
+		float priority;
+		uint age;                ///< Resources not accessed for longer have a lower age, and go first
+		bool operator<(const EvictionCandidate &other) const {
+			return priority < other.priority || (priority == other.priority && age < other.age);
+		}
+	};
+
+	/**
+	 * Returns the unlocked resources, sorted in the order they are released in
+	 * @param Candidates    The array the resources are stored in
+	 */
+	void getEvictionCandidates(Common::Array<EvictionCandidate> &candidates) const;
+
 	/**
 	 * Loads a resource and updates the m_UsedMemory total
 	 *
@@ -139,6 +217,12 @@ private:
 	Common::List<Resource *> _resources;
 	typedef Common::HashMap<Common::String, Resource *> ResMap;
 	ResMap _resourceHashMap;
+	Common::List<Common::String> _preloadQueue;
+	uint _preloadQueueSize;
+	uint _usedMemory;
+	uint _maxMemory;
+	float _priorityBase;
+	Statistics _statistics;
 };
 
 } // End of namespace Sword25
@@ -92,6 +92,11 @@ public:
 		return _type;
 	}
 
+	/**
+	 * Returns an estimate of the memory used by the resource, in bytes
+	 */
+	virtual uint getSize() const = 0;
+
 protected:
 	virtual ~Resource() {}
 
@@ -100,6 +105,9 @@ private:
 	uint _refCount;          ///< The number of locks
 	uint _type;              ///< The type of the resource
 	Common::List<Resource *>::iterator _iterator;        ///< Points to the resource position in the LRU list
+	uint _size;              ///< The size of the resource when it was loaded, in bytes
+	uint _loadTime;          ///< The time it took to load the resource, in milliseconds
+	float _priority;         ///< The resource with the lowest priority is released first
 };
 
 } // End of namespace Sword25
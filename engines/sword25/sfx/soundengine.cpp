@@ -51,6 +51,14 @@ public:
 		debugC(1, kDebugSound, "SoundResource: Unloading file %s", _fname.c_str());
 	}
 
+	/**
+	 * Sounds are streamed from the package when played, so only the
+	 * names are kept
+	 */
+	virtual uint getSize() const {
+		return sizeof(*this) + getFileName().size() + _fname.size();
+	}
+
 private:
 	Common::String _fname;
 };
@@ -87,6 +87,7 @@ void AdScene::setDefaults() {
 	_pfReady = true;
 	_pfTargetPath = nullptr;
 	_pfRequester = nullptr;
+	_pfOpenValid = false;
 	_mainLayer = nullptr;
 
 	_pfPointsNum = 0;
@@ -175,6 +176,9 @@ void AdScene::cleanup() {
 	}
 	_pfPath.clear();
 	_pfPointsNum = 0;
+	_pfOpen.clear();
+	_pfBlockRegions.clear();
+	_walkGraph.clear();
 
 	for (uint32 i = 0; i < _objects.size(); i++) {
 		_gameRef->unregisterObject(_objects[i]);
@@ -203,6 +207,7 @@ bool AdScene::getPath(const BasePoint &source, const BasePoint &target, AdPath *
 
 		// prepare working path
 		pfPointsStart();
+		_pfOpenValid = false;
 
 		// first point
 		//_pfPath.add(new AdPathPoint(source.x, source.y, 0));
@@ -419,8 +424,39 @@ bool AdScene::isWalkableAt(int x, int y, bool checkFreeObjects, BaseObject *requ
 }
 
 
-//////////////////////////////////////////////////////////////////////////
-int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject *requester) {
+namespace {
+
+/** Tests the points of a line like AdScene::isBlockedAt(). */
+struct SceneBlockTest {
+	AdScene *scene;
+	bool checkFreeObjects;
+	BaseObject *requester;
+
+	bool operator()(int x, int y) const {
+		return scene->isBlockedAt(x, y, checkFreeObjects, requester);
+	}
+};
+
+/** Tests the points of a line against a few block regions only. */
+struct RegionBlockTest {
+	const Common::Array<BaseRegion *> *regions;
+
+	bool operator()(int x, int y) const {
+		for (uint32 i = 0; i < regions->size(); i++) {
+			if ((*regions)[i]->pointInRegion(x, y)) {
+				return true;
+			}
+		}
+		return false;
+	}
+};
+
+/**
+ * Walks the line between two points pixel by pixel, always from the same end.
+ * @return -1 if isBlocked is true for any of its points, otherwise the length of the line
+ */
+template<class BlockTest>
+int walkLine(const BasePoint &p1, const BasePoint &p2, const BlockTest &isBlocked) {
 	double xStep, yStep, x, y;
 	int xLength, yLength, xCount, yCount;
 	int x1, y1, x2, y2;
@@ -443,7 +479,7 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 		y = y1;
 
 		for (xCount = x1; xCount < x2; xCount++) {
-			if (isBlockedAt(xCount, (int)y, true, requester)) {
+			if (isBlocked(xCount, (int)y)) {
 				return -1;
 			}
 			y += yStep;
@@ -458,7 +494,7 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 		x = x1;
 
 		for (yCount = y1; yCount < y2; yCount++) {
-			if (isBlockedAt((int)x, yCount, true, requester)) {
+			if (isBlocked((int)x, yCount)) {
 				return -1;
 			}
 			x += xStep;
@@ -467,19 +503,148 @@ int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject
 	return MAX(xLength, yLength);
 }
 
+} // End of anonymous namespace
+
+
+//////////////////////////////////////////////////////////////////////////
+int AdScene::getPointsDist(const BasePoint &p1, const BasePoint &p2, BaseObject *requester) {
+	SceneBlockTest test = { this, true, requester };
+	return walkLine(p1, p2, test);
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdScene::pfStepsStart() {
+	// Pick up the regions toggled by the scripts since the last frame
+	_walkGraph.update(_mainLayer);
+
+	// The free objects may have moved since the last frame, too
+	_pfBlockRegions.clear();
+	for (uint32 i = 0; i < _objects.size(); i++) {
+		if (_objects[i]->_active && _objects[i] != _pfRequester && _objects[i]->_currentBlockRegion) {
+			_pfBlockRegions.push_back(_objects[i]->_currentBlockRegion);
+		}
+	}
+	AdGame *adGame = (AdGame *)_gameRef;
+	for (uint32 i = 0; i < adGame->_objects.size(); i++) {
+		if (adGame->_objects[i]->_active && adGame->_objects[i] != _pfRequester && adGame->_objects[i]->_currentBlockRegion) {
+			_pfBlockRegions.push_back(adGame->_objects[i]->_currentBlockRegion);
+		}
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+int AdScene::pfGetPointsDist(const AdPathPoint &p1, const AdPathPoint &p2) {
+	// Same result as getPointsDist(p1, p2, _pfRequester): a point is blocked
+	// by the scene regions or by a free object, and the scene part is cached
+	int32 distance;
+	if (!_walkGraph.getDistance(p1, p2, distance)) {
+		SceneBlockTest sceneTest = { this, false, nullptr };
+		distance = walkLine(p1, p2, sceneTest);
+		_walkGraph.setDistance(p1, p2, distance);
+	}
+
+	if (distance == -1) {
+		return -1;
+	}
+
+	// Only walk the line again if a free object is close to it
+	const int32 left = MIN(p1.x, p2.x);
+	const int32 right = MAX(p1.x, p2.x);
+	const int32 top = MIN(p1.y, p2.y);
+	const int32 bottom = MAX(p1.y, p2.y);
+	for (uint32 i = 0; i < _pfBlockRegions.size(); i++) {
+		const Rect32 &rect = _pfBlockRegions[i]->_rect;
+		if (left <= rect.right && right >= rect.left - 1 && top <= rect.bottom && bottom >= rect.top - 1) {
+			RegionBlockTest objectTest = { &_pfBlockRegions };
+			return walkLine(p1, p2, objectTest);
+		}
+	}
+
+	return distance;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdScene::pfOpenPush(int32 index) {
+	PfOpenPoint point;
+	point.distance = _pfPath[index]->_distance;
+	point.index = index;
+	_pfOpen.push_back(point);
+
+	uint32 pos = _pfOpen.size() - 1;
+	while (pos > 0) {
+		const uint32 parent = (pos - 1) / 2;
+		if (!(_pfOpen[pos] < _pfOpen[parent])) {
+			break;
+		}
+		SWAP(_pfOpen[pos], _pfOpen[parent]);
+		pos = parent;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+AdScene::PfOpenPoint AdScene::pfOpenPop() {
+	const PfOpenPoint top = _pfOpen[0];
+	_pfOpen[0] = _pfOpen.back();
+	_pfOpen.pop_back();
+
+	uint32 pos = 0;
+	for (;;) {
+		const uint32 leftChild = pos * 2 + 1;
+		const uint32 rightChild = leftChild + 1;
+		uint32 smallest = pos;
+		if (leftChild < _pfOpen.size() && _pfOpen[leftChild] < _pfOpen[smallest]) {
+			smallest = leftChild;
+		}
+		if (rightChild < _pfOpen.size() && _pfOpen[rightChild] < _pfOpen[smallest]) {
+			smallest = rightChild;
+		}
+		if (smallest == pos) {
+			break;
+		}
+		SWAP(_pfOpen[pos], _pfOpen[smallest]);
+		pos = smallest;
+	}
+
+	return top;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdScene::pfOpenRebuild() {
+	// Needed for a new path, and after loading a savegame in the middle of a search
+	_pfOpen.clear();
+	for (int32 i = 0; i < _pfPointsNum; i++) {
+		if (!_pfPath[i]->_marked && _pfPath[i]->_distance < INT_MAX) {
+			pfOpenPush(i);
+		}
+	}
+	_pfOpenValid = true;
+}
+
 
 //////////////////////////////////////////////////////////////////////////
 void AdScene::pathFinderStep() {
 	int i;
-	// get lowest unmarked
-	int lowestDist = INT_MAX;
+	if (!_pfOpenValid) {
+		pfOpenRebuild();
+	}
+
+	// get lowest unmarked, the lowest index first if several are equally close
 	AdPathPoint *lowestPt = nullptr;
 
-	for (i = 0; i < _pfPointsNum; i++)
-		if (!_pfPath[i]->_marked && _pfPath[i]->_distance < lowestDist) {
-			lowestDist = _pfPath[i]->_distance;
-			lowestPt = _pfPath[i];
+	while (!_pfOpen.empty()) {
+		const PfOpenPoint open = pfOpenPop();
+		AdPathPoint *point = _pfPath[open.index];
+		// skip the points queued again with a shorter distance since
+		if (!point->_marked && point->_distance == open.distance) {
+			lowestPt = point;
+			break;
 		}
+	}
 
 	if (lowestPt == nullptr) { // no path -> terminate PathFinder
 		_pfReady = true;
@@ -504,10 +669,11 @@ void AdScene::pathFinderStep() {
 	// otherwise keep on searching
 	for (i = 0; i < _pfPointsNum; i++)
 		if (!_pfPath[i]->_marked) {
-			int j = getPointsDist(*lowestPt, *_pfPath[i], _pfRequester);
+			int j = pfGetPointsDist(*lowestPt, *_pfPath[i]);
 			if (j != -1 && lowestPt->_distance + j < _pfPath[i]->_distance) {
 				_pfPath[i]->_distance = lowestPt->_distance + j;
 				_pfPath[i]->_origin = lowestPt;
+				pfOpenPush(i);
 			}
 		}
 }
@@ -518,6 +684,9 @@ bool AdScene::initLoop() {
 #ifdef _DEBUGxxxx
 	int nu_steps = 0;
 	uint32 start = _gameRef->_currentTime;
+	if (!_pfReady) {
+		pfStepsStart();
+	}
 	while (!_pfReady && g_system->getMillis() - start <= _pfMaxTime) {
 		PathFinderStep();
 		nu_steps++;
@@ -527,6 +696,9 @@ bool AdScene::initLoop() {
 	}
 #else
 	uint32 start = _gameRef->_currentTime;
+	if (!_pfReady) {
+		pfStepsStart();
+	}
 	while (!_pfReady && g_system->getMillis() - start <= _pfMaxTime) {
 		pathFinderStep();
 	}
@@ -2348,6 +2520,10 @@ bool AdScene::persist(BasePersistenceManager *persistMgr) {
 	persistMgr->transferPtr(TMEMBER_PTR(_pfRequester));
 	persistMgr->transferPtr(TMEMBER_PTR(_pfTarget));
 	persistMgr->transferPtr(TMEMBER_PTR(_pfTargetPath));
+	if (!persistMgr->getIsSaving()) {
+		// The open list is not saved, pathFinderStep() rebuilds it from _pfPath
+		_pfOpenValid = false;
+	}
 	_rotLevels.persist(persistMgr);
 	_scaleLevels.persist(persistMgr);
 	persistMgr->transferSint32(TMEMBER(_scrollPixelsH));
@@ -29,6 +29,7 @@
 #ifndef WINTERMUTE_ADSCENE_H
 #define WINTERMUTE_ADSCENE_H
 
+#include "engines/wintermute/ad/ad_walk_graph.h"
 #include "engines/wintermute/base/base_fader.h"
 
 namespace Wintermute {
@@ -39,6 +40,7 @@ class AdRegion;
 class BaseViewport;
 class AdLayer;
 class BasePoint;
+class BaseRegion;
 class AdWaypointGroup;
 class AdPath;
 class AdScaleLevel;
@@ -171,6 +173,28 @@ private:
 	BaseObject *_pfRequester;
 	BaseArray<AdPathPoint *> _pfPath;
 
+	/** A point of _pfPath to visit, with the distance it had when it was queued. */
+	struct PfOpenPoint {
+		int32 distance;
+		int32 index;
+
+		bool operator<(const PfOpenPoint &other) const {
+			return distance < other.distance || (distance == other.distance && index < other.index);
+		}
+	};
+
+	void pfStepsStart();
+	int pfGetPointsDist(const AdPathPoint &p1, const AdPathPoint &p2);
+	void pfOpenPush(int32 index);
+	PfOpenPoint pfOpenPop();
+	void pfOpenRebuild();
+	/** Binary min-heap of the points to visit, rebuilt from _pfPath when not valid */
+	Common::Array<PfOpenPoint> _pfOpen;
+	bool _pfOpenValid;
+	/** The free object block regions in the way of _pfRequester, see pfStepsStart() */
+	Common::Array<BaseRegion *> _pfBlockRegions;
+	AdWalkGraph _walkGraph;
+
 	int32 _offsetTop;
 	int32 _offsetLeft;
 
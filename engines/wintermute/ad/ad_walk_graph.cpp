@@ -0,0 +1,194 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/wintermute/ad/ad_walk_graph.h"
+#include "engines/wintermute/ad/ad_scene_node.h"
+#include "engines/wintermute/ad/ad_layer.h"
+#include "engines/wintermute/base/base_point.h"
+#include "common/algorithm.h"
+
+namespace Wintermute {
+
+enum {
+	// Beyond this, a few waypoint heavy scenes would keep every line ever tested
+	kMaxEdges = 16384,
+	// Beyond this, dropping the lines one region at a time costs more than
+	// testing them again
+	kMaxChangedRects = 16
+};
+
+//////////////////////////////////////////////////////////////////////////
+AdWalkGraph::Edge::Edge(const BasePoint &p1, const BasePoint &p2) {
+	// Both directions of a line share one entry
+	if (p1.x < p2.x || (p1.x == p2.x && p1.y <= p2.y)) {
+		x1 = p1.x;
+		y1 = p1.y;
+		x2 = p2.x;
+		y2 = p2.y;
+	} else {
+		x1 = p2.x;
+		y1 = p2.y;
+		x2 = p1.x;
+		y2 = p1.y;
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+uint AdWalkGraph::EdgeHash::operator()(const Edge &edge) const {
+	uint hash = (uint)edge.x1;
+	hash = hash * 33 + (uint)edge.y1;
+	hash = hash * 33 + (uint)edge.x2;
+	hash = hash * 33 + (uint)edge.y2;
+	return hash;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool AdWalkGraph::RegionState::operator==(const RegionState &other) const {
+	return region == other.region && active == other.active && blocked == other.blocked &&
+	       rect == other.rect && pointsHash == other.pointsHash;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+AdWalkGraph::AdWalkGraph() {
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+AdWalkGraph::~AdWalkGraph() {
+	clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdWalkGraph::clear() {
+	_edges.clear();
+	_regions.clear();
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdWalkGraph::update(AdLayer *mainLayer) {
+	Common::Array<RegionState> regions;
+
+	if (mainLayer) {
+		for (uint32 i = 0; i < mainLayer->_nodes.size(); i++) {
+			AdSceneNode *node = mainLayer->_nodes[i];
+			if (node->_type != OBJECT_REGION) {
+				continue;
+			}
+
+			AdRegion *region = node->_region;
+			RegionState state;
+			state.region = region;
+			state.active = region->_active && !region->hasDecoration();
+			state.blocked = region->isBlocked();
+			state.rect = region->_rect;
+			state.pointsHash = region->_points.size();
+			for (uint32 j = 0; j < region->_points.size(); j++) {
+				state.pointsHash = state.pointsHash * 33 + (uint32)region->_points[j]->x;
+				state.pointsHash = state.pointsHash * 33 + (uint32)region->_points[j]->y;
+			}
+			regions.push_back(state);
+		}
+	}
+
+	// Usually nothing changed at all
+	if (regions.size() == _regions.size()) {
+		uint32 i = 0;
+		while (i < regions.size() && regions[i] == _regions[i]) {
+			i++;
+		}
+		if (i == regions.size()) {
+			return;
+		}
+	}
+
+	// The regions which were removed or changed, and those which were added
+	// or changed. Inactive regions do not block or free any line.
+	Common::Array<Rect32> changedRects;
+	for (uint32 i = 0; i < _regions.size(); i++) {
+		if (_regions[i].active && Common::find(regions.begin(), regions.end(), _regions[i]) == regions.end()) {
+			changedRects.push_back(_regions[i].rect);
+		}
+	}
+	for (uint32 i = 0; i < regions.size(); i++) {
+		if (regions[i].active && Common::find(_regions.begin(), _regions.end(), regions[i]) == _regions.end()) {
+			changedRects.push_back(regions[i].rect);
+		}
+	}
+
+	if (changedRects.size() > kMaxChangedRects) {
+		_edges.clear();
+	} else {
+		for (uint32 i = 0; i < changedRects.size(); i++) {
+			invalidate(changedRects[i]);
+		}
+	}
+
+	_regions = regions;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdWalkGraph::invalidate(const Rect32 &rect) {
+	if (_edges.empty()) {
+		return;
+	}
+
+	// BaseRegion::pointInRegion() is false outside the rect of the region,
+	// and a line only tests points within its own bounds
+	for (EdgeMap::iterator it = _edges.begin(); it != _edges.end(); ++it) {
+		const Edge &edge = it->_key;
+		const int32 top = MIN(edge.y1, edge.y2);
+		const int32 bottom = MAX(edge.y1, edge.y2);
+		if (edge.x1 <= rect.right && edge.x2 >= rect.left - 1 && top <= rect.bottom && bottom >= rect.top - 1) {
+			_edges.erase(it);
+		}
+	}
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+bool AdWalkGraph::getDistance(const BasePoint &p1, const BasePoint &p2, int32 &distance) const {
+	EdgeMap::const_iterator it = _edges.find(Edge(p1, p2));
+	if (it == _edges.end()) {
+		return false;
+	}
+
+	distance = it->_value;
+	return true;
+}
+
+
+//////////////////////////////////////////////////////////////////////////
+void AdWalkGraph::setDistance(const BasePoint &p1, const BasePoint &p2, int32 distance) {
+	if (_edges.size() >= kMaxEdges) {
+		_edges.clear();
+	}
+
+	_edges[Edge(p1, p2)] = distance;
+}
+
+} // End of namespace Wintermute
@@ -0,0 +1,104 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef WINTERMUTE_ADWALKGRAPH_H
+#define WINTERMUTE_ADWALKGRAPH_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "engines/wintermute/math/rect32.h"
+
+namespace Wintermute {
+
+class AdLayer;
+class BasePoint;
+class BaseRegion;
+
+/**
+ * Remembers which straight lines between two points of a scene can be
+ * walked, as far as the regions of the main layer are concerned. These
+ * lines are the edges of the graph AdScene::pathFinderStep() searches, and
+ * the same edges between the waypoints are tested again for every path.
+ *
+ * update() compares the regions with their state at the previous call.
+ * When a region was switched on or off, moved or reshaped, only the lines
+ * which pass through its bounding rect are dropped.
+ *
+ * The block regions of the free objects are not part of the graph, they
+ * move with the actors and depend on the object looking for a path.
+ */
+class AdWalkGraph {
+public:
+	AdWalkGraph();
+	~AdWalkGraph();
+
+	/** Drops the lines the regions of the layer changed since the last call. */
+	void update(AdLayer *mainLayer);
+
+	/** Drops all lines and forgets the regions. */
+	void clear();
+
+	/**
+	 * Gets the cached distance between two points.
+	 * @return false if the line between them has not been tested yet
+	 */
+	bool getDistance(const BasePoint &p1, const BasePoint &p2, int32 &distance) const;
+
+	/** Stores the distance between two points, -1 if the line is blocked. */
+	void setDistance(const BasePoint &p1, const BasePoint &p2, int32 distance);
+
+private:
+	struct Edge {
+		int32 x1, y1, x2, y2;
+
+		Edge(const BasePoint &p1, const BasePoint &p2);
+		bool operator==(const Edge &other) const {
+			return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
+		}
+	};
+
+	struct EdgeHash {
+		uint operator()(const Edge &edge) const;
+	};
+
+	/** The state of a region node, as far as AdScene::isBlockedAt() looks at it. */
+	struct RegionState {
+		BaseRegion *region;
+		bool active;		///< active and not a decoration region
+		bool blocked;
+		Rect32 rect;
+		uint32 pointsHash;
+
+		bool operator==(const RegionState &other) const;
+	};
+
+	typedef Common::HashMap<Edge, int32, EdgeHash> EdgeMap;
+
+	void invalidate(const Rect32 &rect);
+
+	EdgeMap _edges;
+	Common::Array<RegionState> _regions;
+};
+
+} // End of namespace Wintermute
+
+#endif
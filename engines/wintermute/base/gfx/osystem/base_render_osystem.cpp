@@ -57,7 +57,6 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -68,15 +67,11 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 //////////////////////////////////////////////////////////////////////////
 BaseRenderOSystem::~BaseRenderOSystem() {
-	RenderQueueIterator it = _renderQueue.begin();
-	while (it != _renderQueue.end()) {
-		RenderTicket *ticket = *it;
-		it = _renderQueue.erase(it);
-		delete ticket;
+	clearRenderQueue();
+	for (uint i = 0; i < _freeTickets.size(); i++) {
+		delete _freeTickets[i];
 	}
 
-	delete _dirtyRect;
-
 	_renderSurface->free();
 	delete _renderSurface;
 	_blankSurface->free();
@@ -154,8 +149,7 @@ bool BaseRenderOSystem::indicatorFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		clearDirtyRects();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -177,8 +171,8 @@ bool BaseRenderOSystem::flip() {
 		while (it != _renderQueue.end()) {
 			if ((*it)->_wantsDraw == false) {
 				RenderTicket *ticket = *it;
-				it = _renderQueue.erase(it);
-				delete ticket;
+				it = unqueueTicket(it);
+				releaseTicket(ticket);
 			} else {
 				(*it)->_wantsDraw = false;
 				++it;
@@ -194,9 +188,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		//  g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		clearDirtyRects();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -271,9 +263,8 @@ Graphics::PixelFormat BaseRenderOSystem::getPixelFormat() const {
 void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform) {
 
 	if (_disableDirtyRects) {
-		RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
-		ticket->_wantsDraw = true;
-		_renderQueue.push_back(ticket);
+		RenderTicket *ticket = acquireTicket(owner, surf, srcRect, dstRect, transform);
+		queueTicket(_renderQueue.end(), ticket);
 		drawFromSurface(ticket);
 		return;
 	}
@@ -285,34 +276,110 @@ void BaseRenderOSystem::drawSurface(BaseSurfaceOSystem *owner, const Graphics::S
 
 	if (owner) { // Fade-tickets are owner-less
 		RenderTicket compare(owner, nullptr, srcRect, dstRect, transform);
+		// Usually the draw calls come in the same order as last frame
 		RenderQueueIterator it = _lastFrameIter;
 		++it;
-		// Avoid calling end() and operator* every time, when potentially going through
-		// LOTS of tickets.
-		RenderQueueIterator endIterator = _renderQueue.end();
-		RenderTicket *compareTicket = nullptr;
-		for (; it != endIterator; ++it) {
-			compareTicket = *it;
-			if (*(compareTicket) == compare && compareTicket->_isValid) {
-				if (_disableDirtyRects) {
-					drawFromSurface(compareTicket);
-				} else {
-					drawFromQueuedTicket(it);
-				}
-				return;
-			}
+		if (it == _renderQueue.end() || !(**it == compare && (*it)->_isValid)) {
+			it = findQueuedTicket(compare);
+		}
+		if (it != _renderQueue.end()) {
+			drawFromQueuedTicket(it);
+			return;
 		}
 	}
-	RenderTicket *ticket = new RenderTicket(owner, surf, srcRect, dstRect, transform);
-	if (!_disableDirtyRects) {
-		drawFromTicket(ticket);
+	drawFromTicket(acquireTicket(owner, surf, srcRect, dstRect, transform));
+}
+
+BaseRenderOSystem::RenderQueueIterator BaseRenderOSystem::findQueuedTicket(const RenderTicket &compare) {
+	TicketIndex::const_iterator i = _ticketsByOwner.find(compare._owner);
+	if (i == _ticketsByOwner.end()) {
+		return _renderQueue.end();
+	}
+
+	// Tickets that were drawn this frame already are in front of
+	// _lastFrameIter, and can't be reused a second time.
+	const Common::Array<RenderQueueIterator> &tickets = i->_value;
+	for (uint j = 0; j < tickets.size(); j++) {
+		const RenderTicket *ticket = *tickets[j];
+		if (!ticket->_wantsDraw && ticket->_isValid && *ticket == compare) {
+			return tickets[j];
+		}
+	}
+	return _renderQueue.end();
+}
+
+BaseRenderOSystem::RenderQueueIterator BaseRenderOSystem::queueTicket(RenderQueueIterator pos, RenderTicket *ticket) {
+	_renderQueue.insert(pos, ticket);
+	--pos;
+
+	if (ticket->_owner) {
+		Common::Array<RenderQueueIterator> &tickets = _ticketsByOwner[ticket->_owner];
+		ticket->_ownerSlot = tickets.size();
+		tickets.push_back(pos);
+	}
+	return pos;
+}
+
+BaseRenderOSystem::RenderQueueIterator BaseRenderOSystem::unqueueTicket(RenderQueueIterator it) {
+	RenderTicket *ticket = *it;
+
+	if (ticket->_owner) {
+		TicketIndex::iterator i = _ticketsByOwner.find(ticket->_owner);
+		assert(i != _ticketsByOwner.end());
+		Common::Array<RenderQueueIterator> &tickets = i->_value;
+		uint slot = ticket->_ownerSlot;
+		assert(slot < tickets.size() && tickets[slot] == it);
+
+		tickets[slot] = tickets.back();
+		(*tickets[slot])->_ownerSlot = slot;
+		tickets.pop_back();
+		if (tickets.empty()) {
+			_ticketsByOwner.erase(i);
+		}
+	}
+	return _renderQueue.erase(it);
+}
+
+RenderTicket *BaseRenderOSystem::acquireTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform) {
+	if (_freeTickets.empty()) {
+		return new RenderTicket(owner, surf, srcRect, dstRect, transform);
+	}
+
+	// Prefer a ticket whose copy of the surface can be reused as is
+	uint pick = _freeTickets.size() - 1;
+	for (uint i = 0; i < _freeTickets.size(); i++) {
+		const Graphics::Surface *copy = _freeTickets[i]->getSurface();
+		if (copy && copy->w == srcRect->width() && copy->h == srcRect->height()) {
+			pick = i;
+			break;
+		}
+	}
+
+	RenderTicket *ticket = _freeTickets[pick];
+	_freeTickets[pick] = _freeTickets.back();
+	_freeTickets.pop_back();
+	ticket->set(owner, surf, srcRect, dstRect, transform);
+	return ticket;
+}
+
+void BaseRenderOSystem::releaseTicket(RenderTicket *ticket) {
+	if (_freeTickets.size() < kMaxFreeTickets) {
+		_freeTickets.push_back(ticket);
 	} else {
-		ticket->_wantsDraw = true;
-		_renderQueue.push_back(ticket);
-		drawFromSurface(ticket);
+		delete ticket;
 	}
 }
 
+void BaseRenderOSystem::clearRenderQueue() {
+	RenderQueueIterator it = _renderQueue.begin();
+	while (it != _renderQueue.end()) {
+		RenderTicket *ticket = *it;
+		it = unqueueTicket(it);
+		releaseTicket(ticket);
+	}
+	_lastFrameIter = _renderQueue.end();
+}
+
 void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
 	addDirtyRect(renderTicket->_dstRect);
 	renderTicket->_isValid = false;
@@ -320,11 +387,14 @@ void BaseRenderOSystem::invalidateTicket(RenderTicket *renderTicket) {
 }
 
 void BaseRenderOSystem::invalidateTicketsFromSurface(BaseSurfaceOSystem *surf) {
-	RenderQueueIterator it;
-	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
-		if ((*it)->_owner == surf) {
-			invalidateTicket(*it);
-		}
+	TicketIndex::const_iterator i = _ticketsByOwner.find(surf);
+	if (i == _ticketsByOwner.end()) {
+		return;
+	}
+
+	const Common::Array<RenderQueueIterator> &tickets = i->_value;
+	for (uint j = 0; j < tickets.size(); j++) {
+		invalidateTicket(*tickets[j]);
 	}
 }
 
@@ -334,15 +404,11 @@ void BaseRenderOSystem::drawFromTicket(RenderTicket *renderTicket) {
 	++_lastFrameIter;
 	// In-order
 	if (_renderQueue.empty() || _lastFrameIter == _renderQueue.end()) {
-		_lastFrameIter--;
-		_renderQueue.push_back(renderTicket);
-		++_lastFrameIter;
+		_lastFrameIter = queueTicket(_renderQueue.end(), renderTicket);
 		addDirtyRect(renderTicket->_dstRect);
 	} else {
 		// Before something
-		RenderQueueIterator pos = _lastFrameIter;
-		_renderQueue.insert(pos, renderTicket);
-		--_lastFrameIter;
+		_lastFrameIter = queueTicket(_lastFrameIter, renderTicket);
 		addDirtyRect(renderTicket->_dstRect);
 	}
 }
@@ -358,19 +424,80 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 		--_lastFrameIter;
 		// Remove the ticket from the list
 		assert(*_lastFrameIter != renderTicket);
-		_renderQueue.erase(ticket);
+		unqueueTicket(ticket);
 		// Is not in order, so readd it as if it was a new ticket
 		drawFromTicket(renderTicket);
 	}
 }
 
+/**
+ * Number of pixels in the bounding box of two rects which are in neither of
+ * them, i.e. the extra work caused by redrawing them as one rect.
+ */
+static int dirtyRectMergeCost(const Common::Rect &a, const Common::Rect &b, Common::Rect &merged) {
+	merged = a;
+	merged.extend(b);
+
+	Common::Rect common(a);
+	common.clip(b);
+	int commonArea = common.isEmpty() ? 0 : common.width() * common.height();
+
+	return merged.width() * merged.height() - a.width() * a.height() - b.width() * b.height() + commonArea;
+}
+
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
+	Common::Rect dirty(rect);
+	dirty.clip(_renderRect);
+	if (dirty.isEmpty()) {
+		return;
+	}
+
+	// The rects must stay disjoint, as tickets are alpha-blended once per
+	// rect they intersect. So anything overlapping is always merged, and
+	// since merging grows the rect, we repeat until nothing overlaps.
+	for (;;) {
+		Common::Rect merged, bestMerged;
+		int best = -1;
+		int bestCost = 0;
+
+		for (uint i = 0; i < _dirtyRects.size(); i++) {
+			const Common::Rect &r = _dirtyRects[i];
+			int cost = dirtyRectMergeCost(r, dirty, merged);
+
+			if (r.intersects(dirty) || cost * 2 <= MIN(r.width() * r.height(), dirty.width() * dirty.height())) {
+				best = i;
+				bestMerged = merged;
+				break;
+			}
+
+			if (_dirtyRects.size() >= kMaxDirtyRects && (best == -1 || cost < bestCost)) {
+				best = i;
+				bestCost = cost;
+				bestMerged = merged;
+			}
+		}
+
+		if (best == -1) {
+			break;
+		}
+
+		_dirtyRects[best] = _dirtyRects.back();
+		_dirtyRects.pop_back();
+		dirty = bestMerged;
+	}
+
+	if (_dirtyRects.empty()) {
+		_dirtyBounds = dirty;
 	} else {
-		_dirtyRect->extend(rect);
+		_dirtyBounds.extend(dirty);
 	}
-	_dirtyRect->clip(_renderRect);
+	_dirtyRects.push_back(dirty);
+}
+
+void BaseRenderOSystem::clearDirtyRects() {
+	// clear() would free the storage, which is reused every frame
+	_dirtyRects.resize(0);
+	_dirtyBounds = Common::Rect();
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -382,14 +509,14 @@ void BaseRenderOSystem::drawTickets() {
 	while (it != _renderQueue.end()) {
 		if ((*it)->_wantsDraw == false) {
 			RenderTicket *ticket = *it;
-			addDirtyRect((*it)->_dstRect);
-			it = _renderQueue.erase(it);
-			delete ticket;
+			addDirtyRect(ticket->_dstRect);
+			it = unqueueTicket(it);
+			releaseTicket(ticket);
 		} else {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRects.empty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -402,49 +529,57 @@ void BaseRenderOSystem::drawTickets() {
 	it = _renderQueue.begin();
 	_lastFrameIter = _renderQueue.end();
 	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
-	// the background color. Typical use-case: Fullscreen FMVs.
+	// the background color for the dirty rects it covers. Typical use-case: Fullscreen FMVs.
 	// Caveat: The FPS-counter will invalidate this.
+	const RenderTicket *opaqueTicket = nullptr;
 	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
-		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
+		opaqueTicket = *it;
+	}
+	for (uint i = 0; i < _dirtyRects.size(); i++) {
+		if (!opaqueTicket || !opaqueTicket->_dstRect.contains(_dirtyRects[i])) {
 			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
+			_renderSurface->fillRect(_dirtyRects[i], _clearColor);
 		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
 	}
 	for (; it != _renderQueue.end(); ++it) {
 		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
+		if (ticket->_dstRect.intersects(_dirtyBounds)) {
+			for (uint i = 0; i < _dirtyRects.size(); i++) {
+				const Common::Rect &dirty = _dirtyRects[i];
+				if (!ticket->_dstRect.intersects(dirty)) {
+					continue;
+				}
+				// dstClip is the area we want redrawn.
+				Common::Rect dstClip(ticket->_dstRect);
+				// reduce it to the dirty rect
+				dstClip.clip(dirty);
+				// we need to keep track of the position to redraw the dirty rect
+				Common::Rect pos(dstClip);
+				int16 offsetX = ticket->_dstRect.left;
+				int16 offsetY = ticket->_dstRect.top;
+				// convert from screen-coords to surface-coords.
+				dstClip.translate(-offsetX, -offsetY);
+
+				drawFromSurface(ticket, &pos, &dstClip);
+				_needsFlip = true;
+			}
 		}
 		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
 		ticket->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
+	for (uint i = 0; i < _dirtyRects.size(); i++) {
+		const Common::Rect &dirty = _dirtyRects[i];
+		g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(dirty.left, dirty.top), _renderSurface->pitch, dirty.left, dirty.top, dirty.width(), dirty.height());
+	}
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
 	while (it != _renderQueue.end()) {
 		if ((*it)->_isValid == false) {
 			RenderTicket *ticket = *it;
-			addDirtyRect((*it)->_dstRect);
-			it = _renderQueue.erase(it);
-			delete ticket;
+			addDirtyRect(ticket->_dstRect);
+			it = unqueueTicket(it);
+			releaseTicket(ticket);
 		} else {
 			++it;
 		}
@@ -565,12 +700,7 @@ void BaseRenderOSystem::endSaveLoad() {
 	BaseRenderer::endSaveLoad();
 
 	// Clear the scale-buffered tickets as we just loaded.
-	RenderQueueIterator it = _renderQueue.begin();
-	while (it != _renderQueue.end()) {
-		RenderTicket *ticket = *it;
-		it = _renderQueue.erase(it);
-		delete ticket;
-	}
+	clearRenderQueue();
 	// HACK: After a save the buffer will be drawn before the scripts get to update it,
 	// so just skip this single frame.
 	_skipThisFrame = true;
@@ -33,11 +33,27 @@
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "common/list.h"
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/func.h"
 #include "graphics/transform_struct.h"
 
 namespace Wintermute {
 class BaseSurfaceOSystem;
 class RenderTicket;
+}
+
+namespace Common {
+template<typename T> struct Hash;
+template<> struct Hash<Wintermute::BaseSurfaceOSystem *> : public UnaryFunction<Wintermute::BaseSurfaceOSystem *, uint> {
+	uint operator()(Wintermute::BaseSurfaceOSystem *val) const {
+		return (uint)((size_t)val);
+	}
+};
+
+}
+
+namespace Wintermute {
 /**
  * A 2D-renderer implementation for WME.
  * This renderer makes use of a "ticket"-system, where all draw-calls
@@ -115,9 +131,16 @@ public:
 private:
 	/**
 	 * Mark a specified rect of the screen as dirty.
+	 * The dirty region is kept as a set of disjoint rects, overlapping
+	 * rects are merged, as are rects which are close enough that drawing
+	 * their bounding box is cheaper than drawing them separately.
 	 * @param rect the region to be marked as dirty
 	 */
 	void addDirtyRect(const Common::Rect &rect);
+	/**
+	 * Forget all dirty rects, after they have been drawn.
+	 */
+	void clearDirtyRects();
 	/**
 	 * Traverse the tickets that are dirty, and draw them
 	 */
@@ -126,8 +149,50 @@ private:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	/**
+	 * Find a ticket from last frame which is identical to compare and
+	 * hasn't been drawn yet this frame, using the owner index.
+	 * @return the position of the ticket, or _renderQueue.end()
+	 */
+	RenderQueueIterator findQueuedTicket(const RenderTicket &compare);
+	/**
+	 * Insert a ticket into the queue, and into the owner index.
+	 * @return the position of the inserted ticket
+	 */
+	RenderQueueIterator queueTicket(RenderQueueIterator pos, RenderTicket *ticket);
+	/**
+	 * Remove a ticket from the queue and from the owner index, without
+	 * releasing it.
+	 * @return the position following the removed ticket
+	 */
+	RenderQueueIterator unqueueTicket(RenderQueueIterator it);
+	/**
+	 * Get a ticket for a new draw call, reusing a released one (and its
+	 * surface buffer, if the size matches) when available.
+	 */
+	RenderTicket *acquireTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct &transform);
+	/**
+	 * Hand back a ticket that is no longer queued, keeping a few around
+	 * for acquireTicket().
+	 */
+	void releaseTicket(RenderTicket *ticket);
+	/** Remove and release every queued ticket */
+	void clearRenderQueue();
+	enum {
+		/** Beyond this many dirty rects the incoming rect is merged with its cheapest partner */
+		kMaxDirtyRects = 32,
+		/** Number of released tickets kept around for reuse */
+		kMaxFreeTickets = 16
+	};
+	Common::Array<Common::Rect> _dirtyRects;
+	/** Bounding box of _dirtyRects, to quickly skip tickets */
+	Common::Rect _dirtyBounds;
 	Common::List<RenderTicket *> _renderQueue;
+	typedef Common::HashMap<BaseSurfaceOSystem *, Common::Array<RenderQueueIterator> > TicketIndex;
+	/** Queued tickets by owner, for out-of-order reuse and invalidation */
+	TicketIndex _ticketsByOwner;
+	/** Released tickets, see acquireTicket() */
+	Common::Array<RenderTicket *> _freeTickets;
 
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
@@ -35,15 +35,26 @@
 namespace Wintermute {
 
 RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct transform) :
-	_owner(owner),
-	_srcRect(*srcRect),
-	_dstRect(*dstRect),
-	_isValid(true),
-	_wantsDraw(true),
-	_transform(transform) {
+	_surface(nullptr) {
+	set(owner, surf, srcRect, dstRect, transform);
+}
+
+void RenderTicket::set(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct transform) {
+	_owner = owner;
+	_srcRect = *srcRect;
+	_dstRect = *dstRect;
+	_isValid = true;
+	_wantsDraw = true;
+	_transform = transform;
+
 	if (surf) {
-		_surface = new Graphics::Surface();
-		_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
+		if (!_surface) {
+			_surface = new Graphics::Surface();
+		}
+		if (_surface->w != srcRect->width() || _surface->h != srcRect->height() || _surface->format != surf->format) {
+			_surface->free();
+			_surface->create((uint16)srcRect->width(), (uint16)srcRect->height(), surf->format);
+		}
 		assert(_surface->format.bytesPerPixel == 4);
 		// Get a clipped copy of the surface
 		for (int i = 0; i < _surface->h; i++) {
@@ -72,7 +83,9 @@ RenderTicket::RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *s
 			delete _surface;
 			_surface = temp;
 		}
-	} else {
+	} else if (_surface) {
+		_surface->free();
+		delete _surface;
 		_surface = nullptr;
 	}
 }
@@ -52,8 +52,14 @@ class BaseSurfaceOSystem;
 class RenderTicket {
 public:
 	RenderTicket(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRest, Graphics::TransformStruct transform);
-	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()) {}
+	RenderTicket() : _isValid(true), _wantsDraw(false), _transform(Graphics::TransformStruct()), _owner(nullptr), _surface(nullptr) {}
 	~RenderTicket();
+	/**
+	 * Turn this into a ticket for another draw call, as if it had just
+	 * been constructed with these arguments. The surface copy is reused
+	 * if it has the right size.
+	 */
+	void set(BaseSurfaceOSystem *owner, const Graphics::Surface *surf, Common::Rect *srcRect, Common::Rect *dstRect, Graphics::TransformStruct transform);
 	const Graphics::Surface *getSurface() const { return _surface; }
 	// Non-dirty-rects:
 	void drawToSurface(Graphics::Surface *_targetSurface) const;
@@ -68,6 +74,8 @@ public:
 	Graphics::TransformStruct _transform;
 
 	BaseSurfaceOSystem *_owner;
+	/** Position in the renderer's per-owner index, maintained by the renderer */
+	uint _ownerSlot;
 	bool operator==(const RenderTicket &a) const;
 	const Common::Rect *getSrcRect() const { return &_srcRect; }
 private:
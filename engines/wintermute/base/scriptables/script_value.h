@@ -33,6 +33,7 @@
 #include "engines/wintermute/base/base.h"
 #include "engines/wintermute/persistent.h"
 #include "engines/wintermute/base/scriptables/dcscript.h"   // Added by ClassView
+#include "common/flat-hashmap.h"
 #include "common/str.h"
 
 namespace Wintermute {
@@ -98,8 +99,9 @@ public:
 	ScValue(BaseGame *inGame, double Val);
 	ScValue(BaseGame *inGame, const char *Val);
 	virtual ~ScValue();
-	Common::HashMap<Common::String, ScValue *> _valObject;
-	Common::HashMap<Common::String, ScValue *>::iterator _valIter;
+	// Script object properties are looked up on every member access
+	Common::FlatHashMap<Common::String, ScValue *> _valObject;
+	Common::FlatHashMap<Common::String, ScValue *>::iterator _valIter;
 
 	bool setProperty(const char *propName, int32 value);
 	bool setProperty(const char *propName, const char *value);
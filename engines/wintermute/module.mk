@@ -26,6 +26,7 @@ MODULE_OBJS := \
 	ad/ad_talk_def.o \
 	ad/ad_talk_holder.o \
 	ad/ad_talk_node.o \
+	ad/ad_walk_graph.o \
 	ad/ad_waypoint_group.o \
 	base/scriptables/debuggable/debuggable_script.o \
 	base/scriptables/debuggable/debuggable_script_engine.o \
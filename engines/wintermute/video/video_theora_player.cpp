@@ -42,6 +42,11 @@ namespace Wintermute {
 
 IMPLEMENT_PERSISTENT(VideoTheoraPlayer, false)
 
+enum {
+	// Frames the decoder may decode during game frames with no video frame due
+	kDecodeAheadFrames = 4
+};
+
 //////////////////////////////////////////////////////////////////////////
 VideoTheoraPlayer::VideoTheoraPlayer(BaseGame *inGame) : BaseClass(inGame) {
 	SetDefaults();
@@ -139,6 +144,8 @@ bool VideoTheoraPlayer::initialize(const Common::String &filename, const Common:
 		return STATUS_FAILED;
 	}
 
+	_theoraDecoder->setDecodeAhead(kDecodeAheadFrames);
+
 	_state = THEORA_STATE_PAUSED;
 
 	// Additional setup.
@@ -178,6 +185,8 @@ bool VideoTheoraPlayer::resetStream() {
 		return STATUS_FAILED;
 	}
 
+	_theoraDecoder->setDecodeAhead(kDecodeAheadFrames);
+
 	return play(_playbackType, _posX, _posY, false, false, _looping, 0, _playZoom);
 	// End of hack.
 #if 0 // Stubbed for now, as theora isn't seekable
@@ -329,6 +338,8 @@ bool VideoTheoraPlayer::update() {
 						writeVideo();
 					}
 				}
+			} else {
+				_theoraDecoder->decodeAhead();
 			}
 			return STATUS_OK;
 		}
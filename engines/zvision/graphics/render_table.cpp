@@ -30,10 +30,18 @@ namespace ZVision {
 RenderTable::RenderTable(uint numColumns, uint numRows)
 	: _numRows(numRows),
 	  _numColumns(numColumns),
-	  _renderState(FLAT) {
+	  _renderState(FLAT),
+	  _bilinearFiltering(false) {
 	assert(numRows != 0 && numColumns != 0);
 
 	_internalBuffer = new Common::Point[numRows * numColumns];
+	_warpTable = new WarpEntry[numRows * numColumns];
+
+	// Start out without any warping
+	for (uint y = 0; y < _numRows; ++y) {
+		for (uint x = 0; x < _numColumns; ++x)
+			setWarp(x, y, x, y);
+	}
 
 	memset(&_panoramaOptions, 0, sizeof(_panoramaOptions));
 	memset(&_tiltOptions, 0, sizeof(_tiltOptions));
@@ -41,6 +49,7 @@ RenderTable::RenderTable(uint numColumns, uint numRows)
 
 RenderTable::~RenderTable() {
 	delete[] _internalBuffer;
+	delete[] _warpTable;
 }
 
 void RenderTable::setRenderState(RenderState newState) {
@@ -82,48 +91,91 @@ const Common::Point RenderTable::convertWarpedCoordToFlatCoord(const Common::Poi
 }
 
 void RenderTable::mutateImage(uint16 *sourceBuffer, uint16 *destBuffer, uint32 destWidth, const Common::Rect &subRect) {
-	uint32 destOffset = 0;
-
 	for (int16 y = subRect.top; y < subRect.bottom; ++y) {
-		uint32 sourceOffset = y * _numColumns;
+		mutateRow(destBuffer, sourceBuffer, _warpTable + y * _numColumns + subRect.left, subRect.width());
+		destBuffer += destWidth;
+	}
+}
 
-		for (int16 x = subRect.left; x < subRect.right; ++x) {
-			uint32 normalizedX = x - subRect.left;
-			uint32 index = sourceOffset + x;
+void RenderTable::mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf) {
+	const uint16 *sourceBuffer = (const uint16 *)srcBuf->getPixels();
+	uint16 *destBuffer = (uint16 *)dstBuf->getPixels();
 
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
+	// Bilinear filtering works on all three channels at once, spread out
+	// over a 32 bit word so that there is room for the products in between.
+	// That needs 5 or 6 bit channels in the usual 16 bit layout.
+	uint32 channelMask = 0;
+	const Graphics::PixelFormat &format = srcBuf->format;
+	if (_bilinearFiltering && format.bytesPerPixel == 2 && format.aLoss == 8 && format.rLoss == 3 && format.bLoss == 3 &&
+			format.gLoss >= 2 && format.bShift == 0 && format.gShift == 5 && format.rShift == 5 + 8 - format.gLoss) {
+		channelMask = ((uint32)((0xFF >> format.gLoss) << format.gShift) << 16) |
+			((0xFF >> format.rLoss) << format.rShift) | (0xFF >> format.bLoss);
+	}
 
-			destBuffer[destOffset + normalizedX] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
-		}
+	for (int16 y = 0; y < srcBuf->h; ++y) {
+		const WarpEntry *warp = _warpTable + y * _numColumns;
+
+		if (channelMask)
+			mutateRowFiltered(destBuffer, sourceBuffer, warp, srcBuf->w, channelMask);
+		else
+			mutateRow(destBuffer, sourceBuffer, warp, srcBuf->w);
 
-		destOffset += destWidth;
+		destBuffer += dstBuf->pitch / 2;
 	}
 }
 
-void RenderTable::mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf) {
-	uint32 destOffset = 0;
-
-	uint16 *sourceBuffer = (uint16 *)srcBuf->getPixels();
-	uint16 *destBuffer = (uint16 *)dstBuf->getPixels();
+void RenderTable::mutateRow(uint16 *dest, const uint16 *source, const WarpEntry *warp, uint width) {
+	for (uint x = 0; x < width; ++x)
+		dest[x] = source[warp[x].sourceIndex];
+}
 
-	for (int16 y = 0; y < srcBuf->h; ++y) {
-		uint32 sourceOffset = y * _numColumns;
+/** The channels of a pixel, spread out over a 32 bit word */
+static inline uint32 spreadChannels(uint16 color, uint32 channelMask) {
+	return (color | ((uint32)color << 16)) & channelMask;
+}
 
-		for (int16 x = 0; x < srcBuf->w; ++x) {
-			uint32 index = sourceOffset + x;
+/** Interpolate between two spread out pixels, fraction is in 1/32nd */
+static inline uint32 lerpChannels(uint32 a, uint32 b, uint fraction, uint32 channelMask) {
+	return ((a * (32 - fraction) + b * fraction) >> 5) & channelMask;
+}
 
-			// RenderTable only stores offsets from the original coordinates
-			uint32 sourceYIndex = y + _internalBuffer[index].y;
-			uint32 sourceXIndex = x + _internalBuffer[index].x;
+void RenderTable::mutateRowFiltered(uint16 *dest, const uint16 *source, const WarpEntry *warp, uint width, uint32 channelMask) {
+	for (uint x = 0; x < width; ++x) {
+		const WarpEntry &entry = warp[x];
+		const uint16 *pixel = source + entry.sourceIndex;
 
-			destBuffer[destOffset] = sourceBuffer[sourceYIndex * _numColumns + sourceXIndex];
-			destOffset++;
+		if (!(entry.fractionX | entry.fractionY)) {
+			dest[x] = *pixel;
+			continue;
 		}
+
+		// The fractions are only set where the neighbor pixels exist
+		const uint stepX = entry.fractionX ? 1 : 0;
+		const uint stepY = entry.fractionY ? _numColumns : 0;
+
+		const uint32 top = lerpChannels(spreadChannels(pixel[0], channelMask), spreadChannels(pixel[stepX], channelMask), entry.fractionX, channelMask);
+		const uint32 bottom = lerpChannels(spreadChannels(pixel[stepY], channelMask), spreadChannels(pixel[stepY + stepX], channelMask), entry.fractionX, channelMask);
+		const uint32 color = lerpChannels(top, bottom, entry.fractionY, channelMask);
+
+		dest[x] = (uint16)(color | (color >> 16));
 	}
 }
 
+void RenderTable::setWarp(uint x, uint y, float sourceX, float sourceY) {
+	const int32 flatX = int32(floor(sourceX));
+	const int32 flatY = int32(floor(sourceY));
+	const uint32 index = y * _numColumns + x;
+
+	// Only store the (x,y) offsets instead of the absolute positions
+	_internalBuffer[index].x = flatX - x;
+	_internalBuffer[index].y = flatY - y;
+
+	WarpEntry &entry = _warpTable[index];
+	entry.sourceIndex = flatY * _numColumns + flatX;
+	entry.fractionX = (flatX + 1 < (int32)_numColumns) ? MIN<int>(int((sourceX - flatX) * 32), 31) : 0;
+	entry.fractionY = (flatY + 1 < (int32)_numRows) ? MIN<int>(int((sourceY - flatY) * 32), 31) : 0;
+}
+
 void RenderTable::generateRenderTable() {
 	switch (_renderState) {
 	case ZVision::RenderTable::PANORAMA:
@@ -139,8 +191,6 @@ void RenderTable::generateRenderTable() {
 }
 
 void RenderTable::generatePanoramaLookupTable() {
-	memset(_internalBuffer, 0, _numRows * _numColumns * sizeof(uint16));
-
 	float halfWidth = (float)_numColumns / 2.0f;
 	float halfHeight = (float)_numRows / 2.0f;
 
@@ -154,20 +204,16 @@ void RenderTable::generatePanoramaLookupTable() {
 
 		// To get x in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _panoramaOptions.linearScale
-		int32 xInCylinderCoords = int32(floor((cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth));
+		float xInCylinderCoords = (cylinderRadius * _panoramaOptions.linearScale * alpha) + halfWidth;
 
 		float cosAlpha = cos(alpha);
 
 		for (uint y = 0; y < _numRows; ++y) {
 			// To calculate y in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 yInCylinderCoords = int32(floor(halfHeight + ((float)y - halfHeight) * cosAlpha));
-
-			uint32 index = y * _numColumns + x;
+			float yInCylinderCoords = halfHeight + ((float)y - halfHeight) * cosAlpha;
 
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setWarp(x, y, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
@@ -188,21 +234,16 @@ void RenderTable::generateTiltLookupTable() {
 
 		// To get y in cylinder coordinates, we just need to calculate the arc length
 		// We also scale it by _tiltOptions.linearScale
-		int32 yInCylinderCoords = int32(floor((cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight));
+		float yInCylinderCoords = (cylinderRadius * _tiltOptions.linearScale * alpha) + halfHeight;
 
 		float cosAlpha = cos(alpha);
-		uint32 columnIndex = y * _numColumns;
 
 		for (uint x = 0; x < _numColumns; ++x) {
 			// To calculate x in cylinder coordinates, we can do similar triangles comparison,
 			// comparing the triangle from the center to the screen and from the center to the edge of the cylinder
-			int32 xInCylinderCoords = int32(floor(halfWidth + ((float)x - halfWidth) * cosAlpha));
-
-			uint32 index = columnIndex + x;
+			float xInCylinderCoords = halfWidth + ((float)x - halfWidth) * cosAlpha;
 
-			// Only store the (x,y) offsets instead of the absolute positions
-			_internalBuffer[index].x = xInCylinderCoords - x;
-			_internalBuffer[index].y = yInCylinderCoords - y;
+			setWarp(x, y, xInCylinderCoords, yInCylinderCoords);
 		}
 	}
 }
@@ -45,6 +45,20 @@ private:
 	Common::Point *_internalBuffer;
 	RenderState _renderState;
 
+	/**
+	 * The warp of a destination pixel: the index of its source pixel, and
+	 * the subpixel position within it in 1/32nd of a pixel, which is used
+	 * by the bilinear filtering.
+	 */
+	struct WarpEntry {
+		uint32 sourceIndex;
+		byte fractionX;
+		byte fractionY;
+	};
+
+	WarpEntry *_warpTable;
+	bool _bilinearFiltering;
+
 	struct {
 		float fieldOfView;
 		float linearScale;
@@ -72,6 +86,13 @@ public:
 	void mutateImage(Graphics::Surface *dstBuf, Graphics::Surface *srcBuf);
 	void generateRenderTable();
 
+	/**
+	 * Enable bilinear filtering of warped images. It is only supported for
+	 * RGB555 and RGB565 surfaces, others are always drawn unfiltered.
+	 */
+	void setBilinearFiltering(bool enable) { _bilinearFiltering = enable; }
+	bool getBilinearFiltering() const { return _bilinearFiltering; }
+
 	void setPanoramaFoV(float fov);
 	void setPanoramaScale(float scale);
 	void setPanoramaReverse(bool reverse);
@@ -90,6 +111,10 @@ public:
 private:
 	void generatePanoramaLookupTable();
 	void generateTiltLookupTable();
+	void setWarp(uint x, uint y, float sourceX, float sourceY);
+
+	void mutateRow(uint16 *dest, const uint16 *source, const WarpEntry *warp, uint width);
+	void mutateRowFiltered(uint16 *dest, const uint16 *source, const WarpEntry *warp, uint width, uint32 channelMask);
 };
 
 } // End of namespace ZVision
@@ -83,9 +83,18 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/util.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
+#if defined(__SSE2__)
+#define USE_SSE2_YUV
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define USE_NEON_YUV
+#include <arm_neon.h>
+#endif
+
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
 }
@@ -159,6 +168,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 
 YUVToRGBManager::YUVToRGBManager() {
 	_lookup = 0;
+	_useSIMD = hasSIMD();
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -183,6 +193,18 @@ YUVToRGBManager::~YUVToRGBManager() {
 	delete _lookup;
 }
 
+bool YUVToRGBManager::hasSIMD() const {
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void YUVToRGBManager::setUseSIMD(bool enable) {
+	_useSIMD = enable && hasSIMD();
+}
+
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
 	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
 		return _lookup;
@@ -192,6 +214,396 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+
+// The vector code computes the chroma contributions instead of reading
+// them from the color tables. The tables hold the products of the chroma
+// values and the factors below, rounded towards zero. These 16.16 fixed
+// point fractions give the same results for all 256 chroma values, so the
+// output is identical to the table based code.
+static const uint16 kCrRFrac = 26302; // 0.419 / 0.299, minus 1
+static const uint16 kCrGFrac = 46767; // 0.299 / 0.419
+static const uint16 kCbGFrac = 22571; // 0.114 / 0.331
+static const uint16 kCbBFrac = 50686; // 0.587 / 0.331, minus 1
+
+// floor(x * 255 / 219) == x + ((x * kITUScale) >> 16) for all x in [0, 219]
+static const uint16 kITUScale = 10776;
+
+#if defined(USE_SSE2_YUV)
+
+/**
+ * SSE2 building blocks for the vector conversions, operating on eight
+ * 16 bit lanes.
+ */
+template<typename PixelInt>
+class YUVToRGBVector {
+public:
+	typedef __m128i Vec;
+
+	YUVToRGBVector(const YUVToRGBLookup *lookup) {
+		const Graphics::PixelFormat format = lookup->getFormat();
+		_itu = lookup->getScale() == YUVToRGBManager::kScaleITU;
+		_zero = _mm_setzero_si128();
+		_lo = _mm_set1_epi16(_itu ? 16 : 0);
+		_hi = _mm_set1_epi16(_itu ? 235 : 255);
+		_rLoss = _mm_cvtsi32_si128(format.rLoss);
+		_gLoss = _mm_cvtsi32_si128(format.gLoss);
+		_bLoss = _mm_cvtsi32_si128(format.bLoss);
+		_rShift = _mm_cvtsi32_si128(format.rShift);
+		_gShift = _mm_cvtsi32_si128(format.gShift);
+		_bShift = _mm_cvtsi32_si128(format.bShift);
+		if (sizeof(PixelInt) == 2)
+			_alpha = _mm_set1_epi16((int16)format.RGBToColor(0, 0, 0));
+		else
+			_alpha = _mm_set1_epi32((int32)format.RGBToColor(0, 0, 0));
+	}
+
+	/** Load eight bytes into the lanes. */
+	Vec load(const byte *src) const {
+		return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _zero);
+	}
+
+	/** Repeat lanes 0-3 (or 4-7) twice each. */
+	static Vec repeatLow(Vec x) { return _mm_unpacklo_epi16(x, x); }
+	static Vec repeatHigh(Vec x) { return _mm_unpackhi_epi16(x, x); }
+
+	/** Fill lanes 0-3 with a, and lanes 4-7 with b. */
+	static Vec quads(int a, int b) { return _mm_set_epi16(b, b, b, b, a, a, a, a); }
+
+	/** Lanes 0-7 set to 0, 1, 2, 3, 0, 1, 2, 3. */
+	static Vec quadPositions() { return _mm_set_epi16(3, 2, 1, 0, 3, 2, 1, 0); }
+
+	static Vec set(int value) { return _mm_set1_epi16(value); }
+	static Vec add(Vec a, Vec b) { return _mm_add_epi16(a, b); }
+	static Vec sub(Vec a, Vec b) { return _mm_sub_epi16(a, b); }
+	static Vec mul(Vec a, Vec b) { return _mm_mullo_epi16(a, b); }
+	static Vec shiftRight4(Vec a) { return _mm_srli_epi16(a, 4); }
+
+	/** Compute the chroma contributions to the three channels. */
+	void chroma(Vec u, Vec v, Vec &r, Vec &g, Vec &b) const {
+		const Vec cr = _mm_sub_epi16(v, _mm_set1_epi16(128));
+		const Vec cb = _mm_sub_epi16(u, _mm_set1_epi16(128));
+		const Vec crSign = _mm_srai_epi16(cr, 15);
+		const Vec cbSign = _mm_srai_epi16(cb, 15);
+		const Vec crAbs = _mm_sub_epi16(_mm_xor_si128(cr, crSign), crSign);
+		const Vec cbAbs = _mm_sub_epi16(_mm_xor_si128(cb, cbSign), cbSign);
+
+		// Scale the magnitudes, then restore the signs
+		r = _mm_add_epi16(crAbs, _mm_mulhi_epu16(crAbs, _mm_set1_epi16((int16)kCrRFrac)));
+		const Vec crG = _mm_mulhi_epu16(crAbs, _mm_set1_epi16((int16)kCrGFrac));
+		const Vec cbG = _mm_mulhi_epu16(cbAbs, _mm_set1_epi16((int16)kCbGFrac));
+		b = _mm_add_epi16(cbAbs, _mm_mulhi_epu16(cbAbs, _mm_set1_epi16((int16)kCbBFrac)));
+
+		r = _mm_sub_epi16(_mm_xor_si128(r, crSign), crSign);
+		b = _mm_sub_epi16(_mm_xor_si128(b, cbSign), cbSign);
+		g = _mm_sub_epi16(_mm_sub_epi16(crSign, _mm_xor_si128(crG, crSign)),
+		                  _mm_sub_epi16(_mm_xor_si128(cbG, cbSign), cbSign));
+	}
+
+	/** Convert eight pixels and store them to dst. */
+	void store(byte *dst, Vec y, Vec r, Vec g, Vec b) const {
+		r = _mm_srl_epi16(channel(_mm_add_epi16(y, r)), _rLoss);
+		g = _mm_srl_epi16(channel(_mm_add_epi16(y, g)), _gLoss);
+		b = _mm_srl_epi16(channel(_mm_add_epi16(y, b)), _bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			Vec pixels = _mm_or_si128(_mm_sll_epi16(r, _rShift), _mm_sll_epi16(g, _gShift));
+			pixels = _mm_or_si128(pixels, _mm_sll_epi16(b, _bShift));
+			_mm_storeu_si128((__m128i *)dst, _mm_or_si128(pixels, _alpha));
+		} else {
+			Vec pixels = _mm_or_si128(_mm_sll_epi32(_mm_unpacklo_epi16(r, _zero), _rShift), _mm_sll_epi32(_mm_unpacklo_epi16(g, _zero), _gShift));
+			pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_unpacklo_epi16(b, _zero), _bShift));
+			_mm_storeu_si128((__m128i *)dst, _mm_or_si128(pixels, _alpha));
+
+			pixels = _mm_or_si128(_mm_sll_epi32(_mm_unpackhi_epi16(r, _zero), _rShift), _mm_sll_epi32(_mm_unpackhi_epi16(g, _zero), _gShift));
+			pixels = _mm_or_si128(pixels, _mm_sll_epi32(_mm_unpackhi_epi16(b, _zero), _bShift));
+			_mm_storeu_si128((__m128i *)(dst + 16), _mm_or_si128(pixels, _alpha));
+		}
+	}
+
+private:
+	/** Clamp a channel to the luminance range and scale it to [0, 255]. */
+	Vec channel(Vec c) const {
+		c = _mm_min_epi16(_mm_max_epi16(c, _lo), _hi);
+		if (_itu) {
+			c = _mm_sub_epi16(c, _lo);
+			c = _mm_add_epi16(c, _mm_mulhi_epu16(c, _mm_set1_epi16((int16)kITUScale)));
+		}
+		return c;
+	}
+
+	bool _itu;
+	Vec _zero, _lo, _hi, _alpha;
+	Vec _rLoss, _gLoss, _bLoss, _rShift, _gShift, _bShift;
+};
+
+#elif defined(USE_NEON_YUV)
+
+/**
+ * NEON building blocks for the vector conversions, operating on eight
+ * 16 bit lanes.
+ */
+template<typename PixelInt>
+class YUVToRGBVector {
+public:
+	typedef int16x8_t Vec;
+
+	YUVToRGBVector(const YUVToRGBLookup *lookup) {
+		const Graphics::PixelFormat format = lookup->getFormat();
+		_itu = lookup->getScale() == YUVToRGBManager::kScaleITU;
+		_lo = vdupq_n_s16(_itu ? 16 : 0);
+		_hi = vdupq_n_s16(_itu ? 235 : 255);
+		// NEON shifts right by shifting left by a negative amount
+		_rLoss = vdupq_n_s16(-format.rLoss);
+		_gLoss = vdupq_n_s16(-format.gLoss);
+		_bLoss = vdupq_n_s16(-format.bLoss);
+		_rShift = format.rShift;
+		_gShift = format.gShift;
+		_bShift = format.bShift;
+		_alpha = format.RGBToColor(0, 0, 0);
+	}
+
+	/** Load eight bytes into the lanes. */
+	Vec load(const byte *src) const {
+		return vreinterpretq_s16_u16(vmovl_u8(vld1_u8(src)));
+	}
+
+	/** Repeat lanes 0-3 (or 4-7) twice each. */
+	static Vec repeatLow(Vec x) {
+		const int16x4x2_t z = vzip_s16(vget_low_s16(x), vget_low_s16(x));
+		return vcombine_s16(z.val[0], z.val[1]);
+	}
+	static Vec repeatHigh(Vec x) {
+		const int16x4x2_t z = vzip_s16(vget_high_s16(x), vget_high_s16(x));
+		return vcombine_s16(z.val[0], z.val[1]);
+	}
+
+	/** Fill lanes 0-3 with a, and lanes 4-7 with b. */
+	static Vec quads(int a, int b) { return vcombine_s16(vdup_n_s16(a), vdup_n_s16(b)); }
+
+	/** Lanes 0-7 set to 0, 1, 2, 3, 0, 1, 2, 3. */
+	static Vec quadPositions() {
+		static const int16 positions[8] = { 0, 1, 2, 3, 0, 1, 2, 3 };
+		return vld1q_s16(positions);
+	}
+
+	static Vec set(int value) { return vdupq_n_s16(value); }
+	static Vec add(Vec a, Vec b) { return vaddq_s16(a, b); }
+	static Vec sub(Vec a, Vec b) { return vsubq_s16(a, b); }
+	static Vec mul(Vec a, Vec b) { return vmulq_s16(a, b); }
+	static Vec shiftRight4(Vec a) { return vreinterpretq_s16_u16(vshrq_n_u16(vreinterpretq_u16_s16(a), 4)); }
+
+	/** Compute the chroma contributions to the three channels. */
+	void chroma(Vec u, Vec v, Vec &r, Vec &g, Vec &b) const {
+		const Vec cr = vsubq_s16(v, vdupq_n_s16(128));
+		const Vec cb = vsubq_s16(u, vdupq_n_s16(128));
+		const Vec crSign = vshrq_n_s16(cr, 15);
+		const Vec cbSign = vshrq_n_s16(cb, 15);
+		const Vec crAbs = vabsq_s16(cr);
+		const Vec cbAbs = vabsq_s16(cb);
+
+		// Scale the magnitudes, then restore the signs
+		r = vaddq_s16(crAbs, mulhi(crAbs, kCrRFrac));
+		const Vec crG = mulhi(crAbs, kCrGFrac);
+		const Vec cbG = mulhi(cbAbs, kCbGFrac);
+		b = vaddq_s16(cbAbs, mulhi(cbAbs, kCbBFrac));
+
+		r = vsubq_s16(veorq_s16(r, crSign), crSign);
+		b = vsubq_s16(veorq_s16(b, cbSign), cbSign);
+		g = vsubq_s16(vsubq_s16(crSign, veorq_s16(crG, crSign)),
+		              vsubq_s16(veorq_s16(cbG, cbSign), cbSign));
+	}
+
+	/** Convert eight pixels and store them to dst. */
+	void store(byte *dst, Vec y, Vec r, Vec g, Vec b) const {
+		const uint16x8_t rc = vshlq_u16(channel(vaddq_s16(y, r)), _rLoss);
+		const uint16x8_t gc = vshlq_u16(channel(vaddq_s16(y, g)), _gLoss);
+		const uint16x8_t bc = vshlq_u16(channel(vaddq_s16(y, b)), _bLoss);
+
+		if (sizeof(PixelInt) == 2) {
+			uint16x8_t pixels = vorrq_u16(vshlq_u16(rc, vdupq_n_s16(_rShift)), vshlq_u16(gc, vdupq_n_s16(_gShift)));
+			pixels = vorrq_u16(pixels, vshlq_u16(bc, vdupq_n_s16(_bShift)));
+			vst1q_u16((uint16 *)dst, vorrq_u16(pixels, vdupq_n_u16((uint16)_alpha)));
+		} else {
+			const int32x4_t rShift = vdupq_n_s32(_rShift);
+			const int32x4_t gShift = vdupq_n_s32(_gShift);
+			const int32x4_t bShift = vdupq_n_s32(_bShift);
+			const uint32x4_t alpha = vdupq_n_u32(_alpha);
+
+			uint32x4_t pixels = vorrq_u32(vshlq_u32(vmovl_u16(vget_low_u16(rc)), rShift), vshlq_u32(vmovl_u16(vget_low_u16(gc)), gShift));
+			pixels = vorrq_u32(pixels, vshlq_u32(vmovl_u16(vget_low_u16(bc)), bShift));
+			vst1q_u32((uint32 *)dst, vorrq_u32(pixels, alpha));
+
+			pixels = vorrq_u32(vshlq_u32(vmovl_u16(vget_high_u16(rc)), rShift), vshlq_u32(vmovl_u16(vget_high_u16(gc)), gShift));
+			pixels = vorrq_u32(pixels, vshlq_u32(vmovl_u16(vget_high_u16(bc)), bShift));
+			vst1q_u32((uint32 *)(dst + 16), vorrq_u32(pixels, alpha));
+		}
+	}
+
+private:
+	/** Unsigned multiplication of the lanes with a 16.16 fraction. */
+	static Vec mulhi(Vec x, uint16 fraction) {
+		const uint16x8_t ux = vreinterpretq_u16_s16(x);
+		const uint16x4_t f = vdup_n_u16(fraction);
+		return vreinterpretq_s16_u16(vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(ux), f), 16),
+		                                          vshrn_n_u32(vmull_u16(vget_high_u16(ux), f), 16)));
+	}
+
+	/** Clamp a channel to the luminance range and scale it to [0, 255]. */
+	uint16x8_t channel(Vec c) const {
+		c = vminq_s16(vmaxq_s16(c, _lo), _hi);
+		if (_itu) {
+			c = vsubq_s16(c, _lo);
+			c = vaddq_s16(c, mulhi(c, kITUScale));
+		}
+		return vreinterpretq_u16_s16(c);
+	}
+
+	bool _itu;
+	Vec _lo, _hi, _rLoss, _gLoss, _bLoss;
+	int _rShift, _gShift, _bShift;
+	uint32 _alpha;
+};
+
+#endif
+
+/**
+ * Convert one pixel with the tables, for the pixels which do not fill
+ * a whole vector at the end of a row.
+ */
+template<typename PixelInt>
+static inline void convertPixel(byte *dst, byte y, byte u, byte v, const int16 *colorTab, const uint32 *rgbToPix) {
+	const int16 *Cr_r_tab = colorTab;
+	const int16 *Cr_g_tab = Cr_r_tab + 256;
+	const int16 *Cb_g_tab = Cr_g_tab + 256;
+	const int16 *Cb_b_tab = Cb_g_tab + 256;
+
+	const uint32 *L = &rgbToPix[y];
+	*((PixelInt *)dst) = (L[Cr_r_tab[v]] | L[Cr_g_tab[v] + Cb_g_tab[u]] | L[Cb_b_tab[u]]);
+}
+
+template<typename PixelInt>
+void convertYUV444ToRGBVector(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	typedef YUVToRGBVector<PixelInt> Vector;
+	typedef typename Vector::Vec Vec;
+	const Vector vec(lookup);
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int h = 0; h < yHeight; h++) {
+		int x = 0;
+		for (; x + 8 <= yWidth; x += 8) {
+			Vec r, g, b;
+			vec.chroma(vec.load(uSrc + x), vec.load(vSrc + x), r, g, b);
+			vec.store(dstPtr + x * sizeof(PixelInt), vec.load(ySrc + x), r, g, b);
+		}
+
+		for (; x < yWidth; x++)
+			convertPixel<PixelInt>(dstPtr + x * sizeof(PixelInt), ySrc[x], uSrc[x], vSrc[x], colorTab, rgbToPix);
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+void convertYUV420ToRGBVector(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	typedef YUVToRGBVector<PixelInt> Vector;
+	typedef typename Vector::Vec Vec;
+	const Vector vec(lookup);
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	for (int h = 0; h < yHeight; h += 2) {
+		byte *dst0 = dstPtr;
+		byte *dst1 = dstPtr + dstPitch;
+		const byte *y0 = ySrc;
+		const byte *y1 = ySrc + yPitch;
+
+		// Each chroma sample covers two pixels in both rows
+		int x = 0;
+		for (; x + 16 <= yWidth; x += 16) {
+			Vec r, g, b;
+			vec.chroma(vec.load(uSrc + x / 2), vec.load(vSrc + x / 2), r, g, b);
+
+			const Vec rLow = Vector::repeatLow(r), gLow = Vector::repeatLow(g), bLow = Vector::repeatLow(b);
+			const Vec rHigh = Vector::repeatHigh(r), gHigh = Vector::repeatHigh(g), bHigh = Vector::repeatHigh(b);
+
+			vec.store(dst0 + x * sizeof(PixelInt), vec.load(y0 + x), rLow, gLow, bLow);
+			vec.store(dst0 + (x + 8) * sizeof(PixelInt), vec.load(y0 + x + 8), rHigh, gHigh, bHigh);
+			vec.store(dst1 + x * sizeof(PixelInt), vec.load(y1 + x), rLow, gLow, bLow);
+			vec.store(dst1 + (x + 8) * sizeof(PixelInt), vec.load(y1 + x + 8), rHigh, gHigh, bHigh);
+		}
+
+		for (; x < yWidth; x++) {
+			const byte u = uSrc[x / 2];
+			const byte v = vSrc[x / 2];
+			convertPixel<PixelInt>(dst0 + x * sizeof(PixelInt), y0[x], u, v, colorTab, rgbToPix);
+			convertPixel<PixelInt>(dst1 + x * sizeof(PixelInt), y1[x], u, v, colorTab, rgbToPix);
+		}
+
+		dstPtr += dstPitch * 2;
+		ySrc += yPitch * 2;
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
+template<typename PixelInt>
+void convertYUV410ToRGBVector(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup, int16 *colorTab, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch) {
+	typedef YUVToRGBVector<PixelInt> Vector;
+	typedef typename Vector::Vec Vec;
+	const Vector vec(lookup);
+	const uint32 *rgbToPix = lookup->getRGBToPix();
+
+	// The bilinear interpolation of convertYUV410ToRGB, split into a
+	// horizontal and a vertical step, which gives the same result:
+	// ((A * (4 - xDiff) + B * xDiff) * (4 - yDiff) + (C * (4 - xDiff) + D * xDiff) * yDiff) >> 4
+	const Vec xDiff = Vector::quadPositions();
+	const Vec xWeight = Vector::sub(Vector::set(4), xDiff);
+
+	for (int y = 0; y < yHeight; y++) {
+		const byte *uRow = uSrc + (y >> 2) * uvPitch;
+		const byte *vRow = vSrc + (y >> 2) * uvPitch;
+		const int yDiff = y & 3;
+		const Vec yDiffs = Vector::set(yDiff);
+		const Vec yWeight = Vector::set(4 - yDiff);
+
+		int x = 0;
+		for (; x + 8 <= yWidth; x += 8) {
+			const int i = x >> 2;
+			Vec top = Vector::add(Vector::mul(Vector::quads(uRow[i], uRow[i + 1]), xWeight), Vector::mul(Vector::quads(uRow[i + 1], uRow[i + 2]), xDiff));
+			Vec bottom = Vector::add(Vector::mul(Vector::quads(uRow[i + uvPitch], uRow[i + uvPitch + 1]), xWeight), Vector::mul(Vector::quads(uRow[i + uvPitch + 1], uRow[i + uvPitch + 2]), xDiff));
+			const Vec u = Vector::shiftRight4(Vector::add(Vector::mul(top, yWeight), Vector::mul(bottom, yDiffs)));
+
+			top = Vector::add(Vector::mul(Vector::quads(vRow[i], vRow[i + 1]), xWeight), Vector::mul(Vector::quads(vRow[i + 1], vRow[i + 2]), xDiff));
+			bottom = Vector::add(Vector::mul(Vector::quads(vRow[i + uvPitch], vRow[i + uvPitch + 1]), xWeight), Vector::mul(Vector::quads(vRow[i + uvPitch + 1], vRow[i + uvPitch + 2]), xDiff));
+			const Vec v = Vector::shiftRight4(Vector::add(Vector::mul(top, yWeight), Vector::mul(bottom, yDiffs)));
+
+			Vec r, g, b;
+			vec.chroma(u, v, r, g, b);
+			vec.store(dstPtr + x * sizeof(PixelInt), vec.load(ySrc + x), r, g, b);
+		}
+
+		for (; x < yWidth; x++) {
+			const int index = x >> 2;
+			const int xd = x & 3;
+			const int wA = (4 - xd) * (4 - yDiff);
+			const int wB = xd * (4 - yDiff);
+			const int wC = yDiff * (4 - xd);
+			const int wD = xd * yDiff;
+			const byte u = (uRow[index] * wA + uRow[index + 1] * wB + uRow[index + uvPitch] * wC + uRow[index + uvPitch + 1] * wD) >> 4;
+			const byte v = (vRow[index] * wA + vRow[index + 1] * wB + vRow[index + uvPitch] * wC + vRow[index + uvPitch + 1] * wD) >> 4;
+			convertPixel<PixelInt>(dstPtr + x * sizeof(PixelInt), ySrc[x], u, v, colorTab, rgbToPix);
+		}
+
+		dstPtr += dstPitch;
+		ySrc += yPitch;
+	}
+}
+
+#endif
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -235,6 +647,16 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+	if (_useSIMD) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV444ToRGBVector<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV444ToRGBVector<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV444ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -291,6 +713,16 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+	if (_useSIMD) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV420ToRGBVector<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV420ToRGBVector<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV420ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
@@ -376,6 +808,16 @@ void YUVToRGBManager::convert410(Graphics::Surface *dst, YUVToRGBManager::Lumina
 
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
+#if defined(USE_SSE2_YUV) || defined(USE_NEON_YUV)
+	if (_useSIMD) {
+		if (dst->format.bytesPerPixel == 2)
+			convertYUV410ToRGBVector<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		else
+			convertYUV410ToRGBVector<uint32>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
+		return;
+	}
+#endif
+
 	// Use a templated function to avoid an if check on every pixel
 	if (dst->format.bytesPerPixel == 2)
 		convertYUV410ToRGB<uint16>((byte *)dst->getPixels(), dst->pitch, lookup, _colorTab, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch);
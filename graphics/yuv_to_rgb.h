@@ -105,6 +105,18 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Whether this build has vector (SSE2 or NEON) versions of the conversions.
+	 */
+	bool hasSIMD() const;
+
+	/**
+	 * Select between the vector conversions (the default, if available)
+	 * and the table based ones. Both produce identical output; this is
+	 * meant for testing and benchmarking.
+	 */
+	void setUseSIMD(bool enable);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
@@ -114,6 +126,7 @@ private:
 
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
+	bool _useSIMD;
 };
 
 } // End of namespace Graphics
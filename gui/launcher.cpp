@@ -24,6 +24,7 @@
 
 #include "common/config-manager.h"
 #include "common/events.h"
+#include "common/fingerprint-cache.h"
 #include "common/fs.h"
 #include "common/gui_options.h"
 #include "common/util.h"
@@ -850,6 +851,8 @@ void LauncherDialog::addGame() {
 			// ...so let's determine a list of candidates, games that
 			// could be contained in the specified directory.
 			GameList candidates(EngineMan.detectGames(files));
+			FingerprintMan.prune(dir, false);
+			FingerprintMan.flush();
 
 			int idx;
 			if (candidates.empty()) {
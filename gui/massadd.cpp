@@ -24,6 +24,7 @@
 #include "common/algorithm.h"
 #include "common/config-manager.h"
 #include "common/debug.h"
+#include "common/fingerprint-cache.h"
 #include "common/system.h"
 #include "common/taskbar.h"
 #include "common/translation.h"
@@ -60,17 +61,12 @@ enum {
 
 MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	: Dialog("MassAdd"),
-	_dirsScanned(0),
-	_oldGamesCount(0),
-	_dirTotal(0),
+	_scanner(startDir),
 	_okButton(0),
 	_dirProgressText(0),
 	_gameProgressText(0) {
 
-	StringArray l;
-
-	// The dir we start our scan at
-	_scanStack.push(startDir);
+	Common::StringArray l;
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -93,30 +89,6 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 	_okButton->setEnabled(false);
 
 	new ButtonWidget(this, "MassAdd.Cancel", _("Cancel"), 0, kCancelCmd, Common::ASCII_ESCAPE);
-
-	// Build a map from all configured game paths to the targets using them
-	const Common::ConfigManager::DomainMap &domains = ConfMan.getGameDomains();
-	Common::ConfigManager::DomainMap::const_iterator iter;
-	for (iter = domains.begin(); iter != domains.end(); ++iter) {
-
-#ifdef __DS__
-		// DS port uses an extra section called 'ds'.  This prevents the section from being
-		// detected as a game.
-		if (iter->_key == "ds") {
-			continue;
-		}
-#endif
-
-		Common::String path(iter->_value.getVal("path"));
-		// Remove trailing slash, so that "/foo" and "/foo/" match.
-		// This works around a bug in the POSIX FS code (and others?)
-		// where paths are not normalized (so FSNodes refering to identical
-		// FS objects may return different values in path()).
-		while (path != "/" && path.lastChar() == '/')
-			path.deleteLastChar();
-		if (!path.empty())
-			_pathToTargets[path].push_back(iter->_key);
-	}
 }
 
 struct GameTargetLess {
@@ -172,101 +144,43 @@ void MassAddDialog::handleCommand(CommandSender *sender, uint32 cmd, uint32 data
 }
 
 void MassAddDialog::handleTickle() {
-	if (_scanStack.empty())
+	if (_scanner.isDone())
 		return;	// We have finished scanning
 
-	uint32 t = g_system->getMillis();
-
-	// Perform a breadth-first scan of the filesystem.
-	while (!_scanStack.empty() && (g_system->getMillis() - t) < kMaxScanTime) {
-		Common::FSNode dir = _scanStack.pop();
-
-		Common::FSList files;
-		if (!dir.getChildren(files, Common::FSNode::kListAll)) {
-			continue;
-		}
-
-		// Run the detector on the dir
-		GameList candidates(EngineMan.detectGames(files));
-
-		// Just add all detected games / game variants. If we get more than one,
-		// that either means the directory contains multiple games, or the detector
-		// could not fully determine which game variant it was seeing. In either
-		// case, let the user choose which entries he wants to keep.
-		//
-		// However, we only add games which are not already in the config file.
-		for (GameList::const_iterator cand = candidates.begin(); cand != candidates.end(); ++cand) {
-			GameDescriptor result = *cand;
-			Common::String path = dir.getPath();
-
-			// Remove trailing slashes
-			while (path != "/" && path.lastChar() == '/')
-				path.deleteLastChar();
-
-			// Check for existing config entries for this path/gameid/lang/platform combination
-			if (_pathToTargets.contains(path)) {
-				bool duplicate = false;
-				const StringArray &targets = _pathToTargets[path];
-				for (StringArray::const_iterator iter = targets.begin(); iter != targets.end(); ++iter) {
-					// If the gameid, platform and language match -> skip it
-					Common::ConfigManager::Domain *dom = ConfMan.getDomain(*iter);
-					assert(dom);
-
-					if ((*dom)["gameid"] == result["gameid"] &&
-					    (*dom)["platform"] == result["platform"] &&
-					    (*dom)["language"] == result["language"]) {
-						duplicate = true;
-						break;
-					}
-				}
-				if (duplicate) {
-					_oldGamesCount++;
-					break;	// Skip duplicates
-				}
-			}
-			result["path"] = path;
-			_games.push_back(result);
-
-			_list->append(result.description());
-		}
-
-
-		// Recurse into all subdirs
-		for (Common::FSList::const_iterator file = files.begin(); file != files.end(); ++file) {
-			if (file->isDirectory()) {
-				_scanStack.push(*file);
-
-				_dirTotal++;
-			}
-		}
+	_scanner.scan(kMaxScanTime);
 
-		_dirsScanned++;
+	// Pick up the games found in this slice
+	while (_scanner.hasGames()) {
+		_games.push_back(_scanner.popGame());
+		_list->append(_games.back().description());
+	}
 
 #if defined(USE_TASKBAR)
-		g_system->getTaskbarManager()->setProgressValue(_dirsScanned, _dirTotal);
-		g_system->getTaskbarManager()->setCount(_games.size());
+	g_system->getTaskbarManager()->setProgressValue(_scanner.getDirsScanned(), _scanner.getDirTotal());
+	g_system->getTaskbarManager()->setCount(_games.size());
 #endif
-	}
-
 
 	// Update the dialog
 	Common::String buf;
 
-	if (_scanStack.empty()) {
+	if (_scanner.isDone()) {
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
+		// Keep the fingerprints for the next scan
+		FingerprintMan.flush();
+
 		buf = _("Scan complete!");
 		_dirProgressText->setLabel(buf);
 
-		buf = Common::String::format(_("Discovered %d new games, ignored %d previously added games."), _games.size(), _oldGamesCount);
+		buf = Common::String::format(_("Discovered %d new games, ignored %d previously added games."), _games.size(), _scanner.getOldGamesCount());
 		_gameProgressText->setLabel(buf);
 
 	} else {
-		buf = Common::String::format(_("Scanned %d directories ..."), _dirsScanned);
+		buf = Common::String::format(_("Scanned %d directories ..."), _scanner.getDirsScanned());
 		_dirProgressText->setLabel(buf);
 
-		buf = Common::String::format(_("Discovered %d new games, ignored %d previously added games ..."), _games.size(), _oldGamesCount);
+		buf = Common::String::format(_("Discovered %d new games, ignored %d previously added games ..."), _games.size(), _scanner.getOldGamesCount());
 		_gameProgressText->setLabel(buf);
 	}
 
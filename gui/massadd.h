@@ -24,9 +24,8 @@
 #define MASSADD_DIALOG_H
 
 #include "gui/dialog.h"
+#include "engines/gamescanner.h"
 #include "common/fs.h"
-#include "common/hashmap.h"
-#include "common/stack.h"
 #include "common/str.h"
 
 namespace GUI {
@@ -34,7 +33,6 @@ namespace GUI {
 class StaticTextWidget;
 
 class MassAddDialog : public Dialog {
-	typedef Common::Array<Common::String> StringArray;
 public:
 	MassAddDialog(const Common::FSNode &startDir);
 
@@ -49,20 +47,9 @@ public:
 	}
 
 private:
-	Common::Stack<Common::FSNode>  _scanStack;
+	GameScanner _scanner;
 	GameList _games;
 
-	/**
-	 * Map each path occuring in the config file to the target(s) using that path.
-	 * Used to detect whether a potential new target is already present in the
-	 * config manager.
-	 */
-	Common::HashMap<Common::String, StringArray>	_pathToTargets;
-
-	int _dirsScanned;
-	int _oldGamesCount;
-	int _dirTotal;
-
 	Widget *_okButton;
 	StaticTextWidget *_dirProgressText;
 	StaticTextWidget *_gameProgressText;
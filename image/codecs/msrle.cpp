@@ -23,6 +23,7 @@
 // Based off ffmpeg's msrledec.c
 
 #include "image/codecs/msrle.h"
+#include "common/spanreader.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 
@@ -49,6 +50,7 @@ const Graphics::Surface *MSRLEDecoder::decodeFrame(Common::SeekableReadStream &s
 }
 
 void MSRLEDecoder::decode8(Common::SeekableReadStream &stream) {
+	Common::SpanReader reader(stream);
 
 	int x = 0;
 	int y = _surface->h - 1;
@@ -60,9 +62,9 @@ void MSRLEDecoder::decode8(Common::SeekableReadStream &stream) {
 	byte *output     = data + ((height - 1) * width);
 	byte *output_end = data + ((height)     * width);
 
-	while (!stream.eos()) {
-		byte count = stream.readByte();
-		byte value = stream.readByte();
+	while (!reader.eos()) {
+		byte count = reader.readByte();
+		byte value = reader.readByte();
 
 		if (count == 0) {
 			if (value == 0) {
@@ -84,8 +86,8 @@ void MSRLEDecoder::decode8(Common::SeekableReadStream &stream) {
 			} else if (value == 2) {
 				// Skip
 
-				count = stream.readByte();
-				value = stream.readByte();
+				count = reader.readByte();
+				value = reader.readByte();
 
 				y -= value;
 				x += count;
@@ -101,15 +103,15 @@ void MSRLEDecoder::decode8(Common::SeekableReadStream &stream) {
 				// Copy data
 
 				if (output + value > output_end) {
-					stream.skip(value);
+					reader.skip(value);
 					continue;
 				}
 
 				for (int i = 0; i < value; i++)
-					*output++ = stream.readByte();
+					*output++ = reader.readByte();
 
 				if (value & 1)
-					stream.skip(1);
+					reader.skip(1);
 
 				x += value;
 			}
@@ -23,6 +23,7 @@
 // Based off ffmpeg's msrledec.c
 #include "common/debug.h"
 #include "image/codecs/msrle4.h"
+#include "common/spanreader.h"
 #include "common/stream.h"
 #include "common/textconsole.h"
 #include "common/util.h"
@@ -49,17 +50,18 @@ const Graphics::Surface *MSRLE4Decoder::decodeFrame(Common::SeekableReadStream &
 }
 
 void MSRLE4Decoder::decode4(Common::SeekableReadStream &stream) {
+	Common::SpanReader reader(stream);
 	int x = 0;
 	int y = _surface->h - 1;
 
 	byte *output     = (byte *)_surface->getBasePtr(x, y);
 	byte *output_end = (byte *)_surface->getBasePtr(_surface->w, y);
 
-	while (!stream.eos()) {
-		byte count = stream.readByte();
+	while (!reader.eos()) {
+		byte count = reader.readByte();
 
 		if (count == 0) {
-			byte value = stream.readByte();
+			byte value = reader.readByte();
 
 			if (value == 0) {
 				// End of line
@@ -74,8 +76,8 @@ void MSRLE4Decoder::decode4(Common::SeekableReadStream &stream) {
 			} else if (value == 2) {
 				// Skip
 
-				count = stream.readByte();
-				value = stream.readByte();
+				count = reader.readByte();
+				value = reader.readByte();
 
 				x += count;
 				y -= value;
@@ -95,12 +97,12 @@ void MSRLE4Decoder::decode4(Common::SeekableReadStream &stream) {
 				int extra_byte = rle_code & 0x01;
 
 				if (output + value > output_end) {
-					stream.skip(rle_code + extra_byte);
+					reader.skip(rle_code + extra_byte);
 					continue;
 				}
 
 				for (int i = 0; i < rle_code; i++) {
-					byte color = stream.readByte();
+					byte color = reader.readByte();
 					*output++ = (color & 0xf0) >> 4;
 					if (i + 1 == rle_code && odd_pixel) {
 						break;
@@ -109,7 +111,7 @@ void MSRLE4Decoder::decode4(Common::SeekableReadStream &stream) {
 				}
 
 				if (extra_byte)
-					stream.skip(1);
+					reader.skip(1);
 
 				x += value;
 			}
@@ -120,7 +122,7 @@ void MSRLE4Decoder::decode4(Common::SeekableReadStream &stream) {
 			if (output + count > output_end)
 				continue;
 
-			byte color = stream.readByte();
+			byte color = reader.readByte();
 
 			for (int i = 0; i < count; i++, x++) {
 				*output++ = (color & 0xf0) >> 4;
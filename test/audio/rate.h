@@ -0,0 +1,188 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+
+#include "helper.h"
+
+class RateConverterTestSuite : public CxxTest::TestSuite
+{
+private:
+	static int16 expectedMix(int16 dst, int16 src, int vol) {
+		int val = dst + (src * vol) / Audio::Mixer::kMaxMixerVolume;
+		if (val > Audio::ST_SAMPLE_MAX)
+			val = Audio::ST_SAMPLE_MAX;
+		else if (val < Audio::ST_SAMPLE_MIN)
+			val = Audio::ST_SAMPLE_MIN;
+		return val;
+	}
+
+	void copyFlowTestTemplate(const bool isStereo, const bool reverseStereo, const int volL, const int volR, const int16 preset) {
+		const int sampleRate = 11025;
+		// An odd number of sample pairs, so the scalar tail is exercised too
+		const int pairs = 1001;
+
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(sampleRate, 1, &sine, false, isStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(sampleRate, sampleRate, isStereo, reverseStereo);
+
+		int16 *buffer = new int16[pairs * 2];
+		for (int i = 0; i < pairs * 2; ++i)
+			buffer[i] = (i & 1) ? -preset : preset;
+
+		TS_ASSERT_EQUALS(converter->flow(*s, buffer, pairs, volL, volR), pairs);
+
+		for (int i = 0; i < pairs; ++i) {
+			const int16 in0 = isStereo ? sine[i * 2] : sine[i];
+			const int16 in1 = isStereo ? sine[i * 2 + 1] : sine[i];
+			const int left = reverseStereo ? 1 : 0;
+
+			TS_ASSERT_EQUALS(buffer[i * 2 + left], expectedMix(left ? -preset : preset, in0, volL));
+			TS_ASSERT_EQUALS(buffer[i * 2 + (left ^ 1)], expectedMix(left ? preset : -preset, in1, volR));
+		}
+
+		delete[] buffer;
+		delete converter;
+		delete[] sine;
+		delete s;
+	}
+
+	static Audio::SeekableAudioStream *createToneStream(const int sampleRate, const double freq, const int amplitude, const int samples) {
+		byte *data = (byte *)malloc(samples * 2);
+		for (int i = 0; i < samples; ++i)
+			WRITE_LE_UINT16(data + i * 2, (int16)floor(amplitude * sin(2 * M_PI * freq * i / sampleRate) + 0.5));
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, samples * 2, DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, sampleRate, Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN);
+	}
+
+	/**
+	 * Resample a mono tone with the sinc converter, and return the largest
+	 * difference to a tone of the given amplitude at the output rate,
+	 * ignoring the filter's start up at the beginning of the stream.
+	 */
+	int sincToneError(const int inRate, const int outRate, const double freq, const int amplitude, const int expectedAmplitude) {
+		const int pairs = outRate / 10;
+		const int skip = 64;
+
+		const Audio::ResamplerType oldType = Audio::getResamplerType();
+		Audio::setResamplerType(Audio::kResamplerSinc);
+		Audio::SeekableAudioStream *s = createToneStream(inRate, freq, amplitude, inRate / 5);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inRate, outRate, false);
+		Audio::setResamplerType(oldType);
+
+		int16 *buffer = new int16[pairs * 2];
+		memset(buffer, 0, sizeof(int16) * pairs * 2);
+		TS_ASSERT_EQUALS(converter->flow(*s, buffer, pairs, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), pairs);
+
+		int maxError = 0;
+		for (int i = skip; i < pairs; ++i) {
+			const int expected = (int)floor(expectedAmplitude * sin(2 * M_PI * freq * i / outRate) + 0.5);
+			TS_ASSERT_EQUALS(buffer[i * 2], buffer[i * 2 + 1]);
+			maxError = MAX(maxError, ABS(buffer[i * 2] - expected));
+		}
+
+		delete[] buffer;
+		delete converter;
+		delete s;
+		return maxError;
+	}
+
+public:
+	void test_copy_flow_mono() {
+		copyFlowTestTemplate(false, false, Audio::Mixer::kMaxMixerVolume, 77, 0);
+	}
+
+	void test_copy_flow_stereo() {
+		copyFlowTestTemplate(true, false, 200, Audio::Mixer::kMaxMixerVolume, 0);
+	}
+
+	void test_copy_flow_reverse_stereo() {
+		copyFlowTestTemplate(true, true, 31, 180, 0);
+	}
+
+	void test_copy_flow_saturation() {
+		copyFlowTestTemplate(true, false, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume, 30000);
+	}
+
+	void test_copy_flow_high_volume() {
+		// The scaled samples exceed 16 bits, only their sum with the buffer is saturated
+		copyFlowTestTemplate(true, false, 0x7FFF, 1000, 20000);
+		copyFlowTestTemplate(true, true, 1000, 0x7FFF, -20000);
+	}
+
+	void test_copy_flow_accumulate() {
+		// The mix bus keeps the headroom which flow() would clip away
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(11025, 1, &sine, false, true);
+		Audio::RateConverter *converter = Audio::makeRateConverter(11025, 11025, true, true);
+
+		const int pairs = 1001;
+		Audio::st_mix_t *bus = new Audio::st_mix_t[pairs * 2];
+		for (int i = 0; i < pairs * 2; ++i)
+			bus[i] = 40000;
+
+		TS_ASSERT_EQUALS(converter->flowAccumulate(*s, bus, pairs, 100, Audio::Mixer::kMaxMixerVolume), pairs);
+		for (int i = 0; i < pairs; ++i) {
+			TS_ASSERT_EQUALS(bus[i * 2 + 1], 40000 + (sine[i * 2] * 100) / Audio::Mixer::kMaxMixerVolume);
+			TS_ASSERT_EQUALS(bus[i * 2], 40000 + sine[i * 2 + 1]);
+		}
+
+		delete[] bus;
+		delete converter;
+		delete[] sine;
+		delete s;
+	}
+
+	void test_simple_flow_decimation() {
+		// 22050 -> 11025 Hz takes every second input sample
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(22050, 1, &sine, false, false);
+		Audio::RateConverter *converter = Audio::makeRateConverter(22050, 11025, false);
+
+		const int pairs = 777;
+		int16 *buffer = new int16[pairs * 2];
+		memset(buffer, 0, sizeof(int16) * pairs * 2);
+
+		TS_ASSERT_EQUALS(converter->flow(*s, buffer, pairs, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), pairs);
+		for (int i = 0; i < pairs; ++i) {
+			TS_ASSERT_EQUALS(buffer[i * 2], sine[i * 2 + 1]);
+			TS_ASSERT_EQUALS(buffer[i * 2 + 1], sine[i * 2 + 1]);
+		}
+
+		delete[] buffer;
+		delete converter;
+		delete[] sine;
+		delete s;
+	}
+
+	void test_sinc_upsample_tone() {
+		// A 1 kHz tone is well inside the passband
+		TS_ASSERT_LESS_THAN(sincToneError(11025, 44100, 1000, 16000, 16000), 100);
+		TS_ASSERT_LESS_THAN(sincToneError(22050, 48000, 3000, 16000, 16000), 100);
+	}
+
+	void test_sinc_downsample_alias() {
+		// An 8 kHz tone can't be represented at 11025 Hz, and must not
+		// alias to 3025 Hz
+		TS_ASSERT_LESS_THAN(sincToneError(44100, 11025, 8000, 16000, 0), 100);
+	}
+
+	void test_flow_end_of_stream() {
+		// Asking for more data than available returns the available amount
+		int16 *sine;
+		Audio::SeekableAudioStream *s = createSineStream<int16>(1000, 1, &sine, false, true);
+		Audio::RateConverter *converter = Audio::makeRateConverter(1000, 1000, true);
+
+		int16 *buffer = new int16[3000 * 2];
+		memset(buffer, 0, sizeof(int16) * 3000 * 2);
+
+		TS_ASSERT_EQUALS(converter->flow(*s, buffer, 3000, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume), 1000);
+
+		delete[] buffer;
+		delete converter;
+		delete[] sine;
+		delete s;
+	}
+};
@@ -0,0 +1,220 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Finds paths through the polygons of a few rooms with the SCI pathfinder,
+// with and without the cached visibility graphs and the heap of
+// Sci::findAvoidPath, and checks that both find the same paths. Build and
+// run it with "make benchmark".
+//
+// The polygons are written like the "Polygons:" part of the input which
+// kAvoidPath prints on the AvoidPath debug channel, so further rooms can be
+// pasted from there.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/util.h"
+#include "sci/engine/kpathing.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+namespace {
+
+enum {
+	kPaths = 400,
+	kRuns = 5
+};
+
+struct Room {
+	const char *name;
+	int width, height;
+	const char *polygons;
+};
+
+// Polygon types: 0 total access, 1 nearest access, 2 barred access,
+// 3 contained access
+const Room kRooms[] = {
+	{ "street", 320, 190,
+		"3: (0, 189) (0, 140) (40, 128) (70, 130) (95, 118) (150, 116) (180, 120) (210, 112) "
+		"(260, 114) (290, 124) (319, 130) (319, 189) (250, 189) (240, 170) (200, 168) (190, 189) (0, 189);"
+		"2: (100, 150) (140, 150) (140, 158) (100, 158) (100, 150);"
+		"2: (220, 140) (226, 140) (226, 146) (220, 146) (220, 140);"
+		"2: (150, 170) (160, 164) (172, 164) (182, 170) (182, 178) (172, 184) (160, 184) (150, 178) (150, 170);" },
+	{ "interior", 320, 190,
+		"2: (0, 0) (319, 0) (319, 120) (270, 120) (250, 104) (70, 104) (50, 120) (0, 120) (0, 0);"
+		"0: (120, 140) (200, 140) (210, 170) (110, 170) (120, 140);"
+		"2: (135, 146) (185, 146) (188, 160) (132, 160) (135, 146);"
+		"2: (122, 150) (130, 150) (130, 158) (122, 158) (122, 150);"
+		"2: (190, 150) (198, 150) (198, 158) (190, 158) (190, 150);"
+		"1: (20, 130) (60, 130) (60, 150) (20, 150) (20, 130);"
+		"2: (250, 130) (300, 135) (305, 170) (290, 180) (255, 175) (245, 150) (250, 130);"
+		"2: (0, 180) (319, 180) (319, 189) (0, 189) (0, 180);" },
+	{ "forest", 320, 190,
+		"3: (0, 189) (0, 110) (30, 96) (80, 100) (110, 90) (160, 94) (220, 88) (270, 96) (319, 104) (319, 189) (0, 189);"
+		"2: (40, 120) (46, 116) (52, 120) (52, 128) (46, 132) (40, 128) (40, 120);"
+		"2: (80, 140) (86, 136) (92, 140) (92, 148) (86, 152) (80, 148) (80, 140);"
+		"2: (120, 112) (126, 108) (132, 112) (132, 120) (126, 124) (120, 120) (120, 112);"
+		"2: (150, 150) (156, 146) (162, 150) (162, 158) (156, 162) (150, 158) (150, 150);"
+		"2: (190, 124) (196, 120) (202, 124) (202, 132) (196, 136) (190, 132) (190, 124);"
+		"2: (230, 160) (236, 156) (242, 160) (242, 168) (236, 172) (230, 168) (230, 160);"
+		"2: (260, 118) (266, 114) (272, 118) (272, 126) (266, 130) (260, 126) (260, 118);"
+		"2: (290, 146) (296, 142) (302, 146) (302, 154) (296, 158) (290, 154) (290, 146);"
+		"2: (30, 166) (36, 162) (42, 166) (42, 174) (36, 178) (30, 174) (30, 166);"
+		"2: (110, 170) (116, 166) (122, 170) (122, 178) (116, 182) (110, 178) (110, 170);"
+		"2: (200, 176) (206, 172) (212, 176) (212, 184) (206, 188) (200, 184) (200, 176);"
+		"2: (60, 104) (70, 102) (76, 108) (66, 112) (60, 104);"
+		"1: (240, 100) (256, 100) (256, 108) (240, 108) (240, 100);" },
+	{ "maze", 320, 190,
+		"2: (20, 20) (300, 20) (300, 30) (30, 30) (30, 80) (20, 80) (20, 20);"
+		"2: (60, 50) (260, 50) (260, 60) (150, 60) (150, 100) (140, 100) (140, 60) (60, 60) (60, 50);"
+		"2: (290, 40) (300, 40) (300, 170) (200, 170) (200, 160) (290, 160) (290, 40);"
+		"2: (20, 110) (110, 110) (110, 120) (30, 120) (30, 170) (20, 170) (20, 110);"
+		"2: (60, 140) (170, 140) (170, 90) (180, 90) (180, 150) (60, 150) (60, 140);"
+		"2: (210, 80) (260, 80) (260, 130) (250, 130) (250, 90) (210, 90) (210, 80);"
+		"2: (80, 75) (120, 75) (120, 95) (80, 95) (80, 75);" },
+	{ "hires", 640, 480,
+		"3: (0, 479) (0, 300) (80, 260) (200, 250) (320, 230) (450, 240) (560, 270) (639, 300) (639, 479) (0, 479);"
+		"2: (100, 330) (180, 320) (220, 360) (190, 400) (110, 400) (80, 370) (100, 330);"
+		"2: (300, 300) (360, 300) (360, 340) (300, 340) (300, 300);"
+		"2: (420, 360) (520, 350) (560, 420) (470, 450) (400, 420) (420, 360);"
+		"2: (240, 420) (280, 420) (280, 460) (240, 460) (240, 420);"
+		"1: (560, 300) (610, 300) (610, 330) (560, 330) (560, 300);"
+		"0: (20, 420) (120, 420) (120, 470) (20, 470) (20, 420);" }
+};
+
+void parsePolygons(const char *text, Sci::AvoidPathPolygonList &polygons) {
+	int type, x, y, n;
+
+	while (sscanf(text, " %d:%n", &type, &n) == 1) {
+		text += n;
+
+		Sci::AvoidPathPolygon polygon;
+		polygon.type = type;
+
+		while (sscanf(text, " (%d, %d)%n", &x, &y, &n) == 2) {
+			text += n;
+			polygon.points.push_back(Common::Point(x, y));
+		}
+
+		// The debug output repeats the first point at the end
+		if (polygon.points.size() > 1 && polygon.points.back() == polygon.points.front())
+			polygon.points.pop_back();
+
+		polygons.push_back(polygon);
+
+		while (*text == ' ' || *text == ';')
+			text++;
+	}
+}
+
+struct Query {
+	Common::Point start, end;
+	int opt;
+};
+
+void makeQueries(const Room &room, Common::Array<Query> &queries) {
+	// Actors mostly walk back and forth between a few spots, so the points
+	// are taken from a coarse grid
+	srand(1234);
+
+	for (int i = 0; i < kPaths; i++) {
+		Query query;
+		query.start = Common::Point((rand() % 16) * room.width / 16, (rand() % 16) * room.height / 16);
+		query.end = Common::Point((rand() % 16) * room.width / 16, (rand() % 16) * room.height / 16);
+		// Some keyboard movement
+		query.opt = (i % 8) ? 1 : 0;
+		queries.push_back(query);
+	}
+}
+
+struct Result {
+	Common::Array<Common::Array<Common::Point> > paths;
+	Common::Array<int> lengths;
+	double millis;
+	uint32 hits, misses;
+};
+
+void findPaths(const Room &room, const Sci::AvoidPathPolygonList &polygons, const Common::Array<Query> &queries, bool cached, Result &result) {
+	result.paths.resize(queries.size());
+	result.lengths.resize(queries.size());
+
+	result.hits = result.misses = 0;
+
+	const clock_t start = clock();
+
+	for (int run = 0; run < kRuns; run++) {
+		// A fresh cache for each run, as if the room was entered again
+		Sci::AvoidPathCache cache;
+
+		for (uint i = 0; i < queries.size(); i++) {
+			result.lengths[i] = Sci::findAvoidPath(polygons, queries[i].start, queries[i].end, room.width, room.height,
+				queries[i].opt, Sci::kAvoidPathNoWorkaround, cached ? &cache : NULL, result.paths[i]);
+		}
+
+		result.hits += cache.getHits();
+		result.misses += cache.getMisses();
+	}
+
+	result.millis = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC / kRuns;
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	int failures = 0;
+
+	for (int r = 0; r < (int)ARRAYSIZE(kRooms); r++) {
+		const Room &room = kRooms[r];
+
+		Sci::AvoidPathPolygonList polygons;
+		parsePolygons(room.polygons, polygons);
+
+		uint vertices = 0;
+		for (uint i = 0; i < polygons.size(); i++)
+			vertices += polygons[i].points.size();
+
+		Common::Array<Query> queries;
+		makeQueries(room, queries);
+
+		Result plain, cached;
+		findPaths(room, polygons, queries, false, plain);
+		findPaths(room, polygons, queries, true, cached);
+
+		int mismatches = 0;
+		for (uint i = 0; i < queries.size(); i++) {
+			if (plain.lengths[i] != cached.lengths[i] || plain.paths[i] != cached.paths[i]) {
+				if (!mismatches)
+					printf("%s: MISMATCH for (%d, %d) -> (%d, %d), opt %d\n", room.name, queries[i].start.x, queries[i].start.y,
+						queries[i].end.x, queries[i].end.y, queries[i].opt);
+				mismatches++;
+			}
+		}
+		failures += mismatches;
+
+		printf("%-9s %2d polygons %3d vertices  %d paths  plain %8.3f ms   cached %8.3f ms (%u hits, %u misses)   speedup %5.2fx%s\n",
+			room.name, polygons.size(), vertices, queries.size(), plain.millis, cached.millis, cached.hits, cached.misses,
+			cached.millis > 0 ? plain.millis / cached.millis : 0.0, mismatches ? "   MISMATCH" : "");
+	}
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,191 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Compares the vector and the scalar block kernels of the Bink decoder,
+// and checks that their output is identical. Build and run it with
+// "make benchmark".
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/util.h"
+#include "video/bink_dsp.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+
+enum {
+	kBlocks = 4096,
+	kRounds = 400,
+	// The 8x8 blocks of a 640x480 frame with 4:2:0 chroma
+	kBlocksPerFrame = 80 * 60 * 3 / 2,
+	kPitch = 64
+};
+
+enum Kernel {
+	kKernelIDCT,
+	kKernelIDCTPut,
+	kKernelIDCTAdd,
+	kKernelIDCTPutScaled,
+	kKernelAddBlock
+};
+
+/**
+ * Fill the coefficient blocks. Most look like real DCT data with a large
+ * DC value and a few small AC values. One in eight is random noise up to
+ * the [-8192, 8191] limit of the vector IDCT, with some coefficients right
+ * at the limit, to check that the vector code overflows and wraps around
+ * just like the scalar code. Another one in eight is random noise over the
+ * whole int16 range, which the vector code hands to the scalar fallback.
+ */
+void fillBlocks(int16 *blocks) {
+	srand(1234);
+	for (int b = 0; b < kBlocks; b++) {
+		int16 *block = blocks + b * 64;
+		if ((b % 8) == 7) {
+			for (int i = 0; i < 64; i++)
+				block[i] = (int16)(rand() & 0xFFFF);
+		} else if ((b % 8) == 6) {
+			for (int i = 0; i < 64; i++) {
+				switch (rand() % 4) {
+				case 0:
+					block[i] = -8192;
+					break;
+				case 1:
+					block[i] = 8191;
+					break;
+				default:
+					block[i] = (rand() % 16384) - 8192;
+					break;
+				}
+			}
+		} else {
+			memset(block, 0, 64 * sizeof(int16));
+			block[0] = (rand() % 4096) - 2048;
+			const int count = rand() % 12;
+			for (int i = 0; i < count; i++)
+				block[rand() % 64] = (rand() % 512) - 256;
+		}
+	}
+}
+
+double run(Kernel kernel, const int16 *blocks, byte *pixels) {
+	int16 block[64];
+	const clock_t start = clock();
+
+	for (int round = 0; round < kRounds; round++) {
+		for (int b = 0; b < kBlocks; b++) {
+			memcpy(block, blocks + b * 64, sizeof(block));
+			byte *dest = pixels + (b % 16) * 16;
+
+			switch (kernel) {
+			case kKernelIDCT:
+				Video::BinkDSP::idct(block);
+				memcpy(pixels, block, sizeof(block));
+				break;
+			case kKernelIDCTPut:
+				Video::BinkDSP::idctPut(dest, kPitch, block);
+				break;
+			case kKernelIDCTAdd:
+				Video::BinkDSP::idctAdd(dest, kPitch, block);
+				break;
+			case kKernelIDCTPutScaled:
+				Video::BinkDSP::idctPutScaled(dest, kPitch, block);
+				break;
+			case kKernelAddBlock:
+				Video::BinkDSP::addBlock(dest, kPitch, block);
+				break;
+			}
+		}
+	}
+
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	static const char *const kernelNames[] = { "idct", "idctPut", "idctAdd", "idctPutScaled", "addBlock" };
+
+	if (!Video::BinkDSP::hasSIMD()) {
+		printf("No vector Bink kernels in this build\n");
+		return 0;
+	}
+
+	int16 *blocks = (int16 *)malloc(kBlocks * 64 * sizeof(int16));
+	fillBlocks(blocks);
+
+	// Large enough for 16x16 scaled blocks at any of the offsets used
+	const int pixelSize = kPitch * 16 + 16 * 16;
+	byte *scalarPixels = (byte *)malloc(pixelSize);
+	byte *simdPixels = (byte *)malloc(pixelSize);
+
+	int failures = 0;
+	for (int k = kKernelIDCT; k <= kKernelAddBlock; k++) {
+		memset(scalarPixels, 0x55, pixelSize);
+		memset(simdPixels, 0x55, pixelSize);
+
+		Video::BinkDSP::setUseSIMD(false);
+		const double scalarMillis = run((Kernel)k, blocks, scalarPixels);
+		Video::BinkDSP::setUseSIMD(true);
+		const double simdMillis = run((Kernel)k, blocks, simdPixels);
+
+		const bool same = memcmp(scalarPixels, simdPixels, pixelSize) == 0;
+		if (!same)
+			failures++;
+
+		// Frames per second of a 640x480 video if every block used this kernel
+		const double frames = (double)kBlocks * kRounds / kBlocksPerFrame;
+		printf("%-14s scalar %7.1f fps   vector %7.1f fps   speedup %5.2fx%s\n", kernelNames[k],
+			scalarMillis > 0 ? frames * 1000.0 / scalarMillis : 0.0,
+			simdMillis > 0 ? frames * 1000.0 / simdMillis : 0.0,
+			simdMillis > 0 ? scalarMillis / simdMillis : 0.0, same ? "" : "   MISMATCH");
+	}
+
+	// Check every block individually as well, since the kernels above
+	// overwrite each other's results
+	for (int b = 0; b < kBlocks; b++) {
+		int16 scalarBlock[64], simdBlock[64];
+		memcpy(scalarBlock, blocks + b * 64, sizeof(scalarBlock));
+		memcpy(simdBlock, blocks + b * 64, sizeof(simdBlock));
+
+		Video::BinkDSP::setUseSIMD(false);
+		Video::BinkDSP::idct(scalarBlock);
+		Video::BinkDSP::setUseSIMD(true);
+		Video::BinkDSP::idct(simdBlock);
+
+		if (memcmp(scalarBlock, simdBlock, sizeof(scalarBlock))) {
+			printf("idct mismatch in block %d\n", b);
+			failures++;
+			break;
+		}
+	}
+
+	free(blocks);
+	free(scalarPixels);
+	free(simdPixels);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Reads bit streams like the Smacker and Bink decoders do, once from a
+// MemoryReadStream, which hands its data over through the read window, and
+// once through a SeekableSubReadStream, which has no window and so is read
+// with a virtual read() per value. The latter is what the Bink decoder used
+// for its packets before. Build and run it with "make benchmark".
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/bitstream.h"
+#include "common/memstream.h"
+#include "common/substream.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+namespace {
+
+enum {
+	kDataSize = 256 * 1024,
+	kRounds = 20
+};
+
+/** Smacker reads its Huffman codes one bit at a time from 8 bit values */
+uint32 readBits(Common::BitStream &bits) {
+	uint32 sum = 0;
+	while (!bits.eos())
+		sum = sum * 3 + bits.getBit();
+	return sum;
+}
+
+/** Bink reads fields of varying widths from 32 bit values */
+uint32 readFields(Common::BitStream &bits) {
+	uint32 sum = 0;
+	uint32 width = 1;
+	while (bits.size() - bits.pos() >= 32) {
+		sum = sum * 3 + bits.getBits(width);
+		width = width % 13 + 1;
+	}
+	return sum;
+}
+
+template<class BITSTREAM>
+double run(const byte *data, bool window, uint32 (*reader)(Common::BitStream &), uint32 &result) {
+	const clock_t start = clock();
+	for (int round = 0; round < kRounds; round++) {
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, kDataSize);
+		if (!window)
+			stream = new Common::SeekableSubReadStream(stream, 0, kDataSize, DisposeAfterUse::YES);
+
+		BITSTREAM bits(stream, true);
+		result = reader(bits);
+	}
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC / kRounds;
+}
+
+template<class BITSTREAM>
+bool report(const char *name, const byte *data, uint32 (*reader)(Common::BitStream &)) {
+	uint32 plainResult, windowResult;
+	const double plainMillis = run<BITSTREAM>(data, false, reader, plainResult);
+	const double windowMillis = run<BITSTREAM>(data, true, reader, windowResult);
+
+	printf("%-24s sub stream %7.3f ms   memory stream %7.3f ms   speedup %5.2fx%s\n", name, plainMillis, windowMillis,
+		windowMillis > 0 ? plainMillis / windowMillis : 0.0, plainResult == windowResult ? "" : "   MISMATCH");
+	return plainResult == windowResult;
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	byte *data = (byte *)malloc(kDataSize);
+	srand(1234);
+	for (int i = 0; i < kDataSize; i++)
+		data[i] = rand() & 0xFF;
+
+	int failures = 0;
+	if (!report<Common::BitStream8LSB>("Smacker bits (8LSB)", data, readBits))
+		failures++;
+	if (!report<Common::BitStream32LELSB>("Bink fields (32LELSB)", data, readFields))
+		failures++;
+	if (!report<Common::BitStream32LELSB>("Bink bits (32LELSB)", data, readBits))
+		failures++;
+
+	free(data);
+	return failures ? 1 : 0;
+}
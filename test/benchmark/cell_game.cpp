@@ -0,0 +1,124 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Lets Stauf move in recorded positions of the microscope puzzle of The 7th
+// Guest, with and without the transposition table and the move ordering of
+// Groovie::CellGame, and checks that both choose the same move. Build and
+// run it with "make benchmark".
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/util.h"
+#include "groovie/cell.h"
+
+#include <stdio.h>
+#include <time.h>
+
+namespace {
+
+// Positions before a move of Stauf (green), from games at varying depths.
+// The board is stored row by row, 'b' is blue, 'g' is green.
+const char *const kPositions[] = {
+	"bb...ggb..................................g.....b",
+	"g...bbbgg..bbbg....b......................g.....b",
+	"bbg.bggbb...bbgb...bbg....................g.....b",
+	".bbbgbgbbgggbbgbbb..bgbb..................g.....b",
+	".bbbbbgbggbbbggggbgggbgg....bb............g.....b",
+	"ggbbbbggggbbbggbbbbggbbbb...gbb....gg.....g.....b",
+	"bbgg..g.bbb..g..b.........................g.....b",
+	"gggbbbbgggbbb.bbg.g.......................g.....b",
+	"gbbbbbbgbbbgbbbbbbgggbb...................g.....b",
+	"gggbbbbgggbbbbbbgbbbbbbbbb..bbg.....gg..........b",
+	"gggbbbbgggbbbbbbbbbbbbbbbb..gbbbg..ggbgg.........",
+	"bbb..ggbb...gg............................g.....b",
+	"bb..bbgbb...bgb.....gb...................gg.....g",
+	"gbgbbbggbgbbbg....b................b.....gb.....g",
+	"gbgbbbbbbgbgbb.bbg.bbb.g...b........bb....gb....g",
+	"gbgbbbbgggggbbbggggbggbb..ggbbb....bb....gb.....g"
+};
+
+// Script depths, which select searches of one to three plies
+const int kDepths[] = { 2, 4, 7 };
+
+struct Result {
+	byte startX, startY, endX, endY;
+	uint32 nodes, hits;
+	double millis;
+};
+
+Result playStauf(const char *position, int depth, bool fastSearch) {
+	byte board[49];
+	for (int i = 0; i < 49; i++)
+		board[i] = position[i] == 'b' ? 50 : (position[i] == 'g' ? 66 : 0);
+
+	Groovie::CellGame game;
+	game.setFastSearch(fastSearch);
+
+	const clock_t start = clock();
+	game.playStauf(2, depth, board);
+
+	Result result;
+	result.millis = (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+	result.startX = game.getStartX();
+	result.startY = game.getStartY();
+	result.endX = game.getEndX();
+	result.endY = game.getEndY();
+	result.nodes = game.getSearchNodes();
+	result.hits = game.getSearchHits();
+	return result;
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	int failures = 0;
+
+	for (int d = 0; d < (int)ARRAYSIZE(kDepths); d++) {
+		double plainMillis = 0, fastMillis = 0, worstPlain = 0, worstFast = 0;
+		uint32 plainNodes = 0, fastNodes = 0, hits = 0;
+
+		for (int p = 0; p < (int)ARRAYSIZE(kPositions); p++) {
+			const Result plain = playStauf(kPositions[p], kDepths[d], false);
+			const Result fast = playStauf(kPositions[p], kDepths[d], true);
+
+			if (plain.startX != fast.startX || plain.startY != fast.startY || plain.endX != fast.endX || plain.endY != fast.endY) {
+				printf("depth %d position %d: MISMATCH (%d,%d)->(%d,%d) instead of (%d,%d)->(%d,%d)\n", kDepths[d], p,
+					fast.startX, fast.startY, fast.endX, fast.endY, plain.startX, plain.startY, plain.endX, plain.endY);
+				failures++;
+			}
+
+			plainMillis += plain.millis;
+			fastMillis += fast.millis;
+			worstPlain = MAX(worstPlain, plain.millis);
+			worstFast = MAX(worstFast, fast.millis);
+			plainNodes += plain.nodes;
+			fastNodes += fast.nodes;
+			hits += fast.hits;
+		}
+
+		printf("depth %d  plain %8u nodes %9.2f ms (worst %8.2f)   fast %8u nodes %9.2f ms (worst %8.2f), %u hits   speedup %5.2fx\n",
+			kDepths[d], plainNodes, plainMillis, worstPlain, fastNodes, fastMillis, worstFast, hits,
+			fastMillis > 0 ? plainMillis / fastMillis : 0.0);
+	}
+
+	return failures ? 1 : 0;
+}
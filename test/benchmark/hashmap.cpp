@@ -0,0 +1,224 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Compares Common::HashMap against Common::FlatHashMap on key sets and
+// access patterns modelled after their heaviest users. Build and run it
+// with "make benchmark".
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/array.h"
+#include "common/flat-hashmap.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+#include <stdio.h>
+#include <time.h>
+
+namespace {
+
+enum {
+	kRounds = 200
+};
+
+typedef Common::Array<Common::String> StringList;
+
+/**
+ * Config keys: a few dozen case-insensitive keys, looked up far more often
+ * than they are written, with a fair share of misses for unset keys.
+ */
+void makeConfigKeys(StringList &keys, StringList &queries) {
+	static const char *const names[] = {
+		"gameid", "description", "language", "platform", "path", "extrapath",
+		"music_volume", "sfx_volume", "speech_volume", "mute", "speech_mute",
+		"subtitles", "talkspeed", "music_driver", "multi_midi", "native_mt32",
+		"enable_gs", "midi_gain", "fullscreen", "aspect_ratio", "gfx_mode",
+		"filtering", "render_mode", "autosave_period", "savepath", "themepath",
+		"gui_theme", "gui_language", "confirm_exit", "copy_protection",
+		"demo_mode", "boot_param", "save_slot", "originalsaveload", "enable_gs",
+		"output_rate", "opl_driver", "soundfont", "alsa_port", "versioninfo",
+		0
+	};
+
+	for (int i = 0; names[i]; ++i)
+		keys.push_back(names[i]);
+	for (int i = 0; i < 20; ++i)
+		keys.push_back(Common::String::format("custom_option_%d", i));
+
+	for (uint i = 0; i < keys.size(); ++i) {
+		queries.push_back(keys[i]);
+		Common::String upper = keys[i];
+		upper.toUppercase();
+		queries.push_back(upper);
+		queries.push_back(keys[i] + "_unset");
+	}
+}
+
+/**
+ * SearchSet members: a few thousand file names of the kinds found in game
+ * directories, queried case-insensitively, mostly successfully.
+ */
+void makeFileNames(StringList &keys, StringList &queries) {
+	for (int i = 0; i < 1000; ++i)
+		keys.push_back(Common::String::format("resource.%03d", i));
+	for (int i = 0; i < 800; ++i)
+		keys.push_back(Common::String::format("%d.scr", i));
+	for (int i = 0; i < 400; ++i)
+		keys.push_back(Common::String::format("VOICE%04d.WAV", i));
+
+	for (uint i = 0; i < keys.size(); ++i) {
+		Common::String query = keys[i];
+		if (i & 1)
+			query.toUppercase();
+		queries.push_back(query);
+		if ((i % 8) == 0)
+			queries.push_back(query + ".bak");
+	}
+}
+
+/**
+ * Wintermute script symbol tables: case-sensitive identifiers mapping to
+ * script values, with properties being set and removed while scripts run.
+ */
+void makeSymbols(StringList &keys, StringList &queries) {
+	static const char *const prefixes[] = { "Actor", "Entity", "Region", "Window", "Item", "Scene", 0 };
+	static const char *const names[] = { "X", "Y", "Active", "Name", "Caption", "Scale", "Alpha", "Walking", "Talking", "Direction", 0 };
+
+	for (int p = 0; prefixes[p]; ++p) {
+		for (int n = 0; names[n]; ++n)
+			keys.push_back(Common::String::format("%s%s", prefixes[p], names[n]));
+	}
+	for (int i = 0; i < 60; ++i)
+		keys.push_back(Common::String::format("var%d", i));
+
+	for (uint i = 0; i < keys.size(); ++i) {
+		queries.push_back(keys[i]);
+		queries.push_back(keys[(i * 7) % keys.size()]);
+	}
+}
+
+double elapsedMillis(clock_t start) {
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+template<class Map>
+double benchStrings(const StringList &keys, const StringList &queries, bool churn, uint &checksum) {
+	const clock_t start = clock();
+
+	for (int round = 0; round < kRounds; ++round) {
+		Map map;
+		for (uint i = 0; i < keys.size(); ++i)
+			map[keys[i]] = i;
+
+		for (int pass = 0; pass < 8; ++pass) {
+			for (uint i = 0; i < queries.size(); ++i) {
+				typename Map::const_iterator it = map.find(queries[i]);
+				if (it != map.end())
+					checksum += it->_value;
+			}
+
+			if (churn) {
+				for (uint i = pass; i < keys.size(); i += 8)
+					map.erase(keys[i]);
+				for (uint i = pass; i < keys.size(); i += 8)
+					map[keys[i]] = i;
+			}
+		}
+	}
+
+	return elapsedMillis(start);
+}
+
+/**
+ * SCI selector tables: dense small integer keys, looked up for every
+ * send in the interpreter.
+ */
+template<class Map>
+double benchSelectors(uint &checksum) {
+	const clock_t start = clock();
+
+	for (int round = 0; round < kRounds; ++round) {
+		Map map;
+		for (uint16 selector = 0; selector < 700; ++selector)
+			map[selector] = selector * 2 + 1;
+
+		for (int pass = 0; pass < 64; ++pass) {
+			for (uint i = 0; i < 1000; ++i) {
+				const uint16 selector = (uint16)((i * 37 + pass) % 900);
+				checksum += map.getVal(selector, 0);
+			}
+		}
+	}
+
+	return elapsedMillis(start);
+}
+
+void report(const char *workload, double hashMapMillis, double flatMillis) {
+	printf("%-24s HashMap %8.2f ms   FlatHashMap %8.2f ms   speedup %5.2fx\n",
+		workload, hashMapMillis, flatMillis, flatMillis > 0 ? hashMapMillis / flatMillis : 0.0);
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	typedef Common::HashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> NoCaseMap;
+	typedef Common::FlatHashMap<Common::String, uint, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatNoCaseMap;
+	typedef Common::HashMap<Common::String, uint> SymbolMap;
+	typedef Common::FlatHashMap<Common::String, uint> FlatSymbolMap;
+
+	// The checksums keep the compiler from optimizing the lookups away
+	// and must agree between both implementations.
+	uint checksum[2] = { 0, 0 };
+	double millis[2];
+
+	StringList keys, queries;
+	makeConfigKeys(keys, queries);
+	millis[0] = benchStrings<NoCaseMap>(keys, queries, false, checksum[0]);
+	millis[1] = benchStrings<FlatNoCaseMap>(keys, queries, false, checksum[1]);
+	report("config keys", millis[0], millis[1]);
+
+	keys.clear();
+	queries.clear();
+	makeFileNames(keys, queries);
+	millis[0] = benchStrings<NoCaseMap>(keys, queries, false, checksum[0]);
+	millis[1] = benchStrings<FlatNoCaseMap>(keys, queries, false, checksum[1]);
+	report("SearchSet members", millis[0], millis[1]);
+
+	millis[0] = benchSelectors<Common::HashMap<uint16, uint> >(checksum[0]);
+	millis[1] = benchSelectors<Common::FlatHashMap<uint16, uint> >(checksum[1]);
+	report("SCI selector tables", millis[0], millis[1]);
+
+	keys.clear();
+	queries.clear();
+	makeSymbols(keys, queries);
+	millis[0] = benchStrings<SymbolMap>(keys, queries, true, checksum[0]);
+	millis[1] = benchStrings<FlatSymbolMap>(keys, queries, true, checksum[1]);
+	report("Wintermute symbols", millis[0], millis[1]);
+
+	if (checksum[0] != checksum[1]) {
+		printf("Checksum mismatch: %u != %u\n", checksum[0], checksum[1]);
+		return 1;
+	}
+
+	return 0;
+}
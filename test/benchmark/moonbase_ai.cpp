@@ -0,0 +1,202 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Runs the A* search of the Moonbase Commander AI on a fixed set of hub and
+// target positions, and reports the expanded nodes per second and the time
+// until a move is selected. Build and run it with "make benchmark".
+//
+// The real Traveller needs the game scripts to simulate launches, so the
+// hub hopping is modelled here by a plain ballistic fan over a map with a
+// few lakes, which hubs can not land in.
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "scumm/he/moonbase/ai_tree.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+namespace {
+
+using Scumm::IContainedObject;
+
+enum {
+	kMapSize = 6000,
+	kNumAngles = 12,
+	kNumPowers = 3,
+	kMaxHop = 340,
+	// Close enough for a shot at the target
+	kTargetRadius = 200,
+	kMaxDepth = 10,
+	kRounds = 5,
+	// SEARCH_BUDGET of the AI
+	kFrameBudget = 8
+};
+
+struct Lake {
+	int x, y, radius;
+};
+
+const Lake kLakes[] = {
+	{ 1500, 1500, 450 },
+	{ 3000, 2400, 600 },
+	{ 4200, 4000, 500 },
+	{ 2000, 4200, 400 },
+	{ 4800, 1200, 350 }
+};
+
+struct Position {
+	int hubX, hubY;
+	int targetX, targetY;
+};
+
+const Position kPositions[] = {
+	{  300,  300, 2300, 2900 },
+	{ 5600,  400, 3500, 2900 },
+	{  500, 5500, 4400, 4600 },
+	{ 5700, 5600, 1200, 1100 },
+	{ 2900,  200, 3000, 5800 },
+	{  200, 3000, 5800, 3100 },
+	{ 1000, 2400, 3600, 2300 },
+	{ 4700, 4900, 1700, 3800 },
+	{ 3100, 1500, 3100, 3300 },
+	{ 2400, 5200, 5100,  900 }
+};
+
+bool isWater(int x, int y) {
+	for (int i = 0; i < (int)ARRAYSIZE(kLakes); i++) {
+		const int dx = x - kLakes[i].x;
+		const int dy = y - kLakes[i].y;
+		if (dx * dx + dy * dy < kLakes[i].radius * kLakes[i].radius)
+			return true;
+	}
+
+	return false;
+}
+
+/** A hub, which can launch new hubs in a fan of angles and powers. */
+class Hub : public IContainedObject {
+public:
+	Hub(int x, int y, int targetX, int targetY, float g)
+		: IContainedObject(g), _x(x), _y(y), _targetX(targetX), _targetY(targetY) {}
+
+	virtual IContainedObject *duplicate() { return new Hub(*this); }
+
+	virtual int numChildrenToGen() { return kNumAngles * kNumPowers; }
+
+	virtual IContainedObject *createChildObj(int index, int &completionFlag) {
+		completionFlag = 1;
+
+		const double direct = atan2((double)(_targetY - _y), (double)(_targetX - _x));
+		const int step = index / kNumPowers;
+		const double offset = 0.25 * ((step + 1) >> 1) * ((step & 1) ? 1 : -1);
+		const double distance = kMaxHop * (1.0 - 0.25 * (index % kNumPowers));
+
+		const int x = _x + (int)(cos(direct + offset) * distance);
+		const int y = _y + (int)(sin(direct + offset) * distance);
+		if (x < 0 || y < 0 || x >= kMapSize || y >= kMapSize || isWater(x, y))
+			return NULL;
+
+		return new Hub(x, y, _targetX, _targetY, getG() + 1);
+	}
+
+	virtual int checkSuccess() { return distanceToTarget() < kTargetRadius; }
+
+	virtual float calcT() {
+		if (checkSuccess())
+			return Scumm::SUCCESS;
+		return getG() + calcH();
+	}
+
+protected:
+	virtual float calcH() { return distanceToTarget() / kMaxHop; }
+
+private:
+	float distanceToTarget() const {
+		const double dx = _targetX - _x;
+		const double dy = _targetY - _y;
+		return (float)sqrt(dx * dx + dy * dy);
+	}
+
+	int _x, _y;
+	int _targetX, _targetY;
+};
+
+/** The clock of the AI, without a player time limit. */
+class BenchmarkClock : public Scumm::SearchClock {
+public:
+	virtual int getPlayerMaxTime() { return 0; }
+	virtual int getTimerValue(int timerNum) { return 0; }
+	virtual uint32 getMillis() { return (uint32)((double)clock() * 1000.0 / CLOCKS_PER_SEC); }
+};
+
+double elapsedMillis(clock_t start) {
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC;
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	BenchmarkClock searchClock;
+
+	uint32 totalNodes = 0;
+	double totalMillis = 0;
+	double worstMillis = 0;
+	uint32 totalFrames = 0;
+
+	for (int p = 0; p < (int)ARRAYSIZE(kPositions); p++) {
+		const Position &pos = kPositions[p];
+
+		for (int round = 0; round < kRounds; round++) {
+			Scumm::Tree tree(new Hub(pos.hubX, pos.hubY, pos.targetX, pos.targetY, 0), kMaxDepth, &searchClock);
+
+			const clock_t start = clock();
+			Scumm::Node *result = tree.aStarSearch_singlePassInit();
+			uint32 frames = 0;
+			while (!result) {
+				result = tree.aStarSearch_singlePass(kFrameBudget);
+				frames++;
+			}
+			const double millis = elapsedMillis(start);
+
+			totalNodes += tree.getExpandedNodes();
+			totalMillis += millis;
+			totalFrames += frames;
+			if (millis > worstMillis)
+				worstMillis = millis;
+
+			// Like the AI, take the best node found if the target is out of reach
+			if (!round)
+				printf("position %d: %6u nodes  %3d hops  %8.3f ms  %3u frames%s\n", p, tree.getExpandedNodes(),
+					result->getDepth(), millis, frames, result->getContainedObject()->checkSuccess() ? "" : "   (not reached)");
+		}
+	}
+
+	const int searches = ARRAYSIZE(kPositions) * kRounds;
+	printf("%.0f nodes/s   move selection: mean %.3f ms, worst %.3f ms, %.1f frames at %d ms per frame\n",
+		totalMillis > 0 ? totalNodes * 1000.0 / totalMillis : 0.0, totalMillis / searches, worstMillis,
+		(double)totalFrames / searches, kFrameBudget);
+
+	Scumm::Node::freePool();
+	return 0;
+}
@@ -0,0 +1,157 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// Compares the vector and the table based YUV to RGB conversions of
+// Graphics::YUVToRGBManager, and checks that their output is identical.
+// Build and run it with "make benchmark".
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/util.h"
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+namespace {
+
+enum {
+	kFrames = 50,
+	// Not a multiple of the vector width, so the tail code is checked too
+	kWidth = 644,
+	kHeight = 480
+};
+
+enum Mode {
+	kMode444,
+	kMode420,
+	kMode410
+};
+
+struct Planes {
+	byte *y, *u, *v;
+	int yPitch, uvPitch;
+};
+
+void fillPlanes(Planes &planes) {
+	// Random noise hits the clamping on every channel. The chroma planes
+	// have the extra row and column convert410 reads from.
+	planes.yPitch = kWidth + 16;
+	planes.uvPitch = kWidth + 16;
+	const int ySize = planes.yPitch * kHeight;
+	const int uvSize = planes.uvPitch * (kHeight + 1);
+
+	planes.y = (byte *)malloc(ySize);
+	planes.u = (byte *)malloc(uvSize);
+	planes.v = (byte *)malloc(uvSize);
+
+	srand(1234);
+	for (int i = 0; i < ySize; i++)
+		planes.y[i] = rand() & 0xFF;
+	for (int i = 0; i < uvSize; i++) {
+		planes.u[i] = rand() & 0xFF;
+		planes.v[i] = rand() & 0xFF;
+	}
+}
+
+double convert(Graphics::Surface &dst, Mode mode, Graphics::YUVToRGBManager::LuminanceScale scale, const Planes &planes) {
+	const clock_t start = clock();
+
+	for (int frame = 0; frame < kFrames; frame++) {
+		switch (mode) {
+		case kMode444:
+			YUVToRGBMan.convert444(&dst, scale, planes.y, planes.u, planes.v, kWidth, kHeight, planes.yPitch, planes.uvPitch);
+			break;
+		case kMode420:
+			YUVToRGBMan.convert420(&dst, scale, planes.y, planes.u, planes.v, kWidth, kHeight, planes.yPitch, planes.uvPitch);
+			break;
+		case kMode410:
+			YUVToRGBMan.convert410(&dst, scale, planes.y, planes.u, planes.v, kWidth, kHeight, planes.yPitch, planes.uvPitch);
+			break;
+		}
+	}
+
+	return (double)(clock() - start) * 1000.0 / CLOCKS_PER_SEC / kFrames;
+}
+
+} // End of anonymous namespace
+
+int main(int argc, char *argv[]) {
+	static const char *const modeNames[] = { "444", "420", "410" };
+	static const char *const scaleNames[] = { "full", "ITU" };
+
+	const struct {
+		const char *name;
+		Graphics::PixelFormat format;
+	} formats[] = {
+		{ "RGB565", Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0) },
+		{ "ARGB1555", Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15) },
+		{ "RGBA8888", Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0) },
+		{ "XRGB8888", Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0) }
+	};
+
+	if (!YUVToRGBMan.hasSIMD()) {
+		printf("No vector conversion in this build\n");
+		return 0;
+	}
+
+	Planes planes;
+	fillPlanes(planes);
+
+	int failures = 0;
+	for (int f = 0; f < (int)ARRAYSIZE(formats); f++) {
+		Graphics::Surface table, simd;
+		table.create(kWidth, kHeight, formats[f].format);
+		simd.create(kWidth, kHeight, formats[f].format);
+
+		for (int m = kMode444; m <= kMode410; m++) {
+			for (int s = 0; s < 2; s++) {
+				const Graphics::YUVToRGBManager::LuminanceScale scale = s ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+				YUVToRGBMan.setUseSIMD(false);
+				const double tableMillis = convert(table, (Mode)m, scale, planes);
+				YUVToRGBMan.setUseSIMD(true);
+				const double simdMillis = convert(simd, (Mode)m, scale, planes);
+
+				const bool same = memcmp(table.getPixels(), simd.getPixels(), table.pitch * table.h) == 0;
+				if (!same)
+					failures++;
+
+				printf("%-8s %s %-4s  table %6.3f ms   vector %6.3f ms   speedup %5.2fx%s\n",
+					formats[f].name, modeNames[m], scaleNames[s], tableMillis, simdMillis,
+					simdMillis > 0 ? tableMillis / simdMillis : 0.0, same ? "" : "   MISMATCH");
+			}
+		}
+
+		table.free();
+		simd.free();
+	}
+
+	free(planes.y);
+	free(planes.u);
+	free(planes.v);
+
+	return failures ? 1 : 0;
+}
@@ -0,0 +1,152 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/flat-hashmap.h"
+#include "common/hash-str.h"
+
+class FlatHashMapTestSuite : public CxxTest::TestSuite
+{
+	typedef Common::FlatHashMap<Common::String, Common::String, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> FlatStringMap;
+
+	public:
+	void test_empty_clear() {
+		Common::FlatHashMap<int, int> container;
+		TS_ASSERT(container.empty());
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(!container.empty());
+		container.clear();
+		TS_ASSERT(container.empty());
+
+		FlatStringMap container2;
+		TS_ASSERT(container2.empty());
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(!container2.empty());
+		container2.clear(true);
+		TS_ASSERT(container2.empty());
+		TS_ASSERT_EQUALS(container2.begin(), container2.end());
+	}
+
+	void test_contains() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		TS_ASSERT(container.contains(0));
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT(!container.contains(17));
+		TS_ASSERT(!container.contains(-1));
+
+		FlatStringMap container2;
+		container2["foo"] = "bar";
+		container2["quux"] = "blub";
+		TS_ASSERT(container2.contains("foo"));
+		TS_ASSERT(container2.contains("QUUX"));
+		TS_ASSERT(!container2.contains("bar"));
+		TS_ASSERT(!container2.contains("asdf"));
+	}
+
+	void test_add_remove() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = 33;
+		container[2] = 45;
+		container[3] = 12;
+		container[4] = 96;
+		TS_ASSERT(container.contains(1));
+		container.erase(1);
+		TS_ASSERT(!container.contains(1));
+		container[1] = 42;
+		TS_ASSERT(container.contains(1));
+		TS_ASSERT_EQUALS(container[1], 42);
+		container.erase(container.find(0));
+		container.erase(1);
+		container.erase(container.find(2));
+		container.erase(3);
+		TS_ASSERT(!container.empty());
+		container.erase(container.find(4));
+		TS_ASSERT(container.empty());
+	}
+
+	void test_lookup_with_default() {
+		Common::FlatHashMap<int, int> container;
+		container[0] = 17;
+		container[1] = -1;
+		container[2] = 45;
+
+		// We take a const ref now to ensure that the map
+		// is not modified by getVal.
+		const Common::FlatHashMap<int, int> &containerRef = container;
+
+		TS_ASSERT_EQUALS(containerRef.getVal(0), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(1), -1);
+		TS_ASSERT_EQUALS(containerRef.getVal(17), 0);
+		TS_ASSERT_EQUALS(containerRef.getVal(0, -10), 17);
+		TS_ASSERT_EQUALS(containerRef.getVal(17, -10), -10);
+		TS_ASSERT_EQUALS(containerRef.find(17), containerRef.end());
+		TS_ASSERT_EQUALS(containerRef.size(), 3u);
+	}
+
+	void test_grow_and_copy() {
+		// Keys which only differ in their high bits must not collide
+		Common::FlatHashMap<int, int> map1;
+		for (int i = 0; i < 1000; ++i)
+			map1.setVal(i << 16, i);
+		TS_ASSERT_EQUALS(map1.size(), 1000u);
+		TS_ASSERT(map1.capacity() * 7 >= map1.size() * 8);
+
+		Common::FlatHashMap<int, int> map2(map1);
+		for (int i = 0; i < 1000; i += 2)
+			map1.erase(i << 16);
+
+		for (int i = 0; i < 1000; ++i) {
+			TS_ASSERT_EQUALS(map1.contains(i << 16), (i & 1) != 0);
+			TS_ASSERT_EQUALS(map2.getVal(i << 16, -1), i);
+		}
+
+		map2 = map1;
+		TS_ASSERT_EQUALS(map2.size(), 500u);
+		TS_ASSERT_EQUALS(map2[999 << 16], 999);
+	}
+
+	void test_erase_churn() {
+		// Erasing and inserting over and over must reuse the erased
+		// slots instead of growing the map without bound.
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 10000; ++i) {
+			container[i] = i;
+			if (i >= 8)
+				container.erase(i - 8);
+		}
+		TS_ASSERT_EQUALS(container.size(), 8u);
+		TS_ASSERT(container.capacity() <= 32);
+		for (int i = 10000 - 8; i < 10000; ++i)
+			TS_ASSERT_EQUALS(container[i], i);
+	}
+
+	void test_iterator() {
+		Common::FlatHashMap<int, int> container;
+		for (int i = 0; i < 40; ++i)
+			container[i] = i * 3;
+
+		// Erasing the current element must not disturb the iteration
+		int visited = 0;
+		Common::FlatHashMap<int, int>::iterator i;
+		for (i = container.begin(); i != container.end(); ++i) {
+			TS_ASSERT_EQUALS(i->_value, i->_key * 3);
+			if (i->_key & 1)
+				container.erase(i);
+			++visited;
+		}
+		TS_ASSERT_EQUALS(visited, 40);
+		TS_ASSERT_EQUALS(container.size(), 20u);
+
+		int found = 0;
+		Common::FlatHashMap<int, int>::const_iterator j;
+		const Common::FlatHashMap<int, int> &containerRef = container;
+		for (j = containerRef.begin(); j != containerRef.end(); ++j) {
+			TS_ASSERT_EQUALS(j->_key & 1, 0);
+			++found;
+		}
+		TS_ASSERT_EQUALS(found, 20);
+	}
+};
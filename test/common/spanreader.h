@@ -0,0 +1,77 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/spanreader.h"
+#include "common/substream.h"
+
+class SpanReaderTestSuite : public CxxTest::TestSuite {
+	static const byte _contents[10];
+
+	void readAll(Common::ReadStream &stream) {
+		Common::SpanReader reader(stream);
+
+		TS_ASSERT_EQUALS(reader.readByte(), 0x01);
+		TS_ASSERT_EQUALS(reader.readUint16LE(), 0x0302);
+		TS_ASSERT_EQUALS(reader.readUint32BE(), 0x04050607U);
+		TS_ASSERT_EQUALS(reader.readSint16BE(), (int16)0x0809);
+		TS_ASSERT(!reader.eos());
+
+		// Only one byte left
+		TS_ASSERT_EQUALS(reader.readUint16LE() & 0xFF, 0xFF);
+		TS_ASSERT(reader.eos());
+	}
+
+public:
+	void test_memory_stream() {
+		Common::MemoryReadStream ms(_contents, sizeof(_contents));
+		readAll(ms);
+		TS_ASSERT(ms.eos());
+		TS_ASSERT_EQUALS(ms.pos(), (int32)sizeof(_contents));
+	}
+
+	void test_window_boundaries() {
+		// A buffer size of 3 makes most reads straddle two windows
+		Common::ReadStream *stream = Common::wrapBufferedReadStream(new Common::MemoryReadStream(_contents, sizeof(_contents)), 3, DisposeAfterUse::YES);
+		readAll(*stream);
+		TS_ASSERT(stream->eos());
+		delete stream;
+	}
+
+	void test_no_window() {
+		// SeekableSubReadStream offers no window and is read through read()
+		Common::MemoryReadStream ms(_contents, sizeof(_contents));
+		Common::SeekableSubReadStream sub(&ms, 0, sizeof(_contents));
+		readAll(sub);
+		TS_ASSERT(sub.eos());
+	}
+
+	void test_high_bit() {
+		// 32 bit values with the top bit set, read through read() as two halves
+		static const byte data[8] = { 0xFE, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE };
+		Common::MemoryReadStream ms(data, sizeof(data));
+		Common::SeekableSubReadStream sub(&ms, 0, sizeof(data));
+		Common::SpanReader reader(sub);
+		TS_ASSERT_EQUALS(reader.readUint32LE(), 0xFFFFFFFEU);
+		TS_ASSERT_EQUALS(reader.readUint32BE(), 0xFFFFFFFEU);
+	}
+
+	void test_sync_and_skip() {
+		Common::MemoryReadStream ms(_contents, sizeof(_contents));
+		{
+			Common::SpanReader reader(ms);
+			TS_ASSERT(reader.skip(3));
+			TS_ASSERT_EQUALS(reader.readByte(), 0x04);
+			TS_ASSERT_EQUALS(ms.pos(), 0);
+			reader.sync();
+			TS_ASSERT_EQUALS(ms.pos(), 4);
+
+			byte buf[4];
+			TS_ASSERT_EQUALS(reader.read(buf, 4), 4U);
+			TS_ASSERT_EQUALS(buf[3], 0x08);
+			TS_ASSERT(!reader.skip(10));
+		}
+		TS_ASSERT_EQUALS(ms.pos(), (int32)sizeof(_contents));
+	}
+};
+
+const byte SpanReaderTestSuite::_contents[10] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0xFF };
@@ -0,0 +1,423 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/archive.h"
+#include "common/memstream.h"
+#include "common/unzip.h"
+
+#include "backends/fs/abstract-fs.h"
+
+/**
+ * A zip archive holding "stored.txt", 100 stored bytes with value (i * 7),
+ * and "deflated.bin", 65536 deflated bytes with value (i % 251).
+ */
+static const byte zipTestArchive[] = {
+		0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x21, 0x00, 0x85, 0x3e,
+		0x1d, 0x82, 0x64, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x73, 0x74,
+		0x6f, 0x72, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74, 0x00, 0x07, 0x0e, 0x15, 0x1c, 0x23, 0x2a, 0x31,
+		0x38, 0x3f, 0x46, 0x4d, 0x54, 0x5b, 0x62, 0x69, 0x70, 0x77, 0x7e, 0x85, 0x8c, 0x93, 0x9a, 0xa1,
+		0xa8, 0xaf, 0xb6, 0xbd, 0xc4, 0xcb, 0xd2, 0xd9, 0xe0, 0xe7, 0xee, 0xf5, 0xfc, 0x03, 0x0a, 0x11,
+		0x18, 0x1f, 0x26, 0x2d, 0x34, 0x3b, 0x42, 0x49, 0x50, 0x57, 0x5e, 0x65, 0x6c, 0x73, 0x7a, 0x81,
+		0x88, 0x8f, 0x96, 0x9d, 0xa4, 0xab, 0xb2, 0xb9, 0xc0, 0xc7, 0xce, 0xd5, 0xdc, 0xe3, 0xea, 0xf1,
+		0xf8, 0xff, 0x06, 0x0d, 0x14, 0x1b, 0x22, 0x29, 0x30, 0x37, 0x3e, 0x45, 0x4c, 0x53, 0x5a, 0x61,
+		0x68, 0x6f, 0x76, 0x7d, 0x84, 0x8b, 0x92, 0x99, 0xa0, 0xa7, 0xae, 0xb5, 0x50, 0x4b, 0x03, 0x04,
+		0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0xd3, 0x50, 0xaa, 0x7f, 0x3d, 0x02,
+		0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x64, 0x65, 0x66, 0x6c, 0x61, 0x74,
+		0x65, 0x64, 0x2e, 0x62, 0x69, 0x6e, 0xed, 0xcf, 0x43, 0x82, 0x10, 0x00, 0x00, 0x00, 0xc0, 0xcd,
+		0xb6, 0xb9, 0xd9, 0xb6, 0x6d, 0xdb, 0xb6, 0x6d, 0xd7, 0x66, 0xdb, 0xb6, 0x6d, 0xdb, 0xb6, 0x6d,
+		0x5b, 0xa7, 0x8e, 0x7d, 0x62, 0xe6, 0x07, 0x13, 0x10, 0x2c, 0x78, 0x88, 0x90, 0xa1, 0x42, 0x87,
+		0x09, 0x1b, 0x2e, 0x7c, 0x84, 0x88, 0x91, 0x22, 0x47, 0x89, 0x1a, 0x2d, 0x7a, 0x8c, 0x98, 0xb1,
+		0x62, 0xc7, 0x89, 0x1b, 0x2f, 0x7e, 0x82, 0x84, 0x89, 0x12, 0x07, 0x26, 0x49, 0x9a, 0x2c, 0x79,
+		0x8a, 0x94, 0xa9, 0x52, 0xa7, 0x49, 0x9b, 0x2e, 0x7d, 0x86, 0x8c, 0x99, 0x32, 0x67, 0xc9, 0x9a,
+		0x2d, 0x7b, 0x8e, 0x9c, 0xb9, 0x72, 0xe7, 0xc9, 0x9b, 0x2f, 0x7f, 0x81, 0x82, 0x85, 0x0a, 0x17,
+		0x29, 0x5a, 0xac, 0x78, 0x89, 0x92, 0xa5, 0x4a, 0x97, 0x29, 0x5b, 0xae, 0x7c, 0x85, 0x8a, 0x95,
+		0x2a, 0x57, 0xa9, 0x5a, 0xad, 0x7a, 0x8d, 0x9a, 0xb5, 0x6a, 0xd7, 0xa9, 0x5b, 0xaf, 0x7e, 0x83,
+		0x86, 0x8d, 0x1a, 0x37, 0x69, 0xda, 0xac, 0x79, 0x8b, 0x96, 0xad, 0x5a, 0xb7, 0x69, 0xdb, 0xae,
+		0x7d, 0x87, 0x8e, 0x9d, 0x3a, 0x77, 0xe9, 0xda, 0xad, 0x7b, 0x8f, 0x9e, 0xbd, 0x7a, 0xf7, 0xe9,
+		0xdb, 0xaf, 0xff, 0x80, 0x81, 0x83, 0x06, 0x0f, 0x19, 0x3a, 0x2c, 0x68, 0xf8, 0x88, 0x91, 0xa3,
+		0x46, 0x8f, 0x19, 0x3b, 0x6e, 0xfc, 0x84, 0x89, 0x93, 0x26, 0x4f, 0x99, 0x3a, 0x6d, 0xfa, 0x8c,
+		0x99, 0xb3, 0x66, 0xcf, 0x99, 0x3b, 0x6f, 0xfe, 0x82, 0x85, 0x8b, 0x16, 0x2f, 0x59, 0xba, 0x6c,
+		0xf9, 0x8a, 0x95, 0xab, 0x56, 0xaf, 0x59, 0xbb, 0x6e, 0xfd, 0x86, 0x8d, 0x9b, 0x36, 0x6f, 0xd9,
+		0xba, 0x6d, 0xfb, 0x8e, 0x9d, 0xbb, 0x76, 0xef, 0xd9, 0xbb, 0x6f, 0xff, 0x81, 0x83, 0x87, 0x0e,
+		0x1f, 0x39, 0x7a, 0xec, 0xf8, 0x89, 0x93, 0xa7, 0x4e, 0x9f, 0x39, 0x7b, 0xee, 0xfc, 0x85, 0x8b,
+		0x97, 0x2e, 0x5f, 0xb9, 0x7a, 0xed, 0xfa, 0x8d, 0x9b, 0xb7, 0x6e, 0xdf, 0xb9, 0x7b, 0xef, 0xfe,
+		0x83, 0x87, 0x8f, 0x1e, 0x3f, 0x79, 0xfa, 0xec, 0xf9, 0x8b, 0x97, 0xaf, 0x5e, 0xbf, 0x79, 0xfb,
+		0xee, 0xfd, 0x87, 0x8f, 0x9f, 0x3e, 0x7f, 0xf9, 0xfa, 0xed, 0xfb, 0x8f, 0x9f, 0xbf, 0x7e, 0xff,
+		0xf9, 0x1b, 0xa0, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae,
+		0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xae, 0xfe,
+		0xbf, 0xfe, 0x0f, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x21, 0x00, 0x85, 0x3e, 0x1d, 0x82, 0x64, 0x00, 0x00, 0x00, 0x64, 0x00, 0x00, 0x00, 0x0a,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00,
+		0x00, 0x73, 0x74, 0x6f, 0x72, 0x65, 0x64, 0x2e, 0x74, 0x78, 0x74, 0x50, 0x4b, 0x01, 0x02, 0x14,
+		0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0xd3, 0x50, 0xaa, 0x7f, 0x3d,
+		0x02, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x80, 0x01, 0x8c, 0x00, 0x00, 0x00, 0x64, 0x65, 0x66, 0x6c, 0x61, 0x74, 0x65,
+		0x64, 0x2e, 0x62, 0x69, 0x6e, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00, 0x02,
+		0x00, 0x72, 0x00, 0x00, 0x00, 0xf3, 0x02, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const uint32 zipTestDeflatedSize = 65536;
+
+/**
+ * A zip archive holding "large.bin", 1100000 deflated bytes with value
+ * ((i >> 12) + (i >> 20)), large enough to be streamed.
+ */
+static const byte zipTestLargeArchive[] = {
+		0x50, 0x4b, 0x03, 0x04, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21, 0x00, 0xd2, 0x01,
+		0xd5, 0x57, 0x7a, 0x06, 0x00, 0x00, 0xe0, 0xc8, 0x10, 0x00, 0x09, 0x00, 0x00, 0x00, 0x6c, 0x61,
+		0x72, 0x67, 0x65, 0x2e, 0x62, 0x69, 0x6e, 0xed, 0xc1, 0x03, 0x1f, 0x20, 0x84, 0x01, 0xc0, 0xd1,
+		0xba, 0xbb, 0x0e, 0xd9, 0xb6, 0x6b, 0x69, 0xd9, 0xb6, 0xb1, 0x6a, 0xab, 0x96, 0x96, 0x6d, 0xdb,
+		0xb6, 0xbd, 0xe5, 0x65, 0x2c, 0x2e, 0x73, 0x2d, 0x5b, 0x5b, 0xb6, 0x6d, 0x7c, 0x8f, 0xff, 0xef,
+		0xbd, 0x37, 0xdc, 0x70, 0x00, 0x00, 0x00, 0x40, 0xdd, 0xf0, 0x00, 0x00, 0x00, 0x40, 0xde, 0x00,
+		0x00, 0x00, 0x00, 0x20, 0x6f, 0x20, 0x00, 0x00, 0x00, 0x90, 0x37, 0x08, 0x00, 0x00, 0x00, 0xc8,
+		0x1b, 0x01, 0x00, 0x00, 0x00, 0xc8, 0x1b, 0x0c, 0x00, 0x00, 0x00, 0xe4, 0x0d, 0x01, 0x00, 0x00,
+		0x00, 0xf2, 0x86, 0x02, 0x00, 0x00, 0x00, 0x79, 0xc3, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x11, 0x01,
+		0x00, 0x00, 0x80, 0xbc, 0x91, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x91, 0x01, 0x00, 0x00, 0x80, 0xbc,
+		0x51, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x51, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xd1, 0x00, 0x00, 0x00,
+		0x80, 0xbc, 0xd1, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x31, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x31, 0x01,
+		0x00, 0x00, 0x80, 0xbc, 0xb1, 0x00, 0x00, 0x00, 0x80, 0xbc, 0xb1, 0x01, 0x00, 0x00, 0x80, 0xbc,
+		0x71, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x71, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xf1, 0x00, 0x00, 0x00,
+		0x80, 0xbc, 0xf1, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x09, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x09, 0x01,
+		0x00, 0x00, 0x80, 0xbc, 0x89, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x89, 0x01, 0x00, 0x00, 0x80, 0xbc,
+		0x49, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x49, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xc9, 0x00, 0x00, 0x00,
+		0x80, 0xbc, 0xc9, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x29, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x29, 0x01,
+		0x00, 0x00, 0x80, 0xbc, 0xa9, 0x00, 0x00, 0x00, 0x80, 0xbc, 0xa9, 0x01, 0x00, 0x00, 0x80, 0xbc,
+		0x69, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x69, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xe9, 0x00, 0x00, 0x00,
+		0x80, 0xbc, 0xe9, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x19, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x19, 0x01,
+		0x00, 0x00, 0x80, 0xbc, 0x3f, 0x00, 0x00, 0x00, 0x00, 0x79, 0x33, 0x01, 0x00, 0x00, 0x00, 0x79,
+		0x33, 0x03, 0x00, 0x00, 0x00, 0x79, 0xb3, 0x00, 0x00, 0x00, 0x00, 0x79, 0xb3, 0x02, 0x00, 0x00,
+		0x00, 0x79, 0xb3, 0x01, 0x00, 0x00, 0x00, 0x79, 0x7f, 0x04, 0x00, 0x00, 0x00, 0xf2, 0x66, 0x07,
+		0x00, 0x00, 0x00, 0xf2, 0xe6, 0x00, 0x00, 0x00, 0x00, 0xf2, 0xe6, 0x04, 0x00, 0x00, 0x00, 0xf2,
+		0xe6, 0x02, 0x00, 0x00, 0x00, 0xf2, 0xe6, 0x06, 0x00, 0x00, 0x00, 0xf2, 0xe6, 0x01, 0x00, 0x00,
+		0x00, 0xf2, 0xe6, 0x05, 0x00, 0x00, 0x00, 0xf2, 0xe6, 0x03, 0x00, 0x00, 0x00, 0xf2, 0xe6, 0x07,
+		0x00, 0x00, 0x00, 0xf2, 0x16, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x16, 0x04, 0x00, 0x00, 0x00, 0xf2,
+		0x16, 0x02, 0x00, 0x00, 0x00, 0xf2, 0x16, 0x06, 0x00, 0x00, 0x00, 0xf2, 0x16, 0x01, 0x00, 0x00,
+		0x00, 0xf2, 0x16, 0x05, 0x00, 0x00, 0x00, 0xf2, 0x16, 0x03, 0x00, 0x00, 0x00, 0xf2, 0x16, 0x07,
+		0x00, 0x00, 0x00, 0xf2, 0x96, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x96, 0x04, 0x00, 0x00, 0x00, 0xf2,
+		0x96, 0x02, 0x00, 0x00, 0x00, 0xf2, 0x96, 0x06, 0x00, 0x00, 0x00, 0xf2, 0x96, 0x01, 0x00, 0x00,
+		0x00, 0xf2, 0x96, 0x05, 0x00, 0x00, 0x00, 0xf2, 0x96, 0x03, 0x00, 0x00, 0x00, 0xf2, 0x96, 0x07,
+		0x00, 0x00, 0x00, 0xf2, 0x56, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x56, 0x04, 0x00, 0x00, 0x00, 0xf2,
+		0x56, 0x02, 0x00, 0x00, 0x00, 0xf2, 0x56, 0x06, 0x00, 0x00, 0x00, 0xf2, 0x56, 0x01, 0x00, 0x00,
+		0x00, 0xf2, 0x56, 0x05, 0x00, 0x00, 0x00, 0xf2, 0x56, 0x03, 0x00, 0x00, 0x00, 0xf2, 0x56, 0x07,
+		0x00, 0x00, 0x00, 0xf2, 0xd6, 0x00, 0x00, 0x00, 0x00, 0xf2, 0xfe, 0x04, 0x00, 0x00, 0x00, 0xe4,
+		0xad, 0x09, 0x00, 0x00, 0x00, 0xe4, 0xad, 0x05, 0x00, 0x00, 0x00, 0xe4, 0xad, 0x0d, 0x00, 0x00,
+		0x00, 0xe4, 0xfd, 0x19, 0x00, 0x00, 0x00, 0xc8, 0xfb, 0x0b, 0x00, 0x00, 0x00, 0x90, 0xb7, 0x0e,
+		0x00, 0x00, 0x00, 0x90, 0xb7, 0x2e, 0x00, 0x00, 0x00, 0x90, 0xb7, 0x1e, 0x00, 0x00, 0x00, 0x90,
+		0xf7, 0x57, 0x00, 0x00, 0x00, 0x20, 0x6f, 0x7d, 0x00, 0x00, 0x00, 0x20, 0x6f, 0x03, 0x00, 0x00,
+		0x00, 0x20, 0x6f, 0x43, 0x00, 0x00, 0x00, 0x20, 0x6f, 0x23, 0x00, 0x00, 0x00, 0x20, 0x6f, 0x63,
+		0x00, 0x00, 0x00, 0x20, 0xef, 0x6f, 0x00, 0x00, 0x00, 0x40, 0xde, 0x26, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xa6, 0x00, 0x00, 0x00, 0x40, 0xde, 0x66, 0x00, 0x00, 0x00, 0x40, 0xde, 0xe6, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x16, 0x00, 0x00, 0x00, 0x40, 0xde, 0x96, 0x00, 0x00, 0x00, 0x40, 0xde, 0x56,
+		0x00, 0x00, 0x00, 0x40, 0xde, 0xd6, 0x00, 0x00, 0x00, 0x40, 0xde, 0x36, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xb6, 0x00, 0x00, 0x00, 0x40, 0xde, 0x76, 0x00, 0x00, 0x00, 0x40, 0xde, 0xf6, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x0e, 0x00, 0x00, 0x00, 0x40, 0xde, 0x8e, 0x00, 0x00, 0x00, 0x40, 0xde, 0x4e,
+		0x00, 0x00, 0x00, 0x40, 0xde, 0xce, 0x00, 0x00, 0x00, 0x40, 0xde, 0x2e, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xae, 0x00, 0x00, 0x00, 0x40, 0xde, 0x6e, 0x00, 0x00, 0x00, 0x40, 0xde, 0xee, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x1e, 0x00, 0x00, 0x00, 0x40, 0xde, 0x9e, 0x00, 0x00, 0x00, 0x40, 0xde, 0x5e,
+		0x00, 0x00, 0x00, 0x40, 0xde, 0xde, 0x00, 0x00, 0x00, 0x40, 0xde, 0x3e, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xbe, 0x00, 0x00, 0x00, 0x40, 0xde, 0x7e, 0x00, 0x00, 0x00, 0x40, 0xde, 0xfe, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x01, 0x00, 0x00, 0x00, 0x40, 0xde, 0x81, 0x00, 0x00, 0x00, 0x40, 0xde, 0x41,
+		0x00, 0x00, 0x00, 0x40, 0xde, 0xc1, 0x00, 0x00, 0x00, 0x40, 0xde, 0x21, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xa1, 0x00, 0x00, 0x00, 0x40, 0xde, 0x61, 0x00, 0x00, 0x00, 0x40, 0xde, 0xe1, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x11, 0x00, 0x00, 0x00, 0x40, 0xde, 0x91, 0x00, 0x00, 0x00, 0x40, 0xde, 0x51,
+		0x00, 0x00, 0x00, 0x40, 0xde, 0xd1, 0x00, 0x00, 0x00, 0x40, 0xde, 0x31, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xb1, 0x00, 0x00, 0x00, 0x40, 0xde, 0x71, 0x00, 0x00, 0x00, 0x40, 0xde, 0xf1, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x09, 0x00, 0x00, 0x00, 0x40, 0xde, 0x89, 0x00, 0x00, 0x00, 0x40, 0xde, 0x49,
+		0x00, 0x00, 0x00, 0x40, 0xde, 0xc9, 0x00, 0x00, 0x00, 0x40, 0xde, 0x29, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xa9, 0x00, 0x00, 0x00, 0x40, 0xde, 0x69, 0x00, 0x00, 0x00, 0x40, 0xde, 0xe9, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x19, 0x00, 0x00, 0x00, 0x40, 0xde, 0x99, 0x00, 0x00, 0x00, 0x40, 0xde, 0x59,
+		0x00, 0x00, 0x00, 0x40, 0xde, 0xd9, 0x00, 0x00, 0x00, 0x40, 0xde, 0x39, 0x00, 0x00, 0x00, 0x40,
+		0xde, 0xb9, 0x00, 0x00, 0x00, 0x40, 0xde, 0x79, 0x00, 0x00, 0x00, 0x40, 0xde, 0xf9, 0x00, 0x00,
+		0x00, 0x40, 0xde, 0x05, 0x00, 0x00, 0x00, 0x40, 0xde, 0xdf, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x7f,
+		0x00, 0x00, 0x00, 0x00, 0x79, 0x17, 0x02, 0x00, 0x00, 0x00, 0x79, 0x17, 0x01, 0x00, 0x00, 0x00,
+		0x79, 0x17, 0x03, 0x00, 0x00, 0x00, 0x79, 0x97, 0x00, 0x00, 0x00, 0x00, 0x79, 0x97, 0x02, 0x00,
+		0x00, 0x00, 0x79, 0x97, 0x01, 0x00, 0x00, 0x00, 0x79, 0x97, 0x03, 0x00, 0x00, 0x00, 0x79, 0xff,
+		0x04, 0x00, 0x00, 0x00, 0xf2, 0xae, 0x00, 0x00, 0x00, 0x00, 0xf2, 0xae, 0x04, 0x00, 0x00, 0x00,
+		0xf2, 0xae, 0x02, 0x00, 0x00, 0x00, 0xf2, 0xae, 0x06, 0x00, 0x00, 0x00, 0xf2, 0xae, 0x01, 0x00,
+		0x00, 0x00, 0xf2, 0xae, 0x05, 0x00, 0x00, 0x00, 0xf2, 0xae, 0x03, 0x00, 0x00, 0x00, 0xf2, 0xae,
+		0x07, 0x00, 0x00, 0x00, 0xf2, 0x6e, 0x00, 0x00, 0x00, 0x00, 0xf2, 0x6e, 0x04, 0x00, 0x00, 0x00,
+		0xf2, 0xfe, 0x05, 0x00, 0x00, 0x00, 0xe4, 0xdd, 0x04, 0x00, 0x00, 0x00, 0xe4, 0xdd, 0x0c, 0x00,
+		0x00, 0x00, 0xe4, 0xdd, 0x02, 0x00, 0x00, 0x00, 0xe4, 0xdd, 0x0a, 0x00, 0x00, 0x00, 0xe4, 0xdd,
+		0x06, 0x00, 0x00, 0x00, 0xe4, 0xdd, 0x0e, 0x00, 0x00, 0x00, 0xe4, 0xfd, 0x1b, 0x00, 0x00, 0x00,
+		0xc8, 0xbb, 0x03, 0x00, 0x00, 0x00, 0xc8, 0xbb, 0x13, 0x00, 0x00, 0x00, 0xc8, 0xbb, 0x0b, 0x00,
+		0x00, 0x00, 0xc8, 0xbb, 0x1b, 0x00, 0x00, 0x00, 0xc8, 0xbb, 0x07, 0x00, 0x00, 0x00, 0xc8, 0xbb,
+		0x17, 0x00, 0x00, 0x00, 0xc8, 0xbb, 0x0f, 0x00, 0x00, 0x00, 0xc8, 0xbb, 0x1f, 0x00, 0x00, 0x00,
+		0xc8, 0x7b, 0x00, 0x00, 0x00, 0x00, 0xc8, 0x7b, 0x10, 0x00, 0x00, 0x00, 0xc8, 0x7b, 0x08, 0x00,
+		0x00, 0x00, 0xc8, 0x7b, 0x18, 0x00, 0x00, 0x00, 0xc8, 0xfb, 0x0f, 0x00, 0x00, 0x00, 0x90, 0xf7,
+		0x08, 0x00, 0x00, 0x00, 0x90, 0xf7, 0x5f, 0x00, 0x00, 0x00, 0x20, 0xef, 0x51, 0x00, 0x00, 0x00,
+		0x20, 0xef, 0x31, 0x00, 0x00, 0x00, 0x20, 0xef, 0x71, 0x00, 0x00, 0x00, 0x20, 0xef, 0x09, 0x00,
+		0x00, 0x00, 0x20, 0xef, 0x49, 0x00, 0x00, 0x00, 0x20, 0xef, 0x29, 0x00, 0x00, 0x00, 0x20, 0xef,
+		0x69, 0x00, 0x00, 0x00, 0x20, 0xef, 0x19, 0x00, 0x00, 0x00, 0x20, 0xef, 0x59, 0x00, 0x00, 0x00,
+		0x20, 0xef, 0x39, 0x00, 0x00, 0x00, 0x20, 0xef, 0x79, 0x00, 0x00, 0x00, 0x20, 0xef, 0x05, 0x00,
+		0x00, 0x00, 0x20, 0xef, 0x45, 0x00, 0x00, 0x00, 0x20, 0xef, 0x25, 0x00, 0x00, 0x00, 0x20, 0xef,
+		0x65, 0x00, 0x00, 0x00, 0x20, 0xef, 0x15, 0x00, 0x00, 0x00, 0x20, 0xef, 0x55, 0x00, 0x00, 0x00,
+		0x20, 0xef, 0x7f, 0x00, 0x00, 0x00, 0x40, 0xde, 0xff, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xd7, 0x00,
+		0x00, 0x00, 0x80, 0xbc, 0xd7, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x37, 0x00, 0x00, 0x00, 0x80, 0xbc,
+		0x37, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xb7, 0x00, 0x00, 0x00, 0x80, 0xbc, 0xb7, 0x01, 0x00, 0x00,
+		0x80, 0xbc, 0x77, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x77, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xf7, 0x00,
+		0x00, 0x00, 0x80, 0xbc, 0xf7, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x0f, 0x00, 0x00, 0x00, 0x80, 0xbc,
+		0x0f, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x8f, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x8f, 0x01, 0x00, 0x00,
+		0x80, 0xbc, 0x4f, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x4f, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xcf, 0x00,
+		0x00, 0x00, 0x80, 0xbc, 0xcf, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x2f, 0x00, 0x00, 0x00, 0x80, 0xbc,
+		0x2f, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xaf, 0x00, 0x00, 0x00, 0x80, 0xbc, 0xaf, 0x01, 0x00, 0x00,
+		0x80, 0xbc, 0x6f, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x6f, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xef, 0x00,
+		0x00, 0x00, 0x80, 0xbc, 0xef, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x1f, 0x00, 0x00, 0x00, 0x80, 0xbc,
+		0x1f, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x9f, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x9f, 0x01, 0x00, 0x00,
+		0x80, 0xbc, 0x5f, 0x00, 0x00, 0x00, 0x80, 0xbc, 0x5f, 0x01, 0x00, 0x00, 0x80, 0xbc, 0xdf, 0x00,
+		0x00, 0x00, 0x80, 0xbc, 0xe1, 0x01, 0x00, 0x00, 0x80, 0xbc, 0x01, 0x00, 0x00, 0x00, 0x40, 0xde,
+		0x40, 0x00, 0x00, 0x00, 0x20, 0x6f, 0x10, 0x00, 0x00, 0x00, 0x90, 0x37, 0x02, 0x00, 0x00, 0x00,
+		0x90, 0x37, 0x18, 0x00, 0x00, 0x00, 0xc8, 0x1b, 0x02, 0x00, 0x00, 0x00, 0xe4, 0x0d, 0x05, 0x00,
+		0x00, 0x00, 0xf2, 0x86, 0x01, 0x00, 0x00, 0x00, 0x79, 0x23, 0x02, 0x00, 0x00, 0x00, 0x79, 0x23,
+		0x01, 0x00, 0x00, 0x00, 0x79, 0x23, 0x03, 0x00, 0x00, 0x00, 0x79, 0xa3, 0x00, 0x00, 0xc4, 0xfc,
+		0x0e, 0x50, 0x4b, 0x01, 0x02, 0x14, 0x03, 0x14, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x21,
+		0x00, 0xd2, 0x01, 0xd5, 0x57, 0x7a, 0x06, 0x00, 0x00, 0xe0, 0xc8, 0x10, 0x00, 0x09, 0x00, 0x00,
+		0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x80, 0x01, 0x00, 0x00, 0x00, 0x00, 0x6c,
+		0x61, 0x72, 0x67, 0x65, 0x2e, 0x62, 0x69, 0x6e, 0x50, 0x4b, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00,
+		0x01, 0x00, 0x01, 0x00, 0x37, 0x00, 0x00, 0x00, 0xa1, 0x06, 0x00, 0x00, 0x00, 0x00,
+};
+
+static const uint32 zipTestLargeSize = 1100000;
+// Where the CRC of large.bin is kept in the local header and the central directory
+static const uint32 zipTestLargeCRCOffsets[] = { 14, 1713 };
+
+static byte zipTestLargeByte(uint32 pos) {
+	return (byte)((pos >> 12) + (pos >> 20));
+}
+
+/** A file with a zip archive in memory, which counts how often it is opened */
+class ZipTestNode : public AbstractFSNode {
+	const byte *_data;
+	uint32 _size;
+	int *_opened;
+
+protected:
+	AbstractFSNode *getChild(const Common::String &name) const { return 0; }
+	AbstractFSNode *getParent() const { return new ZipTestNode(*this); }
+
+public:
+	ZipTestNode(const byte *data, uint32 size, int *opened) : _data(data), _size(size), _opened(opened) {}
+
+	bool exists() const { return true; }
+	bool getChildren(AbstractFSList &list, ListMode mode, bool hidden) const { return false; }
+	Common::String getName() const { return "test.zip"; }
+	Common::String getPath() const { return "test.zip"; }
+	bool isDirectory() const { return false; }
+	bool isReadable() const { return true; }
+	bool isWritable() const { return false; }
+
+	Common::SeekableReadStream *createReadStream() {
+		++*_opened;
+		return new Common::MemoryReadStream(_data, _size);
+	}
+	Common::WriteStream *createWriteStream() { return 0; }
+};
+
+class UnzipTestSuite : public CxxTest::TestSuite {
+	Common::Archive *openArchive() {
+		return Common::makeZipArchive(new Common::MemoryReadStream(zipTestArchive, sizeof(zipTestArchive)));
+	}
+
+	Common::Archive *openLargeArchive(const byte *data, int *opened) {
+		return Common::makeZipArchive(AbstractFSNode::makeFSNode(new ZipTestNode(data, sizeof(zipTestLargeArchive), opened)));
+	}
+
+public:
+	void test_stored_member() {
+		Common::Archive *zip = openArchive();
+		TS_ASSERT(zip);
+
+		Common::SeekableReadStream *s = zip->createReadStreamForMember("stored.txt");
+		TS_ASSERT(s);
+		TS_ASSERT_EQUALS(s->size(), 100);
+
+		for (int i = 0; i < 100; ++i)
+			TS_ASSERT_EQUALS(s->readByte(), (byte)(i * 7));
+		s->readByte();
+		TS_ASSERT(s->eos());
+
+		s->seek(-10, SEEK_END);
+		TS_ASSERT_EQUALS(s->readByte(), (byte)(90 * 7));
+
+		delete s;
+		delete zip;
+	}
+
+#if defined(USE_ZLIB)
+	void test_deflated_member() {
+		Common::Archive *zip = openArchive();
+		Common::SeekableReadStream *s = zip->createReadStreamForMember("deflated.bin");
+		TS_ASSERT(s);
+		TS_ASSERT_EQUALS(s->size(), (int32)zipTestDeflatedSize);
+
+		byte buf[1000];
+		uint32 pos = 0;
+		while (!s->eos()) {
+			uint32 n = s->read(buf, sizeof(buf));
+			for (uint32 i = 0; i < n; ++i)
+				TS_ASSERT_EQUALS(buf[i], (byte)((pos + i) % 251));
+			pos += n;
+		}
+		TS_ASSERT_EQUALS(pos, zipTestDeflatedSize);
+		TS_ASSERT(!s->err());
+
+		delete s;
+		delete zip;
+	}
+
+	void test_deflated_seek() {
+		Common::Archive *zip = openArchive();
+		Common::SeekableReadStream *s = zip->createReadStreamForMember("deflated.bin");
+
+		const uint32 positions[] = { 60000, 17, 40000, 39999, zipTestDeflatedSize - 1, 0 };
+		for (uint i = 0; i < ARRAYSIZE(positions); ++i) {
+			TS_ASSERT(s->seek(positions[i]));
+			TS_ASSERT_EQUALS(s->pos(), (int32)positions[i]);
+			TS_ASSERT_EQUALS(s->readByte(), (byte)(positions[i] % 251));
+		}
+
+		TS_ASSERT(s->seek(-1, SEEK_END));
+		TS_ASSERT_EQUALS(s->readByte(), (byte)((zipTestDeflatedSize - 1) % 251));
+		TS_ASSERT(!s->err());
+
+		delete s;
+		delete zip;
+	}
+
+	void test_concurrent_members() {
+		// Member streams do not share a read position, and may outlive the archive
+		Common::Archive *zip = openArchive();
+		Common::SeekableReadStream *a = zip->createReadStreamForMember("deflated.bin");
+		Common::SeekableReadStream *b = zip->createReadStreamForMember("deflated.bin");
+		Common::SeekableReadStream *c = zip->createReadStreamForMember("stored.txt");
+		delete zip;
+
+		b->seek(1000);
+		for (uint32 i = 0; i < 100; ++i) {
+			TS_ASSERT_EQUALS(a->readByte(), (byte)(i % 251));
+			TS_ASSERT_EQUALS(b->readByte(), (byte)((i + 1000) % 251));
+			TS_ASSERT_EQUALS(c->readByte(), (byte)(i * 7));
+		}
+
+		delete a;
+		delete b;
+		delete c;
+	}
+
+	void test_corrupt_member() {
+		// Members read into memory are checked as a whole
+		byte data[sizeof(zipTestArchive)];
+		memcpy(data, zipTestArchive, sizeof(data));
+		data[45] ^= 0xFF;	// in the data of stored.txt
+
+		Common::Archive *zip = Common::makeZipArchive(new Common::MemoryReadStream(data, sizeof(data)));
+		TS_ASSERT(!zip->createReadStreamForMember("stored.txt"));
+		Common::SeekableReadStream *s = zip->createReadStreamForMember("deflated.bin");
+		TS_ASSERT(s);
+		delete s;
+		delete zip;
+	}
+
+	void test_large_member() {
+		// Every large member is streamed from its own handle to the archive file
+		int opened = 0;
+		Common::Archive *zip = openLargeArchive(zipTestLargeArchive, &opened);
+		TS_ASSERT_EQUALS(opened, 1);
+		Common::SeekableReadStream *a = zip->createReadStreamForMember("large.bin");
+		Common::SeekableReadStream *b = zip->createReadStreamForMember("large.bin");
+		TS_ASSERT_EQUALS(opened, 3);
+		delete zip;
+
+		TS_ASSERT_EQUALS(a->size(), (int32)zipTestLargeSize);
+		b->seek(zipTestLargeSize / 2);
+
+		byte bufA[10000], bufB[1000];
+		uint32 pos = 0;
+		bool match = true;
+		while (!a->eos()) {
+			const uint32 n = a->read(bufA, sizeof(bufA));
+			for (uint32 i = 0; i < n; ++i)
+				match = match && bufA[i] == zipTestLargeByte(pos + i);
+			pos += n;
+
+			// Reading the other member in between does not disturb this one
+			const uint32 bPos = b->pos();
+			const uint32 m = b->read(bufB, sizeof(bufB));
+			for (uint32 i = 0; i < m; ++i)
+				match = match && bufB[i] == zipTestLargeByte(bPos + i);
+		}
+		TS_ASSERT(match);
+		TS_ASSERT_EQUALS(pos, zipTestLargeSize);
+		TS_ASSERT(!a->err());
+		TS_ASSERT(!b->err());
+
+		delete a;
+		delete b;
+	}
+
+	void test_large_member_seek() {
+		int opened = 0;
+		Common::Archive *zip = openLargeArchive(zipTestLargeArchive, &opened);
+		Common::SeekableReadStream *s = zip->createReadStreamForMember("large.bin");
+
+		// Twice, the second round resumes from the checkpoint past 1 MiB
+		const uint32 positions[] = { 1050000, 17, 1048576, 600000, 599999, zipTestLargeSize - 1, 0, 1090000 };
+		for (uint round = 0; round < 2; ++round) {
+			for (uint i = 0; i < ARRAYSIZE(positions); ++i) {
+				TS_ASSERT(s->seek(positions[i]));
+				TS_ASSERT_EQUALS(s->pos(), (int32)positions[i]);
+				TS_ASSERT_EQUALS(s->readByte(), zipTestLargeByte(positions[i]));
+			}
+		}
+		TS_ASSERT(!s->err());
+
+		delete s;
+		delete zip;
+	}
+
+	void test_large_member_crc() {
+		// A streamed member is checked once it was read up to its end
+		byte data[sizeof(zipTestLargeArchive)];
+		memcpy(data, zipTestLargeArchive, sizeof(data));
+		for (uint i = 0; i < ARRAYSIZE(zipTestLargeCRCOffsets); ++i)
+			data[zipTestLargeCRCOffsets[i]] ^= 0xFF;
+
+		int opened = 0;
+		Common::Archive *zip = openLargeArchive(data, &opened);
+		Common::SeekableReadStream *s = zip->createReadStreamForMember("large.bin");
+		TS_ASSERT(s);
+
+		// Going back and forth does not count any data twice
+		byte buf[4096];
+		s->read(buf, sizeof(buf));
+		s->seek(1000);
+		s->read(buf, sizeof(buf));
+		TS_ASSERT(!s->err());
+
+		while (!s->eos() && !s->err())
+			s->read(buf, sizeof(buf));
+		TS_ASSERT(s->err());
+
+		delete s;
+		delete zip;
+	}
+#endif
+
+	void test_missing_member() {
+		Common::Archive *zip = openArchive();
+		TS_ASSERT(!zip->createReadStreamForMember("missing.txt"));
+		delete zip;
+	}
+};
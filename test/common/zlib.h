@@ -0,0 +1,153 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+#if defined(USE_ZLIB)
+
+static const uint32 gzipTestSize = 3 * 1024 * 1024 + 12345;
+
+/**
+ * Alternating runs of text and noise, so the data spans many deflate blocks.
+ * The inverted data happens to compress to the same size.
+ */
+static byte gzipTestByte(uint32 pos, bool invert = false) {
+	static const char text[] = "The quick brown fox jumps over the lazy dog. ";
+	byte value;
+	if ((pos >> 12) & 1)
+		value = (byte)((pos * 2654435761U) >> 24);
+	else
+		value = (byte)text[pos % (sizeof(text) - 1)];
+	return invert ? ~value : value;
+}
+
+class ZlibTestSuite : public CxxTest::TestSuite {
+	Common::MemoryWriteStreamDynamic *compress(uint32 size, bool invert = false) {
+		Common::MemoryWriteStreamDynamic *compressed = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::YES);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(compressed);
+
+		byte buf[4096];
+		for (uint32 pos = 0; pos < size; pos += sizeof(buf)) {
+			const uint32 n = MIN<uint32>(sizeof(buf), size - pos);
+			for (uint32 i = 0; i < n; ++i)
+				buf[i] = gzipTestByte(pos + i, invert);
+			gzip->write(buf, n);
+		}
+		gzip->finalize();
+		return compressed;
+	}
+
+	Common::SeekableReadStream *open(Common::MemoryWriteStreamDynamic *compressed, Common::SeekableReadStream *index = 0) {
+		return Common::wrapCompressedReadStream(new Common::MemoryReadStream(compressed->getData(), compressed->size()), 0, index);
+	}
+
+	void checkSeeks(Common::SeekableReadStream *s) {
+		const uint32 positions[] = { 2500000, 17, 1500000, 1499999, gzipTestSize - 1, 3000000, 1048576, 0, 2000000 };
+		for (uint i = 0; i < ARRAYSIZE(positions); ++i) {
+			TS_ASSERT(s->seek(positions[i]));
+			TS_ASSERT_EQUALS(s->pos(), (int32)positions[i]);
+			TS_ASSERT_EQUALS(s->readByte(), gzipTestByte(positions[i]));
+		}
+
+		TS_ASSERT(s->seek(-5000, SEEK_END));
+		byte buf[5000];
+		TS_ASSERT_EQUALS(s->read(buf, sizeof(buf)), sizeof(buf));
+		for (uint32 i = 0; i < sizeof(buf); ++i)
+			TS_ASSERT_EQUALS(buf[i], gzipTestByte(gzipTestSize - 5000 + i));
+		TS_ASSERT(!s->err());
+	}
+
+public:
+	void test_sequential_read() {
+		Common::MemoryWriteStreamDynamic *compressed = compress(gzipTestSize);
+		Common::SeekableReadStream *s = open(compressed);
+		TS_ASSERT_EQUALS(s->size(), (int32)gzipTestSize);
+
+		byte buf[10000];
+		uint32 pos = 0;
+		bool match = true;
+		while (!s->eos()) {
+			const uint32 n = s->read(buf, sizeof(buf));
+			for (uint32 i = 0; i < n; ++i)
+				match = match && buf[i] == gzipTestByte(pos + i);
+			pos += n;
+		}
+		TS_ASSERT(match);
+		TS_ASSERT_EQUALS(pos, gzipTestSize);
+		TS_ASSERT(!s->err());
+
+		delete s;
+		delete compressed;
+	}
+
+	void test_seek() {
+		Common::MemoryWriteStreamDynamic *compressed = compress(gzipTestSize);
+		Common::SeekableReadStream *s = open(compressed);
+
+		// Twice, since the first round reads the data for the first time
+		checkSeeks(s);
+		checkSeeks(s);
+
+		delete s;
+		delete compressed;
+	}
+
+	void test_index() {
+		Common::MemoryWriteStreamDynamic *compressed = compress(gzipTestSize);
+		Common::MemoryReadStream data(compressed->getData(), compressed->size());
+		Common::MemoryWriteStreamDynamic index(DisposeAfterUse::YES);
+		TS_ASSERT(Common::writeCompressedStreamIndex(&data, &index));
+		TS_ASSERT_LESS_THAN(40000u, index.size());
+
+		Common::MemoryReadStream indexStream(index.getData(), index.size());
+		Common::SeekableReadStream *s = open(compressed, &indexStream);
+		checkSeeks(s);
+
+		delete s;
+		delete compressed;
+	}
+
+	void test_index_mismatch() {
+		// An index of other data is ignored
+		Common::MemoryWriteStreamDynamic *other = compress(gzipTestSize / 2);
+		Common::MemoryReadStream otherData(other->getData(), other->size());
+		Common::MemoryWriteStreamDynamic index(DisposeAfterUse::YES);
+		TS_ASSERT(Common::writeCompressedStreamIndex(&otherData, &index));
+
+		Common::MemoryWriteStreamDynamic *compressed = compress(gzipTestSize);
+		Common::MemoryReadStream indexStream(index.getData(), index.size());
+		Common::SeekableReadStream *s = open(compressed, &indexStream);
+		checkSeeks(s);
+
+		delete s;
+		delete compressed;
+		delete other;
+	}
+
+	void test_index_same_size() {
+		// An index of other data with the same compressed size is ignored, too
+		Common::MemoryWriteStreamDynamic *other = compress(gzipTestSize, true);
+		Common::MemoryReadStream otherData(other->getData(), other->size());
+		Common::MemoryWriteStreamDynamic index(DisposeAfterUse::YES);
+		TS_ASSERT(Common::writeCompressedStreamIndex(&otherData, &index));
+
+		Common::MemoryWriteStreamDynamic *compressed = compress(gzipTestSize);
+		TS_ASSERT_EQUALS(compressed->size(), other->size());
+		Common::MemoryReadStream indexStream(index.getData(), index.size());
+		Common::SeekableReadStream *s = open(compressed, &indexStream);
+		checkSeeks(s);
+
+		delete s;
+		delete compressed;
+		delete other;
+	}
+
+	void test_index_uncompressed() {
+		const byte plain[] = { 'n', 'o', 't', ' ', 'g', 'z' };
+		Common::MemoryReadStream data(plain, sizeof(plain));
+		Common::MemoryWriteStreamDynamic index(DisposeAfterUse::YES);
+		TS_ASSERT(!Common::writeCompressedStreamIndex(&data, &index));
+	}
+};
+
+#endif
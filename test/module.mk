@@ -1,12 +1,12 @@
 ######################################################################
 # Unit/regression tests, based on CxxTest.
-# Use the 'test' target to run them.
+# Use the 'test' target to run them, and 'benchmark' for the benchmarks.
 # Edit TESTS and TESTLIBS to add more tests.
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h
-TEST_LIBS    := audio/libaudio.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/video/*.h
+TEST_LIBS    := video/libvideo.a graphics/libgraphics.a audio/libaudio.a common/libcommon.a
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
@@ -34,9 +34,47 @@ test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+# Micro benchmarks. These are not run as part of 'test', since their
+# results are only meaningful in optimized builds.
+BENCHMARKS   := test/benchmark/hashmap test/benchmark/yuv_to_rgb test/benchmark/bitstream
+BENCHMARK_LIBS := $(TEST_LIBS)
+
+ifdef USE_BINK
+BENCHMARKS   += test/benchmark/bink_dsp
+endif
+
+ifdef ENABLE_HE
+BENCHMARKS   += test/benchmark/moonbase_ai
+# Only the search tree of the AI is linked in, it needs nothing else of the engine
+test/benchmark/moonbase_ai: $(srcdir)/test/benchmark/moonbase_ai.cpp engines/scumm/he/moonbase/ai_tree.o engines/scumm/he/moonbase/ai_node.o $(BENCHMARK_LIBS)
+	@mkdir -p test/benchmark
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+endif
+
+ifdef ENABLE_GROOVIE
+BENCHMARKS   += test/benchmark/cell_game
+test/benchmark/cell_game: $(srcdir)/test/benchmark/cell_game.cpp engines/groovie/cell.o $(BENCHMARK_LIBS)
+	@mkdir -p test/benchmark
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+endif
+
+ifdef ENABLE_SCI
+BENCHMARKS   += test/benchmark/avoid_path
+# Only the pathfinder is linked in, the kernel functions around it stay out
+test/benchmark/avoid_path: $(srcdir)/test/benchmark/avoid_path.cpp engines/sci/engine/pathfinder.o $(BENCHMARK_LIBS)
+	@mkdir -p test/benchmark
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) -I$(srcdir)/engines -o $@ $+ $(TEST_LDFLAGS)
+endif
+
+benchmark: $(BENCHMARKS)
+	@for bench in $(BENCHMARKS); do echo $$bench; ./$$bench || exit 1; done
+test/benchmark/%: $(srcdir)/test/benchmark/%.cpp $(BENCHMARK_LIBS)
+	@mkdir -p test/benchmark
+	$(QUIET_LINK)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+
 
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner $(BENCHMARKS)
 
-.PHONY: test clean-test
+.PHONY: test benchmark clean-test
@@ -0,0 +1,113 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/video_decoder.h"
+#include "graphics/surface.h"
+
+#include "helper.h"
+
+namespace {
+
+/**
+ * A decoder of a 10 fps track of tiny frames. Every frame whose number is
+ * in the palette mask changes the palette to the frame number.
+ */
+class PaletteDecoder : public Video::VideoDecoder {
+public:
+	PaletteDecoder(uint32 paletteMask) { addTrack(new PaletteTrack(paletteMask)); }
+
+	bool loadStream(Common::SeekableReadStream *stream) { return false; }
+
+private:
+	class PaletteTrack : public FixedRateVideoTrack {
+	public:
+		PaletteTrack(uint32 paletteMask) : _paletteMask(paletteMask), _curFrame(-1), _dirtyPalette(false) {
+			_surface.create(2, 2, Graphics::PixelFormat::createFormatCLUT8());
+			memset(_palette, 0, sizeof(_palette));
+		}
+
+		~PaletteTrack() { _surface.free(); }
+
+		uint16 getWidth() const { return _surface.w; }
+		uint16 getHeight() const { return _surface.h; }
+		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
+		int getCurFrame() const { return _curFrame; }
+		int getFrameCount() const { return 10; }
+
+		const Graphics::Surface *decodeNextFrame() {
+			_curFrame++;
+			_dirtyPalette = (_paletteMask & (1 << _curFrame)) != 0;
+			if (_dirtyPalette)
+				memset(_palette, _curFrame, sizeof(_palette));
+			return &_surface;
+		}
+
+		const byte *getPalette() const { _dirtyPalette = false; return _palette; }
+		bool hasDirtyPalette() const { return _dirtyPalette; }
+
+	protected:
+		Common::Rational getFrameRate() const { return 10; }
+
+	private:
+		uint32 _paletteMask;
+		int _curFrame;
+		mutable bool _dirtyPalette;
+		byte _palette[256 * 3];
+		Graphics::Surface _surface;
+	};
+};
+
+} // End of anonymous namespace
+
+class VideoDecoderTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		_prevSystem = g_system;
+		g_system = &_system;
+	}
+
+	void tearDown() {
+		g_system = _prevSystem;
+	}
+
+	void test_decode_ahead_keeps_palette() {
+		// Frames 1 and 3 change the palette, frame 2 does not
+		PaletteDecoder decoder((1 << 1) | (1 << 3));
+		decoder.setDecodeAhead(2);
+		decoder.start();
+
+		// Frame 0 is due right away
+		TS_ASSERT(!decoder.decodeAhead());
+		TS_ASSERT(decoder.decodeNextFrame());
+		TS_ASSERT(decoder.decodeAhead());
+		TS_ASSERT(decoder.decodeAhead());
+
+		_system._millis = 100;
+		TS_ASSERT(decoder.decodeNextFrame());
+		TS_ASSERT(decoder.hasDirtyPalette());
+		TS_ASSERT_EQUALS(decoder.getPalette()[0], 1);
+
+		// Displaying frame 2 releases frame 1, whose palette is still the
+		// current one. Frame 3 then reuses the released memory.
+		_system._millis = 200;
+		TS_ASSERT(decoder.decodeNextFrame());
+		TS_ASSERT(!decoder.hasDirtyPalette());
+		TS_ASSERT(decoder.decodeAhead());
+
+		const byte *palette = decoder.getPalette();
+		TS_ASSERT(palette);
+		int wrong = 0;
+		for (int i = 0; i < 256 * 3; i++)
+			if (palette[i] != 1)
+				wrong++;
+		TS_ASSERT_EQUALS(wrong, 0);
+
+		_system._millis = 300;
+		TS_ASSERT(decoder.decodeNextFrame());
+		TS_ASSERT(decoder.hasDirtyPalette());
+		TS_ASSERT_EQUALS(decoder.getPalette()[0], 3);
+	}
+
+private:
+	VideoTestSystem _system;
+	OSystem *_prevSystem;
+};
@@ -0,0 +1,618 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+// The IDCT is based on eos' Bink decoder which is in turn
+// based quite heavily on the Bink decoder found in FFmpeg.
+
+#include "video/bink_dsp.h"
+
+#if defined(__SSE2__)
+#define USE_SSE2_BINK
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define USE_NEON_BINK
+#include <arm_neon.h>
+#endif
+
+namespace Video {
+
+namespace BinkDSP {
+
+#define A1  2896 /* (1/sqrt(2))<<12 */
+#define A2  2217
+#define A3  3784
+#define A4 -5352
+
+#define IDCT_TRANSFORM(dest,s0,s1,s2,s3,s4,s5,s6,s7,d0,d1,d2,d3,d4,d5,d6,d7,munge,src) {\
+    const int a0 = (src)[s0] + (src)[s4]; \
+    const int a1 = (src)[s0] - (src)[s4]; \
+    const int a2 = (src)[s2] + (src)[s6]; \
+    const int a3 = (A1*((src)[s2] - (src)[s6])) >> 11; \
+    const int a4 = (src)[s5] + (src)[s3]; \
+    const int a5 = (src)[s5] - (src)[s3]; \
+    const int a6 = (src)[s1] + (src)[s7]; \
+    const int a7 = (src)[s1] - (src)[s7]; \
+    const int b0 = a4 + a6; \
+    const int b1 = (A3*(a5 + a7)) >> 11; \
+    const int b2 = ((A4*a5) >> 11) - b0 + b1; \
+    const int b3 = (A1*(a6 - a4) >> 11) - b2; \
+    const int b4 = ((A2*a7) >> 11) + b3 - b1; \
+    (dest)[d0] = munge(a0+a2   +b0); \
+    (dest)[d1] = munge(a1+a3-a2+b2); \
+    (dest)[d2] = munge(a1-a3+a2+b3); \
+    (dest)[d3] = munge(a0-a2   -b4); \
+    (dest)[d4] = munge(a0-a2   +b4); \
+    (dest)[d5] = munge(a1-a3+a2-b3); \
+    (dest)[d6] = munge(a1+a3-a2-b2); \
+    (dest)[d7] = munge(a0+a2   -b0); \
+}
+/* end IDCT_TRANSFORM macro */
+
+#define MUNGE_NONE(x) (x)
+#define IDCT_COL(dest,src) IDCT_TRANSFORM(dest,0,8,16,24,32,40,48,56,0,8,16,24,32,40,48,56,MUNGE_NONE,src)
+
+#define MUNGE_ROW(x) (((x) + 0x7F)>>8)
+#define IDCT_ROW(dest,src) IDCT_TRANSFORM(dest,0,1,2,3,4,5,6,7,0,1,2,3,4,5,6,7,MUNGE_ROW,src)
+
+static inline void idctCol(int16 *dest, const int16 *src) {
+	if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+		dest[ 0] =
+		dest[ 8] =
+		dest[16] =
+		dest[24] =
+		dest[32] =
+		dest[40] =
+		dest[48] =
+		dest[56] = src[0];
+	} else {
+		IDCT_COL(dest, src);
+	}
+}
+
+static void idctScalar(int16 *block) {
+	int i;
+	int16 temp[64];
+
+	for (i = 0; i < 8; i++)
+		idctCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&block[8*i]), (&temp[8*i]) );
+	}
+}
+
+static void idctPutScalar(byte *dest, uint32 pitch, int16 *block) {
+	int i;
+	int16 temp[64];
+	for (i = 0; i < 8; i++)
+		idctCol(&temp[i], &block[i]);
+	for (i = 0; i < 8; i++) {
+		IDCT_ROW( (&dest[i*pitch]), (&temp[8*i]) );
+	}
+}
+
+static void idctAddScalar(byte *dest, uint32 pitch, int16 *block) {
+	int i, j;
+
+	idctScalar(block);
+	for (i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (j = 0; j < 8; j++)
+			 dest[j] += block[j];
+}
+
+static void idctPutScaledScalar(byte *dest, uint32 pitch, int16 *block) {
+	idctScalar(block);
+
+	int16 *src   = block;
+	byte  *dest1 = dest;
+	byte  *dest2 = dest + pitch;
+	for (int j = 0; j < 8; j++, dest1 += (pitch << 1) - 16, dest2 += (pitch << 1) - 16, src += 8) {
+
+		for (int i = 0; i < 8; i++, dest1 += 2, dest2 += 2)
+			dest1[0] = dest1[1] = dest2[0] = dest2[1] = src[i];
+
+	}
+}
+
+static void addBlockScalar(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+#if defined(USE_SSE2_BINK)
+
+/**
+ * SSE2 building blocks for the column pass of the vector IDCT, operating
+ * on eight 16 bit lanes.
+ */
+struct BinkVector16 {
+	typedef __m128i Vec;
+
+	static Vec load(const int16 *src) { return _mm_loadu_si128((const Vec *)src); }
+
+	static Vec add(Vec a, Vec b) { return _mm_add_epi16(a, b); }
+	static Vec sub(Vec a, Vec b) { return _mm_sub_epi16(a, b); }
+
+	/** The low 16 bits of (a * c) >> 11. */
+	static Vec mulShift(Vec a, int c) {
+		const Vec factor = _mm_set1_epi16(c);
+		return _mm_or_si128(_mm_slli_epi16(_mm_mulhi_epi16(a, factor), 5), _mm_srli_epi16(_mm_mullo_epi16(a, factor), 11));
+	}
+
+	/** Whether all 64 values of a block are in [-8192, 8191]. */
+	static bool fitsColumnPass(const int16 *block) {
+		Vec lo = load(block);
+		Vec hi = lo;
+		for (int i = 1; i < 8; i++) {
+			const Vec x = load(block + i * 8);
+			lo = _mm_min_epi16(lo, x);
+			hi = _mm_max_epi16(hi, x);
+		}
+
+		const Vec outside = _mm_or_si128(_mm_cmplt_epi16(lo, _mm_set1_epi16(-8192)), _mm_cmpgt_epi16(hi, _mm_set1_epi16(8191)));
+		return _mm_movemask_epi8(outside) == 0;
+	}
+
+	static void transpose(Vec *v) {
+		const Vec a0 = _mm_unpacklo_epi16(v[0], v[1]);
+		const Vec a1 = _mm_unpackhi_epi16(v[0], v[1]);
+		const Vec a2 = _mm_unpacklo_epi16(v[2], v[3]);
+		const Vec a3 = _mm_unpackhi_epi16(v[2], v[3]);
+		const Vec a4 = _mm_unpacklo_epi16(v[4], v[5]);
+		const Vec a5 = _mm_unpackhi_epi16(v[4], v[5]);
+		const Vec a6 = _mm_unpacklo_epi16(v[6], v[7]);
+		const Vec a7 = _mm_unpackhi_epi16(v[6], v[7]);
+
+		const Vec b0 = _mm_unpacklo_epi32(a0, a2);
+		const Vec b1 = _mm_unpackhi_epi32(a0, a2);
+		const Vec b2 = _mm_unpacklo_epi32(a1, a3);
+		const Vec b3 = _mm_unpackhi_epi32(a1, a3);
+		const Vec b4 = _mm_unpacklo_epi32(a4, a6);
+		const Vec b5 = _mm_unpackhi_epi32(a4, a6);
+		const Vec b6 = _mm_unpacklo_epi32(a5, a7);
+		const Vec b7 = _mm_unpackhi_epi32(a5, a7);
+
+		v[0] = _mm_unpacklo_epi64(b0, b4);
+		v[1] = _mm_unpackhi_epi64(b0, b4);
+		v[2] = _mm_unpacklo_epi64(b1, b5);
+		v[3] = _mm_unpackhi_epi64(b1, b5);
+		v[4] = _mm_unpacklo_epi64(b2, b6);
+		v[5] = _mm_unpackhi_epi64(b2, b6);
+		v[6] = _mm_unpacklo_epi64(b3, b7);
+		v[7] = _mm_unpackhi_epi64(b3, b7);
+	}
+
+	/** Sign extend the lanes into two vectors of 32 bit lanes. */
+	static void widen(Vec x, __m128i &lo, __m128i &hi) {
+		lo = _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16);
+		hi = _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16);
+	}
+
+	static void addBlockRow(byte *dst, const int16 *src) {
+		const Vec bytes = _mm_packus_epi16(_mm_and_si128(load(src), _mm_set1_epi16(0xFF)), _mm_setzero_si128());
+		_mm_storel_epi64((Vec *)dst, _mm_add_epi8(_mm_loadl_epi64((const Vec *)dst), bytes));
+	}
+};
+
+/**
+ * SSE2 building blocks for the row pass of the vector IDCT, operating on
+ * four 32 bit lanes, since the rounding needs all the bits.
+ */
+struct BinkVector32 {
+	typedef __m128i Vec;
+
+	static Vec add(Vec a, Vec b) { return _mm_add_epi32(a, b); }
+	static Vec sub(Vec a, Vec b) { return _mm_sub_epi32(a, b); }
+
+	/** (a * c) >> 11, without the SSE4.1 32 bit multiplication. */
+	static Vec mulShift(Vec a, int c) {
+		const Vec factor = _mm_set1_epi32(c);
+		const Vec even = _mm_mul_epu32(a, factor);
+		const Vec odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), factor);
+		const Vec product = _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+		return _mm_srai_epi32(product, 11);
+	}
+
+	/** The rounding of the row pass. */
+	static Vec round(Vec a) {
+		return _mm_srai_epi32(_mm_add_epi32(a, _mm_set1_epi32(0x7F)), 8);
+	}
+
+	static void transpose(Vec &a, Vec &b, Vec &c, Vec &d) {
+		const Vec ab0 = _mm_unpacklo_epi32(a, b);
+		const Vec ab1 = _mm_unpackhi_epi32(a, b);
+		const Vec cd0 = _mm_unpacklo_epi32(c, d);
+		const Vec cd1 = _mm_unpackhi_epi32(c, d);
+		a = _mm_unpacklo_epi64(ab0, cd0);
+		b = _mm_unpackhi_epi64(ab0, cd0);
+		c = _mm_unpacklo_epi64(ab1, cd1);
+		d = _mm_unpackhi_epi64(ab1, cd1);
+	}
+
+	/** The row, truncated to int16 like the scalar stores. */
+	static __m128i words(Vec lo, Vec hi) {
+		// Sign extend the low halves first, so that packing doesn't saturate
+		lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+		hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+		return _mm_packs_epi32(lo, hi);
+	}
+
+	/** The row, truncated to bytes, in the low half of the result. */
+	static __m128i bytes(Vec lo, Vec hi) {
+		const Vec mask = _mm_set1_epi32(0xFF);
+		const Vec w = _mm_packs_epi32(_mm_and_si128(lo, mask), _mm_and_si128(hi, mask));
+		return _mm_packus_epi16(w, w);
+	}
+
+	static void storeRow(int16 *dst, Vec lo, Vec hi) {
+		_mm_storeu_si128((Vec *)dst, words(lo, hi));
+	}
+
+	static void putRow(byte *dst, Vec lo, Vec hi) {
+		_mm_storel_epi64((Vec *)dst, bytes(lo, hi));
+	}
+
+	static void addRow(byte *dst, Vec lo, Vec hi) {
+		_mm_storel_epi64((Vec *)dst, _mm_add_epi8(_mm_loadl_epi64((const Vec *)dst), bytes(lo, hi)));
+	}
+
+	static void putRowScaled(byte *dst, uint32 pitch, Vec lo, Vec hi) {
+		const Vec b = bytes(lo, hi);
+		const Vec doubled = _mm_unpacklo_epi8(b, b);
+		_mm_storeu_si128((Vec *)dst, doubled);
+		_mm_storeu_si128((Vec *)(dst + pitch), doubled);
+	}
+};
+
+#elif defined(USE_NEON_BINK)
+
+/**
+ * NEON building blocks for the column pass of the vector IDCT, operating
+ * on eight 16 bit lanes.
+ */
+struct BinkVector16 {
+	typedef int16x8_t Vec;
+
+	static Vec load(const int16 *src) { return vld1q_s16(src); }
+
+	static Vec add(Vec a, Vec b) { return vaddq_s16(a, b); }
+	static Vec sub(Vec a, Vec b) { return vsubq_s16(a, b); }
+
+	/** The low 16 bits of (a * c) >> 11. */
+	static Vec mulShift(Vec a, int c) {
+		const int16x4_t factor = vdup_n_s16(c);
+		return vcombine_s16(vshrn_n_s32(vmull_s16(vget_low_s16(a), factor), 11), vshrn_n_s32(vmull_s16(vget_high_s16(a), factor), 11));
+	}
+
+	/** Whether all 64 values of a block are in [-8192, 8191]. */
+	static bool fitsColumnPass(const int16 *block) {
+		Vec lo = load(block);
+		Vec hi = lo;
+		for (int i = 1; i < 8; i++) {
+			const Vec x = load(block + i * 8);
+			lo = vminq_s16(lo, x);
+			hi = vmaxq_s16(hi, x);
+		}
+
+		const uint64x2_t outside = vreinterpretq_u64_u16(vorrq_u16(vcltq_s16(lo, vdupq_n_s16(-8192)), vcgtq_s16(hi, vdupq_n_s16(8191))));
+		return (vgetq_lane_u64(outside, 0) | vgetq_lane_u64(outside, 1)) == 0;
+	}
+
+	static void transpose(Vec *v) {
+		const int16x8x2_t a01 = vtrnq_s16(v[0], v[1]);
+		const int16x8x2_t a23 = vtrnq_s16(v[2], v[3]);
+		const int16x8x2_t a45 = vtrnq_s16(v[4], v[5]);
+		const int16x8x2_t a67 = vtrnq_s16(v[6], v[7]);
+
+		const int32x4x2_t b02 = vtrnq_s32(vreinterpretq_s32_s16(a01.val[0]), vreinterpretq_s32_s16(a23.val[0]));
+		const int32x4x2_t b13 = vtrnq_s32(vreinterpretq_s32_s16(a01.val[1]), vreinterpretq_s32_s16(a23.val[1]));
+		const int32x4x2_t b46 = vtrnq_s32(vreinterpretq_s32_s16(a45.val[0]), vreinterpretq_s32_s16(a67.val[0]));
+		const int32x4x2_t b57 = vtrnq_s32(vreinterpretq_s32_s16(a45.val[1]), vreinterpretq_s32_s16(a67.val[1]));
+
+		v[0] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b02.val[0]), vget_low_s32(b46.val[0])));
+		v[1] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b13.val[0]), vget_low_s32(b57.val[0])));
+		v[2] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b02.val[1]), vget_low_s32(b46.val[1])));
+		v[3] = vreinterpretq_s16_s32(vcombine_s32(vget_low_s32(b13.val[1]), vget_low_s32(b57.val[1])));
+		v[4] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b02.val[0]), vget_high_s32(b46.val[0])));
+		v[5] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b13.val[0]), vget_high_s32(b57.val[0])));
+		v[6] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b02.val[1]), vget_high_s32(b46.val[1])));
+		v[7] = vreinterpretq_s16_s32(vcombine_s32(vget_high_s32(b13.val[1]), vget_high_s32(b57.val[1])));
+	}
+
+	/** Sign extend the lanes into two vectors of 32 bit lanes. */
+	static void widen(Vec x, int32x4_t &lo, int32x4_t &hi) {
+		lo = vmovl_s16(vget_low_s16(x));
+		hi = vmovl_s16(vget_high_s16(x));
+	}
+
+	static void addBlockRow(byte *dst, const int16 *src) {
+		const uint8x8_t bytes = vmovn_u16(vreinterpretq_u16_s16(load(src)));
+		vst1_u8(dst, vadd_u8(vld1_u8(dst), bytes));
+	}
+};
+
+/**
+ * NEON building blocks for the row pass of the vector IDCT, operating on
+ * four 32 bit lanes, since the rounding needs all the bits.
+ */
+struct BinkVector32 {
+	typedef int32x4_t Vec;
+
+	static Vec add(Vec a, Vec b) { return vaddq_s32(a, b); }
+	static Vec sub(Vec a, Vec b) { return vsubq_s32(a, b); }
+
+	/** (a * c) >> 11 */
+	static Vec mulShift(Vec a, int c) {
+		return vshrq_n_s32(vmulq_n_s32(a, c), 11);
+	}
+
+	/** The rounding of the row pass. */
+	static Vec round(Vec a) {
+		return vshrq_n_s32(vaddq_s32(a, vdupq_n_s32(0x7F)), 8);
+	}
+
+	static void transpose(Vec &a, Vec &b, Vec &c, Vec &d) {
+		const int32x4x2_t ab = vtrnq_s32(a, b);
+		const int32x4x2_t cd = vtrnq_s32(c, d);
+		a = vcombine_s32(vget_low_s32(ab.val[0]), vget_low_s32(cd.val[0]));
+		b = vcombine_s32(vget_low_s32(ab.val[1]), vget_low_s32(cd.val[1]));
+		c = vcombine_s32(vget_high_s32(ab.val[0]), vget_high_s32(cd.val[0]));
+		d = vcombine_s32(vget_high_s32(ab.val[1]), vget_high_s32(cd.val[1]));
+	}
+
+	/** The row, truncated to int16 like the scalar stores. */
+	static int16x8_t words(Vec lo, Vec hi) {
+		return vcombine_s16(vmovn_s32(lo), vmovn_s32(hi));
+	}
+
+	/** The row, truncated to bytes. */
+	static uint8x8_t bytes(Vec lo, Vec hi) {
+		return vmovn_u16(vreinterpretq_u16_s16(words(lo, hi)));
+	}
+
+	static void storeRow(int16 *dst, Vec lo, Vec hi) {
+		vst1q_s16(dst, words(lo, hi));
+	}
+
+	static void putRow(byte *dst, Vec lo, Vec hi) {
+		vst1_u8(dst, bytes(lo, hi));
+	}
+
+	static void addRow(byte *dst, Vec lo, Vec hi) {
+		vst1_u8(dst, vadd_u8(vld1_u8(dst), bytes(lo, hi)));
+	}
+
+	static void putRowScaled(byte *dst, uint32 pitch, Vec lo, Vec hi) {
+		const uint8x8_t b = bytes(lo, hi);
+		const uint8x8x2_t zipped = vzip_u8(b, b);
+		const uint8x16_t doubled = vcombine_u8(zipped.val[0], zipped.val[1]);
+		vst1q_u8(dst, doubled);
+		vst1q_u8(dst + pitch, doubled);
+	}
+};
+
+#endif
+
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+
+typedef BinkVector32::Vec Vec;
+
+/** One pass of the IDCT on eight vectors, with V providing the arithmetic. */
+template<class V>
+static inline void idctTransform(const typename V::Vec *s, typename V::Vec *d) {
+	typedef typename V::Vec T;
+
+	const T a0 = V::add(s[0], s[4]);
+	const T a1 = V::sub(s[0], s[4]);
+	const T a2 = V::add(s[2], s[6]);
+	const T a3 = V::mulShift(V::sub(s[2], s[6]), A1);
+	const T a4 = V::add(s[5], s[3]);
+	const T a5 = V::sub(s[5], s[3]);
+	const T a6 = V::add(s[1], s[7]);
+	const T a7 = V::sub(s[1], s[7]);
+	const T b0 = V::add(a4, a6);
+	const T b1 = V::mulShift(V::add(a5, a7), A3);
+	const T b2 = V::add(V::sub(V::mulShift(a5, A4), b0), b1);
+	const T b3 = V::sub(V::mulShift(V::sub(a6, a4), A1), b2);
+	const T b4 = V::sub(V::add(V::mulShift(a7, A2), b3), b1);
+
+	const T a02 = V::add(a0, a2);
+	const T a0m2 = V::sub(a0, a2);
+	const T a132 = V::sub(V::add(a1, a3), a2);
+	const T a1m32 = V::add(V::sub(a1, a3), a2);
+
+	d[0] = V::add(a02, b0);
+	d[1] = V::add(a132, b2);
+	d[2] = V::add(a1m32, b3);
+	d[3] = V::sub(a0m2, b4);
+	d[4] = V::add(a0m2, b4);
+	d[5] = V::sub(a1m32, b3);
+	d[6] = V::sub(a132, b2);
+	d[7] = V::sub(a02, b0);
+}
+
+/**
+ * The IDCT of a block. rows[2 * i] and rows[2 * i + 1] receive the left
+ * and right half of the row i of the result, not yet truncated.
+ *
+ * The column pass works on 16 bit lanes. That is exact as long as the
+ * operands of the multiplications fit into 16 bits, which is the case for
+ * coefficients in [-8192, 8191]. For other blocks, false is returned, and
+ * the scalar code has to be used.
+ */
+static inline bool idctVector(const int16 *block, Vec *rows) {
+	if (!BinkVector16::fitsColumnPass(block))
+		return false;
+
+	// Column pass: the lanes hold the eight columns
+	BinkVector16::Vec in[8], out[8];
+	for (int i = 0; i < 8; i++)
+		in[i] = BinkVector16::load(block + i * 8);
+
+	idctTransform<BinkVector16>(in, out);
+
+	// Now the lanes hold the eight rows
+	BinkVector16::transpose(out);
+
+	Vec cols[2][8];
+	for (int c = 0; c < 8; c++)
+		BinkVector16::widen(out[c], cols[0][c], cols[1][c]);
+
+	// Row pass, on four rows at a time
+	for (int quarter = 0; quarter < 2; quarter++) {
+		Vec res[8];
+		idctTransform<BinkVector32>(cols[quarter], res);
+		for (int c = 0; c < 8; c++)
+			res[c] = BinkVector32::round(res[c]);
+
+		// Transpose back into rows
+		BinkVector32::transpose(res[0], res[1], res[2], res[3]);
+		BinkVector32::transpose(res[4], res[5], res[6], res[7]);
+		for (int r = 0; r < 4; r++) {
+			rows[(quarter * 4 + r) * 2] = res[r];
+			rows[(quarter * 4 + r) * 2 + 1] = res[r + 4];
+		}
+	}
+
+	return true;
+}
+
+static void idctSIMD(int16 *block) {
+	Vec rows[16];
+	if (!idctVector(block, rows)) {
+		idctScalar(block);
+		return;
+	}
+
+	for (int i = 0; i < 8; i++)
+		BinkVector32::storeRow(block + i * 8, rows[i * 2], rows[i * 2 + 1]);
+}
+
+static void idctPutSIMD(byte *dest, uint32 pitch, int16 *block) {
+	Vec rows[16];
+	if (!idctVector(block, rows)) {
+		idctPutScalar(dest, pitch, block);
+		return;
+	}
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		BinkVector32::putRow(dest, rows[i * 2], rows[i * 2 + 1]);
+}
+
+static void idctAddSIMD(byte *dest, uint32 pitch, int16 *block) {
+	Vec rows[16];
+	if (!idctVector(block, rows)) {
+		idctAddScalar(dest, pitch, block);
+		return;
+	}
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		BinkVector32::addRow(dest, rows[i * 2], rows[i * 2 + 1]);
+}
+
+static void idctPutScaledSIMD(byte *dest, uint32 pitch, int16 *block) {
+	Vec rows[16];
+	if (!idctVector(block, rows)) {
+		idctPutScaledScalar(dest, pitch, block);
+		return;
+	}
+
+	for (int i = 0; i < 8; i++, dest += pitch * 2)
+		BinkVector32::putRowScaled(dest, pitch, rows[i * 2], rows[i * 2 + 1]);
+}
+
+static void addBlockSIMD(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		BinkVector16::addBlockRow(dest, block);
+}
+
+static bool s_useSIMD = true;
+
+#endif // USE_SSE2_BINK || USE_NEON_BINK
+
+void idct(int16 *block) {
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+	if (s_useSIMD) {
+		idctSIMD(block);
+		return;
+	}
+#endif
+	idctScalar(block);
+}
+
+void idctPut(byte *dest, uint32 pitch, int16 *block) {
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+	if (s_useSIMD) {
+		idctPutSIMD(dest, pitch, block);
+		return;
+	}
+#endif
+	idctPutScalar(dest, pitch, block);
+}
+
+void idctAdd(byte *dest, uint32 pitch, int16 *block) {
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+	if (s_useSIMD) {
+		idctAddSIMD(dest, pitch, block);
+		return;
+	}
+#endif
+	idctAddScalar(dest, pitch, block);
+}
+
+void idctPutScaled(byte *dest, uint32 pitch, int16 *block) {
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+	if (s_useSIMD) {
+		idctPutScaledSIMD(dest, pitch, block);
+		return;
+	}
+#endif
+	idctPutScaledScalar(dest, pitch, block);
+}
+
+void addBlock(byte *dest, uint32 pitch, const int16 *block) {
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+	if (s_useSIMD) {
+		addBlockSIMD(dest, pitch, block);
+		return;
+	}
+#endif
+	addBlockScalar(dest, pitch, block);
+}
+
+bool hasSIMD() {
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+	return true;
+#else
+	return false;
+#endif
+}
+
+void setUseSIMD(bool useSIMD) {
+#if defined(USE_SSE2_BINK) || defined(USE_NEON_BINK)
+	s_useSIMD = useSIMD;
+#endif
+}
+
+} // End of namespace BinkDSP
+
+} // End of namespace Video
@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef VIDEO_BINK_DSP_H
+#define VIDEO_BINK_DSP_H
+
+#include "common/scummsys.h"
+
+namespace Video {
+
+/**
+ * The 8x8 block kernels of the Bink video decoder.
+ *
+ * On SSE2 and NEON capable targets, vector versions of the kernels are
+ * used. They produce exactly the same output as the scalar versions.
+ */
+namespace BinkDSP {
+
+/** Apply the inverse DCT to a block of coefficients, in place. */
+void idct(int16 *block);
+
+/**
+ * Apply the inverse DCT to a block of coefficients and store the result
+ * in an 8x8 pixel area. The block is clobbered.
+ */
+void idctPut(byte *dest, uint32 pitch, int16 *block);
+
+/**
+ * Apply the inverse DCT to a block of coefficients and add the result to
+ * an 8x8 pixel area. The block is clobbered.
+ */
+void idctAdd(byte *dest, uint32 pitch, int16 *block);
+
+/**
+ * Apply the inverse DCT to a block of coefficients and store the result
+ * scaled up to a 16x16 pixel area. The block is clobbered.
+ */
+void idctPutScaled(byte *dest, uint32 pitch, int16 *block);
+
+/** Add a block of residues to an 8x8 pixel area. */
+void addBlock(byte *dest, uint32 pitch, const int16 *block);
+
+/** Whether vector versions of the kernels are available. */
+bool hasSIMD();
+
+/**
+ * Enable or disable the vector versions of the kernels, if available.
+ * They are enabled by default.
+ */
+void setUseSIMD(bool useSIMD);
+
+} // End of namespace BinkDSP
+
+} // End of namespace Video
+
+#endif
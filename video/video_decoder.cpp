@@ -30,6 +30,7 @@
 #include "common/system.h"
 
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
@@ -48,6 +49,10 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_displayedFrame = 0;
+	_maxAheadFrames = 0;
+	_displayedFrames = 0;
+	_lateFrames = 0;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -60,6 +65,8 @@ void VideoDecoder::close() {
 	if (isPlaying())
 		stop();
 
+	clearDecodeAhead();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -175,6 +182,53 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	const Graphics::Surface *frame;
+	const byte *palette = 0;
+
+	if (!_aheadFrames.empty()) {
+		// Hand out the oldest frame decoded ahead. It is kept until the
+		// next call, like the surfaces owned by the tracks.
+		freeDecodedFrame(_displayedFrame);
+		_displayedFrame = _aheadFrames.pop();
+		frame = _displayedFrame->surface;
+
+		// The frame is freed on the next call, so keep its palette in a
+		// buffer which lives as long as the decoder
+		if (_displayedFrame->dirtyPalette) {
+			memcpy(_aheadPalette, _displayedFrame->palette, sizeof(_aheadPalette));
+			palette = _aheadPalette;
+		}
+	} else {
+		frame = decodeFrameIntern(palette);
+	}
+
+	if (palette) {
+		_palette = palette;
+		_dirtyPalette = true;
+	}
+
+	// Check whether the caller was too late for this frame
+	if (frame) {
+		_displayedFrames++;
+
+		if (isPlaying() && !isPaused()) {
+			uint32 nextFrameStartTime;
+			if (!_aheadFrames.empty())
+				nextFrameStartTime = _aheadFrames.front()->startTime;
+			else if (_nextVideoTrack && !_nextVideoTrack->isReversed())
+				nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+			else
+				nextFrameStartTime = 0xFFFFFFFF;
+
+			if (getTime() >= nextFrameStartTime)
+				_lateFrames++;
+		}
+	}
+
+	return frame;
+}
+
+const Graphics::Surface *VideoDecoder::decodeFrameIntern(const byte *&palette) {
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -184,10 +238,8 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 
 	const Graphics::Surface *frame = _nextVideoTrack->decodeNextFrame();
 
-	if (_nextVideoTrack->hasDirtyPalette()) {
-		_palette = _nextVideoTrack->getPalette();
-		_dirtyPalette = true;
-	}
+	if (_nextVideoTrack->hasDirtyPalette())
+		palette = _nextVideoTrack->getPalette();
 
 	// Look for the next video track here for the next decode.
 	findNextVideoTrack();
@@ -195,11 +247,96 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	return frame;
 }
 
+void VideoDecoder::setDecodeAhead(uint frames) {
+	// Frames which were decoded already are still handed out
+	_maxAheadFrames = frames;
+}
+
+bool VideoDecoder::decodeAhead() {
+	if ((uint)_aheadFrames.size() >= _maxAheadFrames || !isPlaying() || isPaused() || _needsUpdate)
+		return false;
+
+	// Only a single video track played forward can be decoded ahead,
+	// since the frames of several tracks would need to be interleaved.
+	if (!_nextVideoTrack || _nextVideoTrack->isReversed() || _nextVideoTrack->endOfTrack())
+		return false;
+
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo && *it != _nextVideoTrack)
+			return false;
+
+	const uint32 startTime = _nextVideoTrack->getNextFrameStartTime();
+	if (_endTimeSet && startTime >= (uint)_endTime.msecs())
+		return false;
+
+	// Leave the frame which is due to decodeNextFrame()
+	if (getTimeToNextFrame() == 0)
+		return false;
+
+	_canSetDither = false;
+
+	DecodedFrame *decoded = new DecodedFrame();
+	decoded->startTime = startTime;
+	decoded->surface = 0;
+	decoded->dirtyPalette = false;
+
+	VideoTrack *track = _nextVideoTrack;
+	const byte *palette = 0;
+	const Graphics::Surface *frame = decodeFrameIntern(palette);
+	decoded->curFrame = track->getCurFrame();
+
+	if (frame) {
+		decoded->surface = new Graphics::Surface();
+		decoded->surface->copyFrom(*frame);
+	}
+
+	if (palette) {
+		memcpy(decoded->palette, palette, sizeof(decoded->palette));
+		decoded->dirtyPalette = true;
+	}
+
+	_aheadFrames.push(decoded);
+	return true;
+}
+
+bool VideoDecoder::hasFramesAhead() const {
+	if (_aheadFrames.empty())
+		return false;
+
+	return !isPlaying() || !_endTimeSet || _aheadFrames.front()->startTime < (uint)_endTime.msecs();
+}
+
+void VideoDecoder::freeDecodedFrame(DecodedFrame *frame) {
+	if (!frame)
+		return;
+
+	if (frame->surface) {
+		frame->surface->free();
+		delete frame->surface;
+	}
+
+	delete frame;
+}
+
+void VideoDecoder::clearDecodeAhead() {
+	while (!_aheadFrames.empty())
+		freeDecodedFrame(_aheadFrames.pop());
+
+	freeDecodedFrame(_displayedFrame);
+	_displayedFrame = 0;
+	_displayedFrames = 0;
+	_lateFrames = 0;
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
 
+	// Frames decoded ahead would be played in the wrong order
+	if (reverse && !_aheadFrames.empty())
+		return false;
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -220,6 +357,10 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	// The tracks are ahead of what was displayed
+	if (!_aheadFrames.empty())
+		return _aheadFrames.front()->curFrame - 1;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -261,10 +402,20 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	if (endOfVideo() || _needsUpdate)
 		return 0;
 
 	uint32 currentTime = getTime();
+
+	// Frames decoded ahead are always played forward
+	if (!_aheadFrames.empty()) {
+		uint32 nextFrameStartTime = _aheadFrames.front()->startTime;
+		return nextFrameStartTime <= currentTime ? 0 : nextFrameStartTime - currentTime;
+	}
+
+	if (!_nextVideoTrack)
+		return 0;
+
 	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
 
 	if (_nextVideoTrack->isReversed()) {
@@ -283,6 +434,9 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
+	if (hasFramesAhead())
+		return false;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->endOfTrack() && (!isPlaying() || (*it)->getTrackType() != Track::kTrackTypeVideo || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
 			return false;
@@ -309,6 +463,8 @@ bool VideoDecoder::rewind() {
 	if (isPlaying())
 		stopAudio();
 
+	clearDecodeAhead();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if (!(*it)->rewind())
 			return false;
@@ -343,6 +499,8 @@ bool VideoDecoder::seek(const Audio::Timestamp &time) {
 	if (isPlaying())
 		stopAudio();
 
+	clearDecodeAhead();
+
 	// Do the actual seeking
 	if (!seekIntern(time))
 		return false;
@@ -895,6 +1053,9 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
+	if (hasFramesAhead())
+		return true;
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && !(*it)->endOfTrack() && (!isPlaying() || !_endTimeSet || ((VideoTrack *)*it)->getNextFrameStartTime() < (uint)_endTime.msecs()))
 			return true;
@@ -26,6 +26,7 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/queue.h"
 #include "common/rational.h"
 #include "common/str.h"
 #include "graphics/pixelformat.h"
@@ -52,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder() { clearDecodeAhead(); }
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -355,6 +356,42 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Set the number of frames which may be decoded ahead of time by
+	 * decodeAhead(). 0, the default, disables decoding ahead.
+	 *
+	 * Decoding ahead only works for videos with a single video track
+	 * played forward, and for decoders which do all their work in
+	 * decodeNextFrame(). Frames decoded ahead are copied, so they cost
+	 * one surface worth of memory each.
+	 */
+	void setDecodeAhead(uint frames);
+
+	/**
+	 * Decode a frame ahead of time if there is room in the decode ahead
+	 * queue and no frame is due yet.
+	 *
+	 * Callers can invoke this in place of sleeping until needsUpdate()
+	 * returns true. The time spent here is then saved later, which evens
+	 * out frames that are expensive to decode, like key frames.
+	 *
+	 * @return true if a frame was decoded, false otherwise
+	 */
+	bool decodeAhead();
+
+	/**
+	 * Get the number of frames returned by decodeNextFrame() since the
+	 * video was loaded or last seeked.
+	 */
+	uint32 getDisplayedFrameCount() const { return _displayedFrames; }
+
+	/**
+	 * Get the number of frames which decodeNextFrame() returned only after
+	 * the following frame was due already, i.e. the frames which were
+	 * displayed too late to keep up with the video.
+	 */
+	uint32 getLateFrameCount() const { return _lateFrames; }
+
 	/**
 	 * Set the default high color format for videos that convert from YUV.
 	 *
@@ -936,6 +973,26 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Frames decoded ahead of time
+	struct DecodedFrame {
+		Graphics::Surface *surface;
+		uint32 startTime;
+		int curFrame;
+		bool dirtyPalette;
+		byte palette[256 * 3];
+	};
+
+	Common::Queue<DecodedFrame *> _aheadFrames;
+	DecodedFrame *_displayedFrame;
+	byte _aheadPalette[256 * 3];
+	uint _maxAheadFrames;
+	uint32 _displayedFrames, _lateFrames;
+
+	const Graphics::Surface *decodeFrameIntern(const byte *&palette);
+	bool hasFramesAhead() const;
+	void freeDecodedFrame(DecodedFrame *frame);
+	void clearDecodeAhead();
+
 	// Internal helper functions
 	void stopAudio();
 	void startAudio();